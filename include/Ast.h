@@ -53,6 +53,7 @@ public:
     void genCode(){};
     virtual void output(int level) {};
     virtual void typeCheck() {};
+    virtual ConstantSymbolEntry *fold() {return nullptr;};  // the value, if constant
 };
 
 class SingelExpr : public ExprNode
@@ -66,6 +67,7 @@ public:
     void output(int level);
     void typeCheck();
     void genCode();
+    ConstantSymbolEntry *fold();
 };
 
 class BinaryExpr : public ExprNode
@@ -79,6 +81,7 @@ public:
     void output(int level);
     void typeCheck();
     void genCode();
+    ConstantSymbolEntry *fold();
 };
 
 class Constant : public ExprNode
@@ -88,29 +91,21 @@ public:
     void output(int level);
     void typeCheck();
     void genCode();
+    ConstantSymbolEntry *fold() {return (ConstantSymbolEntry*)symbolEntry;};
 };
 
 class Id : public ExprNode
 {
+private:
+    std::vector<int> dims;  // dimensions of an array, -1 first for an array parameter
 public:
     ExprNode* arrIdx;
-    Id(SymbolEntry* se, ExprNode* arrIdx = nullptr) : ExprNode(se), arrIdx(arrIdx) 
-    {
-        Type *type = se->getType();
-            if (type->isArray()) 
-            {
-                SymbolEntry* temp = new TemporarySymbolEntry(new PointerType(((ArrayType*)type)->getElementType()), SymbolTable::getLabel());
-                dst = new Operand(temp);
-            }
-            else
-            {
-                SymbolEntry* temp = new TemporarySymbolEntry(type, SymbolTable::getLabel());
-                dst = new Operand(temp);
-            }
-    };
+    Id(SymbolEntry* se, ExprNode* arrIdx = nullptr);
+    Operand *genAddr(Operand *addr = nullptr);
     void output(int level);
     void typeCheck();
     void genCode();
+    ConstantSymbolEntry *fold();
 };
 
 class IDList
@@ -127,7 +122,8 @@ public:
         std::queue<SymbolEntry*> idl;
         while(!this->idlist.empty()){
     	SymbolEntry* se=this->idlist.front();
-    	se->setType(type);
+        if(!se->getType()->isArray())
+    	    se->setType(type);
         this->idlist.pop();
         idl.push(se);
         }
@@ -298,8 +294,8 @@ public:
 class ReturnStmt : public StmtNode
 {
 private:
-    StmtNode *funcCall;
-    ExprNode *retValue;
+    StmtNode *funcCall = nullptr;
+    ExprNode *retValue = nullptr;  // nullptr for a bare return
 public:
     ReturnStmt(ExprNode*retValue) : retValue(retValue) {};
     ReturnStmt(StmtNode *funcCall) : funcCall(funcCall) {};
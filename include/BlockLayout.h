@@ -0,0 +1,31 @@
+/**
+ * order machine blocks so that branches become fall-throughs
+ */
+
+#ifndef __BLOCK_LAYOUT_H__
+#define __BLOCK_LAYOUT_H__
+
+#include <vector>
+
+class MachineUnit;
+class MachineFunction;
+class MachineBlock;
+class MachineInstruction;
+
+class BlockLayout
+{
+private:
+    MachineUnit *unit;
+    MachineFunction *func;
+    std::vector<MachineBlock *> successors(MachineBlock *block);
+    void addBranches();
+    void chain();
+    void rotateLoops();
+    void removeBranches();
+    void pass(MachineFunction *func);
+public:
+    BlockLayout(MachineUnit *unit) : unit(unit) {};
+    void pass();
+};
+
+#endif
@@ -0,0 +1,31 @@
+/**
+ * aggressive dead code elimination
+ */
+
+#ifndef __DEAD_CODE_ELIMINATION_H__
+#define __DEAD_CODE_ELIMINATION_H__
+
+#include <set>
+#include <vector>
+
+class Unit;
+class Function;
+class Instruction;
+
+class DeadCodeElimination
+{
+private:
+    Unit *unit;
+    std::set<Instruction *> live;
+    std::vector<Instruction *> worklist;
+    bool isCritical(Instruction *inst);
+    void markLive(Instruction *inst);
+    void mark(Function *func);
+    void sweep(Function *func);
+    void pass(Function *func);
+public:
+    DeadCodeElimination(Unit *unit) : unit(unit) {};
+    void pass();
+};
+
+#endif
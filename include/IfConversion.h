@@ -0,0 +1,37 @@
+/**
+ * if-conversion on machine code: short if/else arms become predicated
+ * instructions in the block holding the compare
+ */
+
+#ifndef __IF_CONVERSION_H__
+#define __IF_CONVERSION_H__
+
+#include <map>
+#include <vector>
+#include <cstddef>
+
+class MachineUnit;
+class MachineFunction;
+class MachineBlock;
+class MachineInstruction;
+
+class IfConversion
+{
+private:
+    MachineUnit *unit;
+    MachineFunction *func;
+    static const size_t maxArmSize = 4;        // instructions of an arm, not counting its branch
+    std::map<int, int> refs;                  // number of branches to each block
+    std::map<int, MachineBlock *> useBlock;   // block using a vreg, nullptr if it is used in several
+    void scan();
+    void thread();
+    MachineBlock *join(MachineBlock *arm, MachineBlock *head);
+    bool convert(MachineBlock *head);
+    void merge(MachineBlock *head, std::vector<std::pair<MachineBlock *, int>> arms, MachineBlock *exit);
+    void pass(MachineFunction *func);
+public:
+    IfConversion(MachineUnit *unit) : unit(unit) {};
+    void pass();
+};
+
+#endif
@@ -0,0 +1,45 @@
+/**
+ * inline small functions and functions called only once into their callers
+ */
+
+#ifndef __INLINER_H__
+#define __INLINER_H__
+
+#include <map>
+#include <set>
+#include <vector>
+
+class Unit;
+class Function;
+class BasicBlock;
+class Instruction;
+class CallInstruction;
+class Operand;
+class SymbolEntry;
+
+class Inliner
+{
+private:
+    Unit *unit;
+    std::map<SymbolEntry *, Function *> functions;
+    std::map<Function *, std::vector<CallInstruction *>> calls;  // calls to functions of this unit
+    std::map<Function *, int> callSites;                        // number of calls to a function
+    std::set<Function *> recursive;
+    std::map<Operand *, Operand *> operandMap;
+    std::map<BasicBlock *, BasicBlock *> blockMap;
+    static const int inlineThreshold = 40;      // callee size always worth inlining
+    static const int singleCallThreshold = 400; // callee size inlined at its only call site
+    static const int callerLimit = 600;         // stop growing a caller past this size
+    void buildCallGraph();
+    void findRecursive();
+    int size(Function *func);
+    bool shouldInline(Function *caller, Function *callee);
+    Operand *mapOperand(Operand *op, CallInstruction *call);
+    void cloneInstruction(Instruction *inst, BasicBlock *bb, Function *caller, CallInstruction *call);
+    void inlineCall(Function *caller, CallInstruction *call, Function *callee);
+public:
+    Inliner(Unit *unit) : unit(unit) {};
+    void pass();
+};
+
+#endif
@@ -19,6 +19,24 @@ public:
     bool isCond() const {return instType == COND;};
     bool isRet() const { return instType == RET; };
     bool isAlloc() const {return instType == ALLOCA;};
+    bool isBinary() const {return instType == BINARY;};
+    bool isLoad() const {return instType == LOAD;};
+    bool isStore() const {return instType == STORE;};
+    bool isCmp() const {return instType == CMP;};
+    bool isCall() const {return instType == CALL;};
+    bool isGep() const {return instType == GEP;};
+    bool isVector() const {return instType == VECTOR;};
+    bool isPure() const {return instType == BINARY || instType == CMP || instType == SINGLE || instType == CONV || instType == GEP;};
+    unsigned getOpcode() const {return opcode;};
+    std::vector<Operand*> &getOperands() {return operands;};
+    Operand *getDef();
+    std::vector<Operand*> getUse();
+    void replaceUse(Operand *old, Operand *rep);
+    // bookkeeping of the Use nodes, maintained by Operand.
+    void addUseNode(Use *use) {use_nodes.push_back(use);};
+    void removeUseNode(Use *use);
+    Use *findUseNode(Operand *op);
+    void replaceOperand(Operand *old, Operand *rep);
     void setParent(BasicBlock *);
     void setNext(Instruction *);
     void setPrev(Instruction *);
@@ -26,8 +44,9 @@ public:
     Instruction *getPrev();
     virtual void output() const = 0;
     MachineOperand* genMachineOperand(Operand*);
-    MachineOperand* genMachineReg(int reg);
-    MachineOperand* genMachineVReg();
+    MachineOperand* genMachineReg(int reg, bool fpu = false);
+    MachineOperand* genMachineVReg(bool fpu = false);
+    MachineOperand* genMachineFloat(MachineBlock *cur_block, MachineOperand *src);
     MachineOperand* genMachineImm(int val);
     MachineOperand* genMachineLabel(int block_no);
     virtual void genMachineCode(AsmBuilder*) = 0;
@@ -38,7 +57,8 @@ protected:
     Instruction *next;
     BasicBlock *parent;
     std::vector<Operand*> operands;
-    enum {SINGLE ,BINARY, COND, UNCOND, RET, LOAD, STORE, CMP, ALLOCA , CONV , CALL};
+    std::vector<Use*> use_nodes;
+    enum {SINGLE ,BINARY, COND, UNCOND, RET, LOAD, STORE, CMP, ALLOCA , CONV , CALL, GEP, VECTOR};
 };
 
 // meaningless instruction, used as the head node of the instruction list.
@@ -55,6 +75,7 @@ class AllocaInstruction : public Instruction
 public:
     AllocaInstruction(Operand *dst, SymbolEntry *se, BasicBlock *insert_bb = nullptr);
     ~AllocaInstruction();
+    SymbolEntry *getSymPtr() { return se; };
     void output() const;
     void genMachineCode(AsmBuilder*);
 private:
@@ -79,6 +100,18 @@ public:
     void genMachineCode(AsmBuilder*);
 };
 
+// dst = base + index * 4, the address of an int element of an array
+class GepInstruction : public Instruction
+{
+public:
+    GepInstruction(Operand *dst, Operand *base, Operand *index, BasicBlock *insert_bb = nullptr);
+    ~GepInstruction();
+    void output() const;
+    void genMachineCode(AsmBuilder*);
+    bool isFolded();
+    void genAddress(MachineBlock *cur_block, MachineOperand *&base, MachineOperand *&offset);
+};
+
 class BinaryInstruction : public Instruction
 {
 public:
@@ -87,6 +120,9 @@ public:
     void output() const;
     void genMachineCode(AsmBuilder*);
     enum {SUB, ADD, MUL,DIV,MOD,AND, OR};
+private:
+    void genDivByConst(MachineBlock *cur_block, MachineOperand *dst, MachineOperand *src, int divisor);
+    bool genMulByConst(MachineBlock *cur_block, MachineOperand *dst, MachineOperand *src, int factor);
 };
 
 class CmpInstruction : public Instruction
@@ -96,6 +132,7 @@ public:
     ~CmpInstruction();
     void output() const;
     void genMachineCode(AsmBuilder*);
+    bool isFlagOnly();
     enum {E, NE, L, LE, G, GE};
 };
 
@@ -123,6 +160,7 @@ public:
     BasicBlock* getTrueBranch();
     void setFalseBranch(BasicBlock*);
     BasicBlock* getFalseBranch();
+    CmpInstruction *getFlagsCmp();
     void genMachineCode(AsmBuilder*);
 protected:
     BasicBlock* true_branch;
@@ -152,6 +190,7 @@ class ConverInstruction : public Instruction
 {
 public:
     int mode;
+    enum {ZEXT = 1, ITOF, FTOI};
     ConverInstruction(int mo , Operand *dst, Operand *src, BasicBlock *insert_bb = nullptr);
     ~ConverInstruction();
     void output() const;
@@ -162,6 +201,7 @@ class CallInstruction : public Instruction {
    private:
     SymbolEntry* func;
     Operand* dst;
+    bool tail = false;  // the caller returns right after, reuse its frame
    public:
     CallInstruction(Operand* dst,SymbolEntry* func,std::vector<Operand*> params,BasicBlock* insert_bb = nullptr);
     ~CallInstruction();
@@ -176,6 +216,8 @@ class CallInstruction : public Instruction {
         return vec;
     }
     SymbolEntry* getFuncSyt() { return func; }
+    void setTailCall() { tail = true; }
+    bool isTailCall() const { return tail; }
     void setDef(Operand* def) {
         operands[0] = def;
         dst = def;
@@ -184,4 +226,19 @@ class CallInstruction : public Instruction {
     // used for auto inline
     void addPred();
 };
+
+// NEON operation on four ints. Vector values are not operands, each one
+// lives in a fixed register q8-q15 picked by the vectorizer; src is the
+// address of a load or store, or the scalar a dup broadcasts.
+class VectorInstruction : public Instruction
+{
+public:
+    VectorInstruction(unsigned opcode, int qd, int qa, int qb, Operand *src, BasicBlock *insert_bb = nullptr);
+    ~VectorInstruction();
+    void output() const;
+    void genMachineCode(AsmBuilder*);
+    enum {LOAD, STORE, ADD, SUB, MUL, DUP};
+private:
+    int qd, qa, qb;
+};
 #endif
@@ -0,0 +1,54 @@
+/**
+ * list scheduling of machine code within blocks, for cortex-a72 latencies
+ */
+
+#ifndef __INSTRUCTION_SCHEDULER_H__
+#define __INSTRUCTION_SCHEDULER_H__
+
+#include <cstddef>
+#include <vector>
+
+class MachineUnit;
+class MachineFunction;
+class MachineBlock;
+class MachineInstruction;
+
+class InstructionScheduler
+{
+private:
+    // issue ports, an instruction takes one port of its class for a cycle
+    enum Port { ALU, MUL, LOAD, STORE, FP, NUM_PORTS };
+    static const int ports[NUM_PORTS];  // ports of each class
+    static const int issueWidth = 3;
+    static const size_t maxRegion = 128;  // the reorder window, longer stretches go in pieces
+    // registers the allocator hands out, r4-r10 and s16-s31
+    static const int intRegs = 7;
+    static const int floatRegs = 16;
+    struct Node
+    {
+        MachineInstruction *inst;
+        size_t index;                   // position in the original order
+        int latency;
+        int port;
+        int height = 0;                 // longest latency path to the end of the region
+        int preds = 0;                  // predecessors not scheduled yet
+        int earliest = 0;               // cycle its operands are ready in
+        std::vector<std::pair<Node *, int>> succs;
+    };
+    MachineUnit *unit;
+    MachineFunction *func;
+    static int latency(MachineInstruction *inst);
+    static int port(MachineInstruction *inst);
+    static bool isMemory(MachineInstruction *inst);
+    static bool writesMemory(MachineInstruction *inst);
+    static bool mayAlias(MachineInstruction *a, MachineInstruction *b);
+    bool isBarrier(MachineInstruction *inst);
+    void schedule(std::vector<MachineInstruction *> &insts, size_t begin, size_t end);
+    void pass(MachineBlock *block);
+public:
+    enum { BEFORE_RA = 1, AFTER_RA = 2 };
+    InstructionScheduler(MachineUnit *unit) : unit(unit) {};
+    void pass();
+};
+
+#endif
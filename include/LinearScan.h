@@ -8,9 +8,12 @@
 #include <map>
 #include <vector>
 #include <list>
+#include <cstdint>
 
 class MachineUnit;
 class MachineOperand;
+class MachineInstruction;
+class MachineBlock;
 class MachineFunction;
 
 
@@ -24,27 +27,59 @@ private:
         bool spill; // whether this vreg should be spilled to memory
         int disp;   // displacement in stack
         int rreg;   // the real register mapped from virtual register if the vreg is not spilled to memory
+        bool fpu;   // allocated from s16-s31 instead of r4-r10
         std::set<MachineOperand *> defs;
         std::set<MachineOperand *> uses;
+        double weight;  // spill cost, defs and uses weighted by 10^loop depth, over sqrt of its length
+        std::vector<std::pair<int, int>> segments;  // instructions it is live in, sorted
+    };
+    struct Loop
+    {
+        MachineBlock *preheader;        // nullptr if the loop has none
+        std::set<MachineBlock *> blocks;
+        int pressure[2];                // most int and float intervals live at once
     };
     MachineUnit *unit;
     MachineFunction *func;
     std::vector<int> regs;
-    std::map<MachineOperand *, std::set<MachineOperand *>> du_chains;
+    std::vector<int> fregs;
+    typedef std::vector<uint64_t> BitVector;        // a bit for each vreg of the function
+    std::map<MachineBlock *, BitVector> liveIn, liveOut;
     std::vector<Interval*> intervals;
     std::vector<Interval*> active;
+    static const int reuseDistance = 16;            // longest gap between uses sharing a reload
+    std::vector<Loop> loops;                        // outermost first
+    std::set<MachineInstruction *> loopReloads;     // reloads in a preheader
+    std::set<MachineInstruction *> blockReloads;    // reloads shared by close uses in a block
+    std::set<MachineInstruction *> spillCode;       // stores after a def and reloads right before a use
+    std::set<int> split;                            // vregs spilled before
+    std::map<MachineBlock *, int> depth;            // loops around each block
+    std::map<MachineFunction *, std::pair<int, int>> spills;  // intervals spilled, and those of them in loops
     static bool compareStart(Interval*a, Interval*b);
     static bool compareEnd(Interval* a, Interval* b);
     void expireOldIntervals(Interval *interval);
     void spillAtInterval(Interval *interval);
-    void makeDuChains();
+    void computeLiveness(std::map<MachineOperand, int> &index);
     void computeLiveIntervals();
     bool linearScanRegisterAllocation();
     void modifyCode();
+    static bool isRematerializable(MachineInstruction *inst);
+    static MachineInstruction *rematerialize(MachineInstruction *inst, MachineBlock *block, MachineOperand *dst);
     void genSpillCode();
+    void computePressure();
+    std::set<MachineOperand *> reloadPerLoop(Interval *interval);
+    void reloadPerBlock(Interval *interval, const std::set<MachineOperand *> &uses, int disp);
+    static MachineOperand *freshVReg(MachineOperand *vreg);
+    static void rename(MachineOperand *use, MachineOperand *vreg);
+    static MachineInstruction *reload(MachineBlock *block, MachineOperand *vreg, int disp);
+    static void remove(MachineInstruction *inst);
+    void findLoops();
+    bool unspillable(Interval *interval);
+    void countSpill(Interval *interval);
 public:
     LinearScan(MachineUnit *unit);
     void allocateRegisters();
+    void report();
 };
 
 #endif
\ No newline at end of file
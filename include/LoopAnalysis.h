@@ -0,0 +1,71 @@
+/**
+ * dominator tree and natural loop detection over the IR control flow graph
+ */
+
+#ifndef __LOOP_ANALYSIS_H__
+#define __LOOP_ANALYSIS_H__
+
+#include <set>
+#include <map>
+#include <vector>
+
+class Function;
+class BasicBlock;
+class Instruction;
+class Operand;
+class ConstantSymbolEntry;
+
+struct Loop
+{
+    BasicBlock *header;
+    std::set<BasicBlock *> blocks;      // blocks of the loop body, header included
+    std::vector<BasicBlock *> latches;  // blocks with a back edge to the header
+    Loop *parent = nullptr;             // the innermost enclosing loop
+    int depth = 1;
+    bool contains(BasicBlock *bb) const { return blocks.count(bb) != 0; };
+};
+
+// A loop counting iv up by a constant step:
+//   header: %i = load iv; %c = icmp slt|sle %i, bound; br %c, body, exit
+//   body:   ... %j = load iv; %n = add %j, step; store %n, iv; br header
+// where the body is a single block and bound is invariant in the loop.
+struct CountedLoop
+{
+    BasicBlock *header, *body, *exit;
+    Operand *iv;            // address of the induction variable
+    Operand *bound;         // iv < bound, or iv <= bound
+    unsigned cond;
+    int step;
+    Instruction *update;    // the store of iv + step, last in the body
+};
+
+// an int constant, and the constant an operand is if any
+Operand *newConstant(int value);
+ConstantSymbolEntry *constant(Operand *op);
+
+class LoopAnalysis
+{
+private:
+    Function *func;
+    std::vector<BasicBlock *> rpo;              // reachable blocks in reverse post order
+    std::map<BasicBlock *, int> order;          // position of a block in rpo
+    std::map<BasicBlock *, BasicBlock *> idom;  // immediate dominator
+    std::vector<Loop *> loops;
+    void computeRPO();
+    void computeDominators();
+    void findLoops();
+    BasicBlock *intersect(BasicBlock *, BasicBlock *);
+public:
+    ~LoopAnalysis();
+    void pass(Function *func);
+    bool dominates(BasicBlock *a, BasicBlock *b);
+    bool isReachable(BasicBlock *bb) { return order.count(bb) != 0; };
+    std::vector<BasicBlock *> &getRPO() { return rpo; };
+    // loops sorted innermost first
+    std::vector<Loop *> &getLoops() { return loops; };
+    Loop *getLoopFor(BasicBlock *bb);
+    BasicBlock *getPreheader(Loop *loop);
+    bool getCounted(Loop *loop, CountedLoop &counted);
+};
+
+#endif
@@ -0,0 +1,34 @@
+/**
+ * loop invariant code motion
+ */
+
+#ifndef __LOOP_INVARIANT_CODE_MOTION_H__
+#define __LOOP_INVARIANT_CODE_MOTION_H__
+
+#include <set>
+#include "LoopAnalysis.h"
+
+class Unit;
+class Function;
+class Instruction;
+class SymbolEntry;
+
+class LoopInvariantCodeMotion
+{
+private:
+    Unit *unit;
+    LoopAnalysis analysis;
+    std::set<SymbolEntry *> stored;    // addresses written inside the current loop
+    bool hasCall;                      // the current loop calls a function
+    std::vector<BasicBlock *> exiting; // loop blocks branching out of the current loop
+    bool isInvariant(Loop *loop, Instruction *inst);
+    bool isSafeToHoist(Instruction *inst);
+    void collectMemoryEffects(Loop *loop);
+    void hoist(Loop *loop);
+    void pass(Function *func);
+public:
+    LoopInvariantCodeMotion(Unit *unit) : unit(unit) {};
+    void pass();
+};
+
+#endif
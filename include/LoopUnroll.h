@@ -0,0 +1,47 @@
+/**
+ * unrolling of innermost counted loops
+ */
+
+#ifndef __LOOP_UNROLL_H__
+#define __LOOP_UNROLL_H__
+
+#include <map>
+#include "LoopAnalysis.h"
+
+class Unit;
+class Function;
+class BasicBlock;
+class Instruction;
+class Operand;
+
+class LoopUnroll
+{
+private:
+    Unit *unit;
+    Function *func;
+    LoopAnalysis analysis;
+    Loop *loop;
+    BasicBlock *header, *body, *exit;
+    Operand *iv;                            // address of the induction variable
+    Operand *bound;                         // iv < bound, or iv <= bound
+    unsigned cond;
+    int step;                               // constant added to iv at the end of the body
+    int start;                              // initial value of iv, when tripCount knows it
+    int size;                               // instructions in the body
+    int factor;                             // copies of the body per unrolled iteration
+    std::map<Operand *, Operand *> operandMap;
+    static const int bodyLimit = 32;        // largest body unrolled by factor
+    static const int fullLimit = 128;       // largest loop unrolled completely
+    bool analyze();
+    int tripCount();
+    void cloneBody(BasicBlock *bb, Operand *i, int offset, bool last);
+    void merge(BasicBlock *bb, BasicBlock *next);
+    void unrollFully(int trip);
+    void unroll();
+    void pass(Function *func);
+public:
+    LoopUnroll(Unit *unit, int factor = 4) : unit(unit), factor(factor) {};
+    void pass();
+};
+
+#endif
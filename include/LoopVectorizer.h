@@ -0,0 +1,64 @@
+/**
+ * vectorization of innermost counted loops over int arrays with NEON
+ */
+
+#ifndef __LOOP_VECTORIZER_H__
+#define __LOOP_VECTORIZER_H__
+
+#include <map>
+#include <vector>
+#include "LoopAnalysis.h"
+
+class Unit;
+class Function;
+class BasicBlock;
+class Instruction;
+class Operand;
+
+class LoopVectorizer
+{
+private:
+    // an element a[iv + offset] loaded or stored by the loop body
+    struct Access
+    {
+        Operand *base;
+        Operand *offset;    // loop invariant, nullptr for a[iv]
+        bool store;
+    };
+    Unit *unit;
+    Function *func;
+    LoopAnalysis analysis;
+    Loop *loop;
+    BasicBlock *header, *body;
+    Operand *iv;                            // address of the induction variable
+    Operand *bound;                         // iv < bound, or iv <= bound
+    unsigned cond;
+    Instruction *update;                    // iv + 1 stored back at the end of the body
+    Operand *limit;                         // bound - 3, for the trip tests
+    std::map<Operand *, Operand *> index;   // iv or iv + offset, to its offset
+    std::map<Operand *, Access> addrs;      // element addresses
+    std::vector<Access> accesses;           // distinct elements, in body order
+    std::map<Operand *, int> qregs;         // vector values and broadcast invariants
+    int nqregs;                             // q registers taken from q8 on
+    std::vector<Operand *> dups;            // invariants broadcast before the loop
+    std::vector<std::pair<Access, Access>> checks;  // pairs that may overlap
+    bool isInvariant(Operand *op);
+    int vectorOperand(Operand *op);
+    bool analyzeHeader();
+    bool analyzeBody();
+    bool analyzeAliasing();
+    void addAccess(Operand *addr, bool store);
+    BasicBlock *newBlock();
+    void branch(BasicBlock *from, BasicBlock *to);
+    void condBranch(BasicBlock *from, Operand *cond, BasicBlock *taken, BasicBlock *other);
+    void genTripTest(BasicBlock *bb, BasicBlock *taken);
+    Operand *genAddress(Operand *base, Operand *idx, BasicBlock *bb);
+    BasicBlock *genChecks(BasicBlock *bb);
+    void vectorize();
+    void pass(Function *func);
+public:
+    LoopVectorizer(Unit *unit) : unit(unit) {};
+    void pass();
+};
+
+#endif
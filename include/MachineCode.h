@@ -32,9 +32,13 @@ private:
     int val;  // value of immediate number
     int reg_no; // register no
     std::string label; // address label
+    int shift = NOSHIFT; // register shifted by an immediate, as flexible second operand
+    int shift_amount = 0;
+    bool fpu; // VFP register, s<reg_no> once allocated
 public:
     enum { IMM, VREG, REG, LABEL };
-    MachineOperand(int tp, int val);
+    enum shiftType { NOSHIFT, LSL, LSR, ASR };
+    MachineOperand(int tp, int val, bool fpu = false);
     MachineOperand(std::string label);
     bool operator == (const MachineOperand&) const;
     bool operator < (const MachineOperand&) const;
@@ -42,9 +46,14 @@ public:
     bool isReg() { return this->type == REG; };
     bool isVReg() { return this->type == VREG; };
     bool isLabel() { return this->type == LABEL; };
+    bool isFloat() { return this->fpu; };
     int getVal() {return this->val; };
     int getReg() {return this->reg_no; };
     void setReg(int regno) {this->type = REG; this->reg_no = regno;};
+    void setVReg(int regno) {this->type = VREG; this->reg_no = regno;};
+    void setShift(int type, int amount) {this->shift = type; this->shift_amount = amount;};
+    bool isShifted() { return this->shift != NOSHIFT; };
+    static bool isEncodableImm(int val);
     std::string getLabel() {return this->label; };
     void setParent(MachineInstruction* p) { this->parent = p; };
     MachineInstruction* getParent() { return this->parent;};
@@ -67,32 +76,64 @@ protected:
     void addUse(MachineOperand* ope) { use_list.push_back(ope); };
     // Print execution code after printing opcode
     void PrintCond();
-    enum instType { SINGLE,BINARY, LOAD, STORE, MOV, BRANCH, CMP, STACK ,SAL };
+    // Print mov/mvn or movw/movt loading a constant into dst
+    void PrintImmMove(MachineOperand* dst, int val);
+    // Print vldr/vstr, addressing through ip what the offset field cannot hold
+    void PrintVfpAccess(const char* op, MachineOperand* reg, MachineOperand* base, MachineOperand* offset);
+    // Print the move of an ldr/str offset out of range into ip, returning the offset to use
+    MachineOperand* PrintFarOffset(MachineOperand* offset);
+    enum instType { SINGLE,BINARY, LOAD, STORE, MOV, BRANCH, CMP, STACK ,SAL, MLA, VUNARY, VECTOR };
 public:
     enum condType { EQ, NE, LT, LE ,GT, GE, NONE };
     virtual void output() = 0;
     void setNo(int no) {this->no = no;};
     int getNo() {return no;};
     MachineBlock* getParent() {return parent;}
+    void setParent(MachineBlock* p) {this->parent = p;};
     std::vector<MachineOperand*>& getDef() {return def_list;};
     std::vector<MachineOperand*>& getUse() {return use_list;};
     void insertBefore(MachineInstruction*);
     void insertAfter(MachineInstruction*);
     bool isBX() const { return type == BRANCH && op == 2; };
+    bool isCall() const { return type == BRANCH && op == 1; };
+    bool isTailCall() const;
     bool isStore() const { return type == STORE; };
+    bool isLoad() const { return type == LOAD; };
+    bool isMov() const { return type == MOV; };
     bool isAdd() const { return type == BINARY && op == 0; };
+    bool isBinary() const { return type == BINARY; };
+    bool isBranch() const { return type == BRANCH; };
+    bool isCmp() const { return type == CMP; };
+    bool isStack() const { return type == STACK; };
+    bool isVector() const { return type == VECTOR; };
+    int getOp() const { return op; };
+    int getCond() const { return cond; };
+    void setCond(int cond) { this->cond = cond; };
+    // the condition holding exactly when cond does not
+    static int invertCond(int cond) { return cond <= NE ? cond ^ 1 : LT + GE - cond; };
 };
 
 class BinaryMInstruction : public MachineInstruction
 {
 public:
-    enum opType { ADD, SUB, MUL, DIV, AND, OR };
+    enum opType { ADD, SUB, MUL, DIV, AND, OR, LSL, LSR, ASR, SMMUL, RSB, VADD, VSUB, VMUL, VDIV };
     BinaryMInstruction(MachineBlock* p, int op, 
                     MachineOperand* dst, MachineOperand* src1, MachineOperand* src2, 
                     int cond = MachineInstruction::NONE);
     void output();
 };
 
+// mla dst, src1, src2, acc: dst = acc + src1 * src2; mls: dst = acc - src1 * src2
+class MlaMInstruction : public MachineInstruction
+{
+public:
+    enum opType { MLA, MLS };
+    MlaMInstruction(MachineBlock* p, int op,
+                    MachineOperand* dst, MachineOperand* src1, MachineOperand* src2, MachineOperand* acc,
+                    int cond = MachineInstruction::NONE);
+    void output();
+};
+
 class SingleMInstruction : public MachineInstruction
 {
 public:
@@ -103,6 +144,29 @@ public:
     void output();
 };
 
+// single precision negate and conversions between s32 and f32, all within VFP registers
+class VUnaryMInstruction : public MachineInstruction
+{
+public:
+    enum opType { VNEG, S2F, F2S };
+    VUnaryMInstruction(MachineBlock* p, int op,
+                    MachineOperand* dst, MachineOperand* src,
+                    int cond = MachineInstruction::NONE);
+    void output();
+};
+
+// NEON on q registers the allocator never sees, see VectorInstruction;
+// the only operand is the address register or the scalar to duplicate.
+class VectorMInstruction : public MachineInstruction
+{
+private:
+    int qd, qa, qb;
+public:
+    enum opType { VLD1, VST1, VADD, VSUB, VMUL, VDUP };
+    VectorMInstruction(MachineBlock* p, int op, int qd, int qa, int qb, MachineOperand* src);
+    void output();
+};
+
 class LoadMInstruction : public MachineInstruction
 {
 public:
@@ -141,14 +205,6 @@ public:
     void output();
 };
 
-class SalMInstruction : public MachineInstruction
-{
-public:
-    SalMInstruction(MachineBlock* p, 
-                MachineOperand* dst, MachineOperand* src);
-    void output();
-};
-
 class CmpMInstruction : public MachineInstruction
 {
 public:
@@ -162,7 +218,7 @@ public:
 class StackMInstrcuton : public MachineInstruction
 {
 public:
-    enum opType { PUSH, POP };
+    enum opType { PUSH, POP, VPUSH, VPOP };
     StackMInstrcuton(MachineBlock* p, int op, std::vector<MachineOperand*> srcs, MachineOperand* src, MachineOperand* src1 = nullptr, int cond = MachineInstruction::NONE);
     void output();
 };
@@ -186,6 +242,7 @@ public:
     std::vector<MachineInstruction*>::reverse_iterator rbegin() { return inst_list.rbegin(); };
     std::vector<MachineInstruction*>::reverse_iterator rend() { return inst_list.rend(); };
     MachineBlock(MachineFunction* p, int no) { this->parent = p; this->no = no; };
+    int getNo() const { return no; };
     void InsertInst(MachineInstruction* inst) { this->inst_list.push_back(inst); };
     void addPred(MachineBlock* p) { this->pred.push_back(p); };
     void addSucc(MachineBlock* s) { this->succ.push_back(s); };
@@ -204,24 +261,39 @@ private:
     MachineUnit* parent;
     std::vector<MachineBlock*> block_list;
     int stack_size;
+    std::vector<std::pair<int, int>> slots;
     std::set<int> saved_regs;
+    std::set<int> saved_fregs;
     SymbolEntry* sym_ptr;
     int paramsNum;
+    bool leaf;           // calls nothing, lr stays in place
+    bool frame_pointer;  // fp is set up and addresses the frame
+    void layoutFrame();
 public:
     std::vector<MachineBlock*>& getBlocks() {return block_list;};
     std::vector<MachineBlock*>::iterator begin() { return block_list.begin(); };
     std::vector<MachineBlock*>::iterator end() { return block_list.end(); };
     MachineFunction(MachineUnit* p, SymbolEntry* sym_ptr);
     std::vector<MachineOperand*> getSavedRegs();
+    std::vector<MachineOperand*> getSavedFRegs();
+    std::vector<MachineOperand*> getFrameRegs(bool ret = false);
+    bool isLeaf() const { return leaf; };
+    bool hasFramePointer() const { return frame_pointer; };
     int getParaNum(){return paramsNum;};
+    SymbolEntry* getSymPtr() { return sym_ptr; };
     /* HINT:
     * Alloc stack space for local variable;
     * return current frame offset ;
     * we store offset in symbol entry of this variable in function AllocInstruction::genMachineCode()
     * you can use this function in LinearScan::genSpillCode() */
-    int AllocSpace(int size) { this->stack_size += size; return this->stack_size; };
+    int AllocSpace(int size) { this->stack_size += size; if (size > 0) slots.push_back({stack_size, size}); return this->stack_size; };
+    // the frame regions handed out so far, as (distance below fp, size)
+    std::vector<std::pair<int, int>>& getSlots() { return slots; };
+    void setStackSize(int size) { this->stack_size = size; };
     void InsertBlock(MachineBlock* block) { this->block_list.push_back(block); };
+    MachineBlock* target(MachineInstruction* inst);
     void addSavedRegs(int regno) {saved_regs.insert(regno);};
+    void addSavedFRegs(int regno) {saved_fregs.insert(regno);};
     void output();
 };
 
@@ -240,7 +312,6 @@ public:
     void InsertFunc(MachineFunction* func) { func_list.push_back(func);};
     void output();
     void insertGlobal(SymbolEntry*, ExprNode*);
-    void printGlobal();
     int getGnumber() const { return gnumber; };
 };
 
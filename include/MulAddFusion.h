@@ -0,0 +1,30 @@
+/**
+ * fuse mul with a following add/sub into mla/mls on machine code
+ */
+
+#ifndef __MUL_ADD_FUSION_H__
+#define __MUL_ADD_FUSION_H__
+
+#include <map>
+#include <cstddef>
+
+class MachineUnit;
+class MachineFunction;
+class MachineBlock;
+class MachineInstruction;
+
+class MulAddFusion
+{
+private:
+    MachineUnit *unit;
+    std::map<int, int> defs;  // number of definitions of each vreg
+    std::map<int, int> uses;  // number of uses of each vreg
+    void countOperands(MachineFunction *func);
+    bool fuse(MachineBlock *block, size_t i);
+    void pass(MachineFunction *func);
+public:
+    MulAddFusion(MachineUnit *unit) : unit(unit) {};
+    void pass();
+};
+
+#endif
@@ -7,32 +7,72 @@
 
 class Instruction;
 class Function;
+class Operand;
 
+// class Use - One use of an operand by an instruction.
+// Uses of the same operand form an intrusive doubly linked list, so that
+// unlinking a use or moving it to another operand costs O(1).
+class Use
+{
+private:
+    Instruction *user;
+    Operand *value;
+    Use *prev;
+    Use *next;
+    friend class Operand;
+public:
+    Use(Instruction *user, Operand *value) : user(user), value(value), prev(nullptr), next(nullptr) {};
+    Instruction *getUser() { return user; };
+    Operand *getValue() { return value; };
+    Use *getNext() { return next; };
+};
 
 // class Operand - The operand of an instruction.
 class Operand
 {
-typedef std::vector<Instruction *>::iterator use_iterator;
+public:
+    // iterates over the instructions using this operand.
+    class use_iterator
+    {
+    private:
+        Use *cur;
+    public:
+        use_iterator(Use *cur) : cur(cur) {};
+        Instruction *operator*() const { return cur->getUser(); };
+        use_iterator &operator++() { cur = cur->getNext(); return *this; };
+        use_iterator operator++(int) { use_iterator it = *this; cur = cur->getNext(); return it; };
+        bool operator==(const use_iterator &other) const { return cur == other.cur; };
+        bool operator!=(const use_iterator &other) const { return cur != other.cur; };
+    };
 
 private:
     Instruction *def;                // The instruction where this operand is defined.
-    std::vector<Instruction *> uses; // Intructions that use this operand.
+    Use *uses;                       // Head of the list of uses of this operand.
+    int num_uses;
     SymbolEntry *se;                 // The symbol entry of this operand.
+    void link(Use *use);
+    void unlink(Use *use);
 public:
-    Operand(SymbolEntry*se) :se(se){def = nullptr;};
+    Operand(SymbolEntry*se) :se(se){def = nullptr; uses = nullptr; num_uses = 0;};
+    Operand(const Operand &) = delete;
+    Operand &operator=(const Operand &) = delete;
     void setDef(Instruction *inst) {def = inst;};
-    void addUse(Instruction *inst) { uses.push_back(inst);};
+    void addUse(Instruction *inst);
     void removeUse(Instruction *inst);
-    int usersNum() const {return uses.size();};
+    void removeUse(Use *use);
+    void replaceAllUsesWith(Operand *rep);
+    int usersNum() const {return num_uses;};
 
-    use_iterator use_begin() {return uses.begin();};
-    use_iterator use_end() {return uses.end();};
+    use_iterator use_begin() {return use_iterator(uses);};
+    use_iterator use_end() {return use_iterator(nullptr);};
     Type* getType() {return se->getType();};
     void setType(){se->setType(TypeSystem::boolType);};
     void setintType(){se->setType(TypeSystem::intType);};
+    void setfloatType(){se->setType(TypeSystem::floatType);};
+    bool isFloat();
     std::string toStr() const;
     SymbolEntry * getEntry() { return se; };
     Instruction* getDef() { return def; };
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,42 @@
+/**
+ * peephole rewrites on allocated machine code, driven by a table of rules
+ */
+
+#ifndef __PEEPHOLE_H__
+#define __PEEPHOLE_H__
+
+#include <cstddef>
+#include <vector>
+
+class MachineUnit;
+class MachineBlock;
+class MachineInstruction;
+class MachineOperand;
+
+class Peephole
+{
+private:
+    typedef bool (Peephole::*Rewrite)(MachineBlock *block, size_t i);
+    struct Rule
+    {
+        const char *name;
+        Rewrite rewrite;
+    };
+    static const Rule rules[];
+    static const size_t numRules;
+    MachineUnit *unit;
+    std::vector<int> counts;  // rewrites done by each rule
+    bool forwardStore(MachineBlock *block, size_t i);
+    bool removeMove(MachineBlock *block, size_t i);
+    bool removeZeroImm(MachineBlock *block, size_t i);
+    bool removeCmp(MachineBlock *block, size_t i);
+    static bool sameAddress(MachineInstruction *store, MachineInstruction *load);
+    static bool writes(MachineInstruction *inst, MachineOperand *reg);
+    void pass(MachineBlock *block);
+public:
+    Peephole(MachineUnit *unit) : unit(unit), counts(numRules) {};
+    void pass();
+    void report();
+};
+
+#endif
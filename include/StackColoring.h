@@ -0,0 +1,35 @@
+/**
+ * share frame slots of locals and spills whose lifetimes do not overlap
+ */
+
+#ifndef __STACK_COLORING_H__
+#define __STACK_COLORING_H__
+
+#include <map>
+#include <set>
+
+class MachineUnit;
+class MachineFunction;
+class MachineBlock;
+class MachineInstruction;
+
+class StackColoring
+{
+private:
+    MachineUnit *unit;
+    MachineFunction *func;
+    std::set<int> words;                        // 4-byte slots, by offset from fp
+    std::map<MachineBlock *, std::set<int>> liveIn, liveOut;
+    std::map<int, std::set<int>> interference;
+    static bool frameAccess(MachineInstruction *inst, int &offset);
+    bool collectSlots();
+    void computeLiveness();
+    void buildInterference();
+    void assignSlots();
+    void pass(MachineFunction *func);
+public:
+    StackColoring(MachineUnit *unit) : unit(unit) {};
+    void pass();
+};
+
+#endif
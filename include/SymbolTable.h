@@ -38,12 +38,14 @@ public:
 class ConstantSymbolEntry : public SymbolEntry
 {
 private:
-    int value;
+    int value;  // the bit pattern for a float constant
 
 public:
     ConstantSymbolEntry(Type *type, int value);
+    ConstantSymbolEntry(Type *type, float value);
     virtual ~ConstantSymbolEntry() {};
     int getValue() const {return value;};
+    float getFloatValue() const;
     std::string toStr();
     // You can add any function you need here.
 };
@@ -78,9 +80,11 @@ private:
     std::string name;
     int scope;
     int paramNo;
+    int argNo;  // index among the parameters passed in the same register class
     bool isArr;
     int arrLen;
     Operand *addr;  // The address of the identifier.
+    ConstantSymbolEntry *value;  // the folded initializer of a constant
     // You can add any field you need here.
 
 public:
@@ -98,8 +102,12 @@ public:
     Operand* getAddr() {return addr;};
     void changeScope(){scope = PARAM;};
     void setParamNo(int a) {paramNo=a;};
+    int getArgNo() const { return argNo; };
+    void setArgNo(int a) {argNo=a;};
     void setArr() {isArr=true;};
     bool getIsArr() {return isArr;};
+    void setValue(ConstantSymbolEntry *value) {this->value = value;};
+    ConstantSymbolEntry *getValue() {return value;};
     // You can add any function you need here.
 };
 
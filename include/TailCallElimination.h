@@ -0,0 +1,36 @@
+/**
+ * turn self tail calls into loops and mark the other tail calls as sibling calls
+ */
+
+#ifndef __TAIL_CALL_ELIMINATION_H__
+#define __TAIL_CALL_ELIMINATION_H__
+
+#include <map>
+#include <vector>
+
+class Unit;
+class Function;
+class BasicBlock;
+class CallInstruction;
+class Operand;
+
+class TailCallElimination
+{
+private:
+    Unit *unit;
+    Function *func;
+    BasicBlock *header;                // loop header that tail recursive calls jump back to
+    std::map<int, Operand *> paramAddr; // parameter number -> its alloca
+    bool localArrays;                  // whether the function allocates arrays in its frame
+    bool isTailCall(CallInstruction *call);
+    bool isSiblingCall(CallInstruction *call);
+    bool reusesFrame(CallInstruction *call);
+    void createHeader();
+    void eliminate(CallInstruction *call);
+    void pass(Function *func);
+public:
+    TailCallElimination(Unit *unit) : unit(unit) {};
+    void pass();
+};
+
+#endif
@@ -8,7 +8,7 @@ class Type
 private:
     int kind;
 protected:
-    enum {INT, VOID, BOOL , FUNC, CONSTINT, PTR, ARRAY};
+    enum {INT, VOID, BOOL , FUNC, CONSTINT, PTR, ARRAY, FLOAT};
 public:
     Type(int kind) : kind(kind) {};
     virtual ~Type() {};
@@ -19,6 +19,10 @@ public:
     bool isConstInt() const {return kind == CONSTINT;};
     bool isBool() const {return kind == BOOL;};
     bool isArray() const { return kind == ARRAY; };
+    bool isPtr() const { return kind == PTR; };
+    bool isFloat() const { return kind == FLOAT; };
+    // int and float values convert into each other implicitly
+    bool isNumber() const { return kind == INT || kind == CONSTINT || kind == FLOAT; };
 };
 
 class BoolType : public Type
@@ -39,6 +43,15 @@ public:
     std::string toStr();
 };
 
+class FloatType : public Type
+{
+private:
+    int size;
+public:
+    FloatType(int size) : Type(Type::FLOAT), size(size){};
+    std::string toStr();
+};
+
 class VoidType : public Type
 {
 public:
@@ -82,7 +95,7 @@ class ArrayType : public Type {
         elementType(elementType),
         length(length),
         constant(constant) {
-        size = 4 * length;
+        size = length * (elementType->isArray() ? ((ArrayType*)elementType)->getSize() : 4);
     };
     std::string toStr();
     int getLength() const { return length; };
@@ -99,6 +112,7 @@ private:
     Type *valueType;
 public:
     PointerType(Type* valueType) : Type(Type::PTR) {this->valueType = valueType;};
+    Type* getValueType() const {return valueType;};
     std::string toStr();
 };
 
@@ -109,11 +123,13 @@ private:
     static IntType commonBool;
     static VoidType commonVoid;
     static ConstIntType commonConstInt;
+    static FloatType commonFloat;
 public:
     static Type *intType;
     static Type *voidType;
     static Type *boolType;
     static Type *constintType;
+    static Type *floatType;
 };
 
 #endif
@@ -45,7 +45,7 @@
 extern int yydebug;
 #endif
 /* "%code requires" blocks.  */
-#line 20 "src/parser.y"
+#line 68 "src/parser.y"
 
     #include "Ast.h"
     #include "SymbolTable.h"
@@ -66,39 +66,41 @@ extern int yydebug;
     INTEGER = 259,                 /* INTEGER  */
     HEXADECIMAL = 260,             /* HEXADECIMAL  */
     OCTAL = 261,                   /* OCTAL  */
-    IF = 262,                      /* IF  */
-    ELSE = 263,                    /* ELSE  */
-    WHILE = 264,                   /* WHILE  */
-    INT = 265,                     /* INT  */
-    VOID = 266,                    /* VOID  */
-    CONST = 267,                   /* CONST  */
-    LPAREN = 268,                  /* LPAREN  */
-    RPAREN = 269,                  /* RPAREN  */
-    LBRACE = 270,                  /* LBRACE  */
-    RBRACE = 271,                  /* RBRACE  */
-    SEMICOLON = 272,               /* SEMICOLON  */
-    COMMA = 273,                   /* COMMA  */
-    LBRACKET = 274,                /* LBRACKET  */
-    RBRACKET = 275,                /* RBRACKET  */
-    ADD = 276,                     /* ADD  */
-    SUB = 277,                     /* SUB  */
-    OR = 278,                      /* OR  */
-    AND = 279,                     /* AND  */
-    LESS = 280,                    /* LESS  */
-    ASSIGN = 281,                  /* ASSIGN  */
-    LESSEQ = 282,                  /* LESSEQ  */
-    MOREEQ = 283,                  /* MOREEQ  */
-    NOTEQUAL = 284,                /* NOTEQUAL  */
-    EQUAL = 285,                   /* EQUAL  */
-    MORE = 286,                    /* MORE  */
-    NOT = 287,                     /* NOT  */
-    DIV = 288,                     /* DIV  */
-    MUL = 289,                     /* MUL  */
-    MOD = 290,                     /* MOD  */
-    RETURN = 291,                  /* RETURN  */
-    BREAK = 292,                   /* BREAK  */
-    CONTINUE = 293,                /* CONTINUE  */
-    THEN = 294                     /* THEN  */
+    FLOATING = 262,                /* FLOATING  */
+    IF = 263,                      /* IF  */
+    ELSE = 264,                    /* ELSE  */
+    WHILE = 265,                   /* WHILE  */
+    INT = 266,                     /* INT  */
+    FLOAT = 267,                   /* FLOAT  */
+    VOID = 268,                    /* VOID  */
+    CONST = 269,                   /* CONST  */
+    LPAREN = 270,                  /* LPAREN  */
+    RPAREN = 271,                  /* RPAREN  */
+    LBRACE = 272,                  /* LBRACE  */
+    RBRACE = 273,                  /* RBRACE  */
+    SEMICOLON = 274,               /* SEMICOLON  */
+    COMMA = 275,                   /* COMMA  */
+    LBRACKET = 276,                /* LBRACKET  */
+    RBRACKET = 277,                /* RBRACKET  */
+    ADD = 278,                     /* ADD  */
+    SUB = 279,                     /* SUB  */
+    OR = 280,                      /* OR  */
+    AND = 281,                     /* AND  */
+    LESS = 282,                    /* LESS  */
+    ASSIGN = 283,                  /* ASSIGN  */
+    LESSEQ = 284,                  /* LESSEQ  */
+    MOREEQ = 285,                  /* MOREEQ  */
+    NOTEQUAL = 286,                /* NOTEQUAL  */
+    EQUAL = 287,                   /* EQUAL  */
+    MORE = 288,                    /* MORE  */
+    NOT = 289,                     /* NOT  */
+    DIV = 290,                     /* DIV  */
+    MUL = 291,                     /* MUL  */
+    MOD = 292,                     /* MOD  */
+    RETURN = 293,                  /* RETURN  */
+    BREAK = 294,                   /* BREAK  */
+    CONTINUE = 295,                /* CONTINUE  */
+    THEN = 296                     /* THEN  */
   };
   typedef enum yytokentype yytoken_kind_t;
 #endif
@@ -107,9 +109,10 @@ extern int yydebug;
 #if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
 union YYSTYPE
 {
-#line 26 "src/parser.y"
+#line 74 "src/parser.y"
 
     int itype;
+    float ftype;
     char* strtype;
     StmtNode* stmttype;
     ExprNode* exprtype;
@@ -118,8 +121,9 @@ union YYSTYPE
     ParaList* paraList;
     InitIDList *initIdList;
     ParaIDList *paraIdList;
+    SymbolEntry *setype;
 
-#line 123 "include/parser.h"
+#line 127 "include/parser.h"
 
 };
 typedef union YYSTYPE YYSTYPE;
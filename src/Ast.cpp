@@ -56,6 +56,22 @@ std::vector<Instruction*> Node::merge(std::vector<Instruction*> &list1, std::vec
     return res;
 }
 
+// src as a value of the int or float type given, constants are converted
+// right away. Anything else than a change between int and float is left as is.
+static Operand *convert(Operand *src, Type *type, BasicBlock *bb)
+{
+    if (src->isFloat() == type->isFloat())
+        return src;
+    auto c = dynamic_cast<ConstantSymbolEntry*>(src->getEntry());
+    if (c && type->isFloat())
+        return new Operand(new ConstantSymbolEntry(TypeSystem::floatType, (float)c->getValue()));
+    if (c)
+        return new Operand(new ConstantSymbolEntry(TypeSystem::intType, (int)c->getFloatValue()));
+    Operand *dst = new Operand(new TemporarySymbolEntry(type->isFloat() ? TypeSystem::floatType : TypeSystem::intType, SymbolTable::getLabel()));
+    new ConverInstruction(type->isFloat() ? ConverInstruction::ITOF : ConverInstruction::FTOI, dst, src, bb);
+    return dst;
+}
+
 void Ast::genCode(Unit *unit)
 {
     IRBuilder *builder = new IRBuilder(unit);
@@ -85,6 +101,7 @@ void FunctionDef::genCode()
         FunctionType *functype=dynamic_cast<FunctionType *>(se->getType());
         std::vector<Type*> para_type=functype->getParaType();
         int i=0;
+        int ints=0, floats=0;
         while(!expr_list.empty()){
             IdentifierSymbolEntry *se_pa = dynamic_cast<IdentifierSymbolEntry *>(expr_list.front());
             Instruction *alloca;
@@ -94,6 +111,8 @@ void FunctionDef::genCode()
             Type* type;
             se_pa->changeScope();
             se_pa->setParamNo(i);
+            // ints and floats are passed in core and VFP registers, counted apart
+            se_pa->setArgNo(para_type[i]->isFloat() ? floats++ : ints++);
             type = new PointerType(para_type[i]);
             //std::cout<<para_type[i]->toStr<<std::endl;
             addr_se = new TemporarySymbolEntry(type, SymbolTable::getLabel());
@@ -121,10 +140,13 @@ void FunctionDef::genCode()
         Instruction* i = (*block)->begin();
         Instruction* last = (*block)->rbegin();
         while (i != last) {
+            Instruction* next = i->getNext();
+            // only the last branch of a block is reachable, delete the others
+            // so that their conditions lose the use.
             if (i->isCond() || i->isUncond()) {
-                (*block)->remove(i);
+                delete i;
             }
-            i = i->getNext();
+            i = next;
         }
         if (last->isCond()) {
             BasicBlock *truebranch, *falsebranch;
@@ -153,6 +175,11 @@ void FunctionDef::genCode()
                     new RetInstruction(new Operand(new ConstantSymbolEntry(
                                            TypeSystem::intType, 0)),
                                        dst);
+                }  else if (((FunctionType*)(se->getType()))->getRetType() ==
+                           TypeSystem::floatType) {
+                    new RetInstruction(new Operand(new ConstantSymbolEntry(
+                                           TypeSystem::floatType, 0.0f)),
+                                       dst);
                 }  else if (((FunctionType*)(se->getType()))->getRetType() ==
                            TypeSystem::voidType) {
                     new RetInstruction(nullptr, dst);
@@ -243,6 +270,12 @@ void BinaryExpr::genCode()
         Operand *src1 = expr1->getOperand();
         Operand *src2 = expr2->getOperand();
         int opcode=-1;
+        // an int compared with a float is converted to float
+        if(src1->isFloat() || src2->isFloat()){
+            src1 = convert(src1, TypeSystem::floatType, bb);
+            src2 = convert(src2, TypeSystem::floatType, bb);
+        }
+        else{
         if(!(src1->getType()==TypeSystem::intType||src1->getType()==TypeSystem::constintType)){
         //    std::cout<<"1"<<std::endl;
             Operand* temp1 = new Operand(new TemporarySymbolEntry(
@@ -256,6 +289,7 @@ void BinaryExpr::genCode()
             TypeSystem::intType, SymbolTable::getLabel()));
             new ConverInstruction(1,temp2,src2,bb);
             src2=temp2;}
+        }
         switch (op)
         {
         case EQUAL:
@@ -298,6 +332,13 @@ void BinaryExpr::genCode()
         expr2->genCode();
         Operand *src1 = expr1->getOperand();
         Operand *src2 = expr2->getOperand();
+        // the arithmetic is done in float if either side is a float
+        if(src1->isFloat() || src2->isFloat()){
+            src1 = convert(src1, TypeSystem::floatType, bb);
+            src2 = convert(src2, TypeSystem::floatType, bb);
+            dst->setfloatType();
+        }
+        else{
         if(!(src1->getType()==TypeSystem::intType||src1->getType()==TypeSystem::constintType)){
         Operand* temp1 = new Operand(new TemporarySymbolEntry(
             TypeSystem::intType, SymbolTable::getLabel()));
@@ -309,6 +350,7 @@ void BinaryExpr::genCode()
             TypeSystem::intType, SymbolTable::getLabel()));
             new ConverInstruction(1,temp2,src2,bb);
             src2=temp2;}
+        }
         int opcode;
         switch (op)
         {
@@ -348,25 +390,113 @@ void Constant::genCode()
     // we don't need to generate code.
 }
 
+Id::Id(SymbolEntry* se, ExprNode* arrIdx) : ExprNode(se), arrIdx(arrIdx)
+{
+    Type *type = se->getType();
+    if (type->isPtr())
+    {
+        dims.push_back(-1);
+        type = dynamic_cast<PointerType*>(type)->getValueType();
+    }
+    for (; type->isArray(); type = dynamic_cast<ArrayType*>(type)->getElementType())
+        dims.push_back(dynamic_cast<ArrayType*>(type)->getLength());
+    size_t n = 0;
+    for (Node *idx = arrIdx; idx; idx = idx->getNext())
+        n++;
+    // a fully indexed array is an int or float, anything less is the address
+    // of a subarray
+    if (dims.empty())
+        type = se->getType();
+    else if (n < dims.size())
+        type = new PointerType(type);
+    dst = new Operand(new TemporarySymbolEntry(type, SymbolTable::getLabel()));
+}
+
+// index arithmetic, folded right away when it is constant or trivial
+static Operand *genIndexOp(unsigned opcode, Operand *src1, Operand *src2, BasicBlock *bb)
+{
+    auto c1 = dynamic_cast<ConstantSymbolEntry*>(src1->getEntry());
+    auto c2 = dynamic_cast<ConstantSymbolEntry*>(src2->getEntry());
+    if (c1 && c2)
+    {
+        int val = opcode == BinaryInstruction::ADD ? c1->getValue() + c2->getValue() : c1->getValue() * c2->getValue();
+        return new Operand(new ConstantSymbolEntry(TypeSystem::intType, val));
+    }
+    if (c2 && c2->getValue() == (opcode == BinaryInstruction::ADD ? 0 : 1))
+        return src1;
+    Operand *dst = new Operand(new TemporarySymbolEntry(TypeSystem::intType, SymbolTable::getLabel()));
+    new BinaryInstruction(opcode, dst, src1, src2, bb);
+    return dst;
+}
+
+// Address of the element or subarray selected by the subscripts: the
+// subscripts are flattened into one index of int elements.
+Operand *Id::genAddr(Operand *addr)
+{
+    BasicBlock *bb = builder->getInsertBB();
+    IdentifierSymbolEntry *se = dynamic_cast<IdentifierSymbolEntry*>(symbolEntry);
+    Operand *base = se->getAddr();
+    if (dims[0] == -1)
+    {
+        // array parameter, the alloca holds the pointer
+        base = new Operand(new TemporarySymbolEntry(se->getType(), SymbolTable::getLabel()));
+        new LoadInstruction(base, se->getAddr(), bb);
+    }
+    Operand *index = nullptr;
+    size_t k = 0;
+    for (ExprNode *idx = arrIdx; idx; idx = dynamic_cast<ExprNode*>(idx->getNext()), k++)
+    {
+        idx->genCode();
+        bb = builder->getInsertBB();
+        if (index == nullptr)
+            index = idx->getOperand();
+        else
+        {
+            Operand *len = new Operand(new ConstantSymbolEntry(TypeSystem::intType, dims[k]));
+            index = genIndexOp(BinaryInstruction::ADD, genIndexOp(BinaryInstruction::MUL, index, len, bb), idx->getOperand(), bb);
+        }
+    }
+    int stride = 1;
+    for (; k < dims.size(); k++)
+        stride *= dims[k];
+    if (index == nullptr)
+        index = new Operand(new ConstantSymbolEntry(TypeSystem::intType, 0));
+    else if (stride != 1)
+        index = genIndexOp(BinaryInstruction::MUL, index, new Operand(new ConstantSymbolEntry(TypeSystem::intType, stride)), bb);
+    if (addr == nullptr)
+        addr = new Operand(new TemporarySymbolEntry(new PointerType(dst->getType()), SymbolTable::getLabel()));
+    new GepInstruction(addr, base, index, bb);
+    return addr;
+}
+
 void Id::genCode()
 {
     //std::cout<<"1"<<std::endl;
     BasicBlock *bb = builder->getInsertBB();
     Function *func = bb->getParent();
     Operand *addr = dynamic_cast<IdentifierSymbolEntry*>(symbolEntry)->getAddr();
-    new LoadInstruction(dst, addr, bb);
+    if (dims.empty())
+        new LoadInstruction(dst, addr, bb);
+    else if (dst->getType()->isPtr())
+        genAddr(dst);
+    else
+    {
+        addr = genAddr();
+        bb = builder->getInsertBB();
+        new LoadInstruction(dst, addr, bb);
+    }
     BasicBlock *truebb, *falsebb, *tempbb;
     truebb = new BasicBlock(func);
     falsebb = new BasicBlock(func);
     tempbb = new BasicBlock(func);
-    if(dst->getType()==TypeSystem::intType || dst->getType()==TypeSystem::boolType){
+    if(dst->getType()==TypeSystem::intType || dst->getType()==TypeSystem::boolType || dst->isFloat()){
         //std::cout<<"1"<<std::endl;
         Operand* temp1 = new Operand(new TemporarySymbolEntry(
                 TypeSystem::boolType, SymbolTable::getLabel()));
         // std::cout<<temp1->toStr()<<std::endl;
         // std::cout<<dst->toStr()<<std::endl;
             new CmpInstruction(
-                CmpInstruction::G, temp1, dst,
+                CmpInstruction::NE, temp1, dst,
                 new Operand(new ConstantSymbolEntry(TypeSystem::intType, 0)),
                 bb);
         
@@ -493,6 +623,8 @@ void ReturnStmt::genCode()
     if(retValue){
         retValue->genCode();
         src=retValue->getOperand();
+        FunctionType *type = dynamic_cast<FunctionType*>(bb->getParent()->getSymPtr()->getType());
+        src = convert(src, type->getRetType(), bb);
     }
     new RetInstruction(src,bb);
 }
@@ -503,6 +635,12 @@ void AssignStmt::genCode()
     expr->genCode();
     Operand *addr = dynamic_cast<IdentifierSymbolEntry*>(lval->getSymPtr())->getAddr();
     Operand *src = expr->getOperand();
+    if (dynamic_cast<Id*>(lval)->arrIdx)
+    {
+        addr = dynamic_cast<Id*>(lval)->genAddr();
+        bb = builder->getInsertBB();
+    }
+    src = convert(src, lval->getOperand()->getType(), bb);
     /***
      * We haven't implemented array yet, the lval can only be ID. So we just store the result of the `expr` to the addr of the id.
      * If you want to implement array, you have to caculate the address first and then store the result into it.
@@ -537,7 +675,9 @@ public:
     if(op==MIN){
         dst->setintType();
         //std::cout<<"min"<<std::endl;
-        if(!(src->getType()==TypeSystem::intType||src->getType()==TypeSystem::constintType)){
+        if(src->isFloat())
+            dst->setfloatType();
+        else if(!(src->getType()==TypeSystem::intType||src->getType()==TypeSystem::constintType)){
         Operand* temp1 = new Operand(new TemporarySymbolEntry(
             TypeSystem::intType, SymbolTable::getLabel()));
             new ConverInstruction(1,temp1,src,bb);
@@ -552,7 +692,7 @@ public:
         Operand* dst_br = new Operand(new TemporarySymbolEntry(
             TypeSystem::boolType, SymbolTable::getLabel()));
         new CmpInstruction(
-            CmpInstruction::G, dst_br, dst,
+            CmpInstruction::NE, dst_br, dst,
             new Operand(new ConstantSymbolEntry(TypeSystem::intType, 0)),
             bb);
         true_list.push_back(new CondBrInstruction(truebb, tempbb, dst_br, bb));
@@ -561,23 +701,21 @@ public:
     else if(op==NOT){
         Operand* temp = new Operand(new TemporarySymbolEntry(
             TypeSystem::boolType, SymbolTable::getLabel()));
+        // !x is x == 0, a condition branches on that compare directly
         new CmpInstruction(
-            CmpInstruction::G, temp, src,
+            CmpInstruction::E, temp, src,
             new Operand(new ConstantSymbolEntry(TypeSystem::intType, 0)),
             bb);
-        src = temp;
-        opcode = SingleInstruction::NOT;
-        new SingleInstruction(opcode,dst,src,bb);
         Operand* temp1 = new Operand(new TemporarySymbolEntry(
                 TypeSystem::intType, SymbolTable::getLabel()));
         
-        new ConverInstruction(1,temp1,dst,bb);
+        new ConverInstruction(1,temp1,temp,bb);
         dst=temp1;
         BasicBlock *truebb, *falsebb, *tempbb;
         truebb = new BasicBlock(func);
         falsebb = new BasicBlock(func);
         tempbb = new BasicBlock(func);
-        true_list.push_back(new CondBrInstruction(truebb, tempbb, dst, bb));
+        true_list.push_back(new CondBrInstruction(truebb, tempbb, temp, bb));
         false_list.push_back(new UncondBrInstruction(falsebb, tempbb));
     }
     else if(op==POS){
@@ -585,7 +723,7 @@ public:
         Operand* temp1 = new Operand(new TemporarySymbolEntry(
             TypeSystem::boolType, SymbolTable::getLabel()));
          new CmpInstruction(
-            CmpInstruction::G, temp1, src,
+            CmpInstruction::NE, temp1, src,
             new Operand(new ConstantSymbolEntry(TypeSystem::intType, 0)),
             bb);
         
@@ -682,8 +820,8 @@ void InitStmt::genCode()
             alloca = new AllocaInstruction(addr, se);                   // allocate space for local id in function stack.
             entry->insertFront(alloca);                                 // allocate instructions should be inserted into the begin of the entry block.
             se->setAddr(addr);
-            Operand *src_nu = nu->getOperand();
             nu->genCode();              
+            Operand *src_nu = convert(nu->getOperand(), se->getType(), bb);
             new StoreInstruction(addr, src_nu, bb);
             initIDList->poponese();
             initIDList->poponenu();                           // set the addr operand in symbol entry so that we can use it in subsequent code generation.
@@ -704,11 +842,16 @@ void FuncExpr::genCode()
 
     std::queue<ExprNode*> templist=paraidlist->getList();
     std::vector<Operand*> operands;
+    std::vector<Type*> paramsType = dynamic_cast<FunctionType*>(symbolEntry->getType())->getParaType();
     while(!templist.empty()){
         //std::cout<<"1"<<std::endl;
         ExprNode* temp=templist.front();
         temp->genCode();
-        operands.push_back(temp->getOperand());
+        Operand *arg = temp->getOperand();
+        // arguments are passed as the type of the parameter
+        if(operands.size() < paramsType.size())
+            arg = convert(arg, paramsType[operands.size()], builder->getInsertBB());
+        operands.push_back(arg);
         templist.pop();
     }
     //std::cout<<"1"<<std::endl;
@@ -722,12 +865,12 @@ void FuncExpr::genCode()
     falsebb = new BasicBlock(func);
     tempbb = new BasicBlock(func);
     FunctionType* funcType = dynamic_cast<FunctionType*>(dst->getType());
-    if(funcType->getRetType()==TypeSystem::intType || funcType->getRetType()==TypeSystem::boolType){
+    if(funcType->getRetType()==TypeSystem::intType || funcType->getRetType()==TypeSystem::boolType || funcType->getRetType()->isFloat()){
         //std::cout<<"1"<<std::endl;
         Operand* temp1 = new Operand(new TemporarySymbolEntry(
                 TypeSystem::boolType, SymbolTable::getLabel()));
             new CmpInstruction(
-                CmpInstruction::G, temp1, dst,
+                CmpInstruction::NE, temp1, dst,
                 new Operand(new ConstantSymbolEntry(TypeSystem::intType, 0)),
                 bb);
         
@@ -765,8 +908,8 @@ void SeqNode::typeCheck()
 
 void SingelExpr::typeCheck()
 {
-    Type *type = expr1->getSymPtr()->getType();
-    if(!(type->isInt()||type->isConstInt())){
+    Type *type = expr1->getOperand()->getType();
+    if(!type->isNumber()){
         fprintf(yyout, "type %s can not be used in singleExpr in line xx",
             type->toStr().c_str());
     }
@@ -778,8 +921,8 @@ void BinaryExpr::typeCheck()
     // Todo
     expr1->typeCheck();
     expr2->typeCheck();
-    Type *type1 = expr1->getSymPtr()->getType();
-    Type *type2 = expr2->getSymPtr()->getType();
+    Type *type1 = expr1->getOperand()->getType();
+    Type *type2 = expr2->getOperand()->getType();
     if(type1->isFunc() || type2->isFunc()){
         //fprintf(yyout,"111");
         if(((FunctionType*)type1)->getRetType()==TypeSystem::voidType || ((FunctionType*)type2)->getRetType()==TypeSystem::voidType){
@@ -787,26 +930,29 @@ void BinaryExpr::typeCheck()
             type1->toStr().c_str(), type2->toStr().c_str());
         }
         if(type1->isFunc() && type2->isFunc()){
-            if(((FunctionType*)type1)->getRetType()!=((FunctionType*)type2)->getRetType()){
+            Type *ret1 = ((FunctionType*)type1)->getRetType(), *ret2 = ((FunctionType*)type2)->getRetType();
+            if(ret1!=ret2 && !(ret1->isNumber() && ret2->isNumber())){
             fprintf(stderr, "type %s and %s mismatch in line 1x\n",
             type1->toStr().c_str(), type2->toStr().c_str());
             }
         }
         else if(type1->isFunc()){
-            if(((FunctionType*)type1)->getRetType()!=type2){
+            Type *ret1 = ((FunctionType*)type1)->getRetType();
+            if(ret1!=type2 && !(ret1->isNumber() && type2->isNumber())){
             fprintf(stderr, "type %s and %s mismatch in line 2x\n",
             type1->toStr().c_str(), type2->toStr().c_str());
             }
         }
         else if(type2->isFunc()){
         //fprintf(yyout,"222");
-        if(((FunctionType*)type2)->getRetType()!=type1){
+        Type *ret2 = ((FunctionType*)type2)->getRetType();
+        if(ret2!=type1 && !(ret2->isNumber() && type1->isNumber())){
             fprintf(stderr, "type %s and %s mismatch in line 3x\n",
             type1->toStr().c_str(), type2->toStr().c_str());
             }
         }
     }
-    else if(!((type1 == type2)||(type1==TypeSystem::intType && type2==TypeSystem::constintType)||(type2==TypeSystem::intType && type1==TypeSystem::constintType)) ){
+    else if(!((type1 == type2)||(type1->isNumber() && type2->isNumber())) ){
         fprintf(stderr, "type %s and %s mismatch in line xx\n",
         type1->toStr().c_str(), type2->toStr().c_str());
         //exit(EXIT_FAILURE);
@@ -814,6 +960,84 @@ void BinaryExpr::typeCheck()
     symbolEntry->setType(type1);
 }
 
+static float floatOf(ConstantSymbolEntry *c)
+{
+    return c->getType()->isFloat() ? c->getFloatValue() : c->getValue();
+}
+
+// Constant expressions are evaluated in int, or in float as soon as either
+// side is a float, as they would be at run time.
+ConstantSymbolEntry *SingelExpr::fold()
+{
+    ConstantSymbolEntry *c = expr1->fold();
+    if (c == nullptr || op == POS)
+        return c;
+    if (op == NOT)
+        return new ConstantSymbolEntry(TypeSystem::intType, (int)(floatOf(c) == 0));
+    if (c->getType()->isFloat())
+        return new ConstantSymbolEntry(TypeSystem::floatType, -c->getFloatValue());
+    return new ConstantSymbolEntry(TypeSystem::intType, -c->getValue());
+}
+
+ConstantSymbolEntry *BinaryExpr::fold()
+{
+    ConstantSymbolEntry *c1 = expr1->fold(), *c2 = expr2->fold();
+    if (c1 == nullptr || c2 == nullptr)
+        return nullptr;
+    if (c1->getType()->isFloat() || c2->getType()->isFloat())
+    {
+        float a = floatOf(c1), b = floatOf(c2);
+        switch (op)
+        {
+        case ADD: return new ConstantSymbolEntry(TypeSystem::floatType, a + b);
+        case SUB: return new ConstantSymbolEntry(TypeSystem::floatType, a - b);
+        case MUL: return new ConstantSymbolEntry(TypeSystem::floatType, a * b);
+        case DIV: return new ConstantSymbolEntry(TypeSystem::floatType, a / b);
+        case MOD: return nullptr;
+        case AND: return new ConstantSymbolEntry(TypeSystem::intType, (int)(a && b));
+        case OR: return new ConstantSymbolEntry(TypeSystem::intType, (int)(a || b));
+        case LESS: return new ConstantSymbolEntry(TypeSystem::intType, (int)(a < b));
+        case MORE: return new ConstantSymbolEntry(TypeSystem::intType, (int)(a > b));
+        case NOTEQUAL: return new ConstantSymbolEntry(TypeSystem::intType, (int)(a != b));
+        case EQUAL: return new ConstantSymbolEntry(TypeSystem::intType, (int)(a == b));
+        case LESSEQ: return new ConstantSymbolEntry(TypeSystem::intType, (int)(a <= b));
+        case MOREEQ: return new ConstantSymbolEntry(TypeSystem::intType, (int)(a >= b));
+        }
+        return nullptr;
+    }
+    int a = c1->getValue(), b = c2->getValue(), value;
+    switch (op)
+    {
+    case ADD: value = a + b; break;
+    case SUB: value = a - b; break;
+    case MUL: value = a * b; break;
+    case DIV:
+    case MOD:
+        if (b == 0)
+            return nullptr;
+        value = op == DIV ? a / b : a % b;
+        break;
+    case AND: value = a && b; break;
+    case OR: value = a || b; break;
+    case LESS: value = a < b; break;
+    case MORE: value = a > b; break;
+    case NOTEQUAL: value = a != b; break;
+    case EQUAL: value = a == b; break;
+    case LESSEQ: value = a <= b; break;
+    case MOREEQ: value = a >= b; break;
+    default: return nullptr;
+    }
+    return new ConstantSymbolEntry(TypeSystem::intType, value);
+}
+
+// only a constant declared with a constant initializer has a value
+ConstantSymbolEntry *Id::fold()
+{
+    if (arrIdx != nullptr || !symbolEntry->isVariable())
+        return nullptr;
+    return ((IdentifierSymbolEntry*)symbolEntry)->getValue();
+}
+
 void Constant::typeCheck()
 {
     // Todo
@@ -828,7 +1052,7 @@ void IfStmt::typeCheck()
 {
     // Todo
     cond->typeCheck();
-    Type *type = cond->getSymPtr()->getType();
+    Type *type = cond->getOperand()->getType();
     if(type->isFunc()){
         if(!((FunctionType*)type)->getRetType()->isInt()){
             //fprintf(yyout,"type %s is not bool",type->toStr().c_str());
@@ -844,13 +1068,13 @@ void IfElseStmt::typeCheck()
 {
     // Todo
     cond->typeCheck();
-    Type *type = cond->getSymPtr()->getType();
+    Type *type = cond->getOperand()->getType();
     if(type->isFunc()){
-        if(!((FunctionType*)type)->getRetType()->isInt()){
+        if(!((FunctionType*)type)->getRetType()->isInt() && !((FunctionType*)type)->getRetType()->isFloat()){
             fprintf(yyout,"type %s is not bool",type->toStr().c_str());
         }
     }
-    else if(!type->isInt()){
+    else if(!type->isInt() && !type->isFloat()){
         fprintf(yyout,"type %s is not bool",type->toStr().c_str());
     }
     thenStmt->typeCheck();
@@ -872,7 +1096,8 @@ void DeclStmt::typeCheck()
 void ReturnStmt::typeCheck()
 {
     // Todo
-    retValue->typeCheck();
+    if(retValue!=nullptr)
+        retValue->typeCheck();
 }
 
 void AssignStmt::typeCheck()
@@ -0,0 +1,145 @@
+#include "BlockLayout.h"
+#include "MachineCode.h"
+#include <set>
+#include <algorithm>
+
+void BlockLayout::pass()
+{
+    for (auto &func : unit->getFuncs())
+        pass(func);
+}
+
+void BlockLayout::pass(MachineFunction *func)
+{
+    this->func = func;
+    addBranches();
+    chain();
+    rotateLoops();
+    removeBranches();
+}
+
+// the blocks a block branches to at its end, the taken side of b<c> first
+std::vector<MachineBlock *> BlockLayout::successors(MachineBlock *block)
+{
+    std::vector<MachineBlock *> succs;
+    auto &insts = block->getInsts();
+    if (insts.empty() || insts.back()->getCond() != MachineInstruction::NONE)
+        return succs;
+    MachineBlock *dest = func->target(insts.back());
+    if (dest == nullptr)
+        return succs;
+    if (insts.size() >= 2 && insts[insts.size() - 2]->getCond() != MachineInstruction::NONE)
+    {
+        MachineBlock *taken = func->target(insts[insts.size() - 2]);
+        if (taken != nullptr)
+            succs.push_back(taken);
+    }
+    succs.push_back(dest);
+    return succs;
+}
+
+// A block not ending in b or bx, an empty one too, runs on into
+// the block after it. That is made an explicit b before any block moves.
+void BlockLayout::addBranches()
+{
+    auto &list = func->getBlocks();
+    for (size_t i = 0; i + 1 < list.size(); i++)
+    {
+        auto &insts = list[i]->getInsts();
+        MachineInstruction *last = insts.empty() ? nullptr : insts.back();
+        if (last && last->getCond() == MachineInstruction::NONE &&
+            ((last->isBranch() && last->getOp() == BranchMInstruction::B) || last->isBX()))
+            continue;
+        insts.push_back(new BranchMInstruction(list[i], BranchMInstruction::B, new MachineOperand(".L" + std::to_string(list[i + 1]->getNo()))));
+    }
+}
+
+// Starting from the entry, each block is followed by a successor not placed
+// yet, which keeps the bodies of ifs and loops right after their condition.
+void BlockLayout::chain()
+{
+    auto &list = func->getBlocks();
+    std::vector<MachineBlock *> order;
+    std::set<MachineBlock *> placed;
+    size_t next = 0;
+    MachineBlock *cur = list.empty() ? nullptr : list[0];
+    while (order.size() < list.size())
+    {
+        if (cur == nullptr)
+        {
+            while (placed.count(list[next]))
+                next++;
+            cur = list[next];
+        }
+        order.push_back(cur);
+        placed.insert(cur);
+        MachineBlock *succ = nullptr;
+        for (auto &b : successors(cur))
+            if (!placed.count(b))
+            {
+                succ = b;
+                break;
+            }
+        cur = succ;
+    }
+    list = order;
+}
+
+// Loops are tested at the bottom: a header
+//     H: ... b<c> B; b X
+// directly followed by the body B ending in the latch L: b H, is moved after
+// L. The loop is entered with a jump to H, and each iteration then runs the
+// latch into the condition without the b H.
+void BlockLayout::rotateLoops()
+{
+    auto &list = func->getBlocks();
+    std::vector<MachineBlock *> headers(list.begin() + (list.empty() ? 0 : 1), list.end());
+    for (auto &header : headers)
+    {
+        auto succs = successors(header);
+        if (succs.size() != 2)
+            continue;
+        size_t pos = std::find(list.begin(), list.end(), header) - list.begin();
+        if (pos + 1 >= list.size() || list[pos + 1] != succs[0])
+            continue;
+        size_t latch = 0;
+        for (size_t i = pos + 1; i < list.size(); i++)
+        {
+            auto latchSuccs = successors(list[i]);
+            if (latchSuccs.size() == 1 && latchSuccs[0] == header)
+                latch = i;
+        }
+        if (latch == 0)
+            continue;
+        list.erase(list.begin() + pos);
+        list.insert(list.begin() + latch, header);
+    }
+}
+
+// A b to the next block is dropped, and b<c> T; b F with T next becomes
+// b<!c> F.
+void BlockLayout::removeBranches()
+{
+    auto &list = func->getBlocks();
+    for (size_t i = 0; i + 1 < list.size(); i++)
+    {
+        MachineBlock *next = list[i + 1];
+        auto &insts = list[i]->getInsts();
+        auto succs = successors(list[i]);
+        if (succs.empty())
+            continue;
+        if (succs.back() == next)
+        {
+            insts.pop_back();
+            if (succs.size() == 2 && succs[0] == next)
+                insts.pop_back();
+        }
+        else if (succs.size() == 2 && succs[0] == next)
+        {
+            MachineInstruction *br = insts[insts.size() - 2], *jmp = insts.back();
+            jmp->setCond(MachineInstruction::invertCond(br->getCond()));
+            insts.pop_back();
+            insts.back() = jmp;
+        }
+    }
+}
@@ -0,0 +1,100 @@
+#include "DeadCodeElimination.h"
+#include "Unit.h"
+
+void DeadCodeElimination::pass()
+{
+    for (auto func = unit->begin(); func != unit->end(); func++)
+        pass(*func);
+}
+
+void DeadCodeElimination::pass(Function *func)
+{
+    live.clear();
+    mark(func);
+    sweep(func);
+}
+
+// the address of a local scalar that is only ever loaded from and stored to.
+static bool isLocalScalar(Operand *addr)
+{
+    if (addr->getDef() == nullptr || !addr->getDef()->isAlloc())
+        return false;
+    for (auto use = addr->use_begin(); use != addr->use_end(); use++)
+    {
+        Instruction *inst = *use;
+        if (inst->isLoad())
+            continue;
+        if (inst->isStore() && inst->getOperands()[0] == addr && inst->getOperands()[1] != addr)
+            continue;
+        return false;
+    }
+    return true;
+}
+
+// Instructions with an effect visible outside the function or on control flow.
+// A store to a local scalar only matters if some live load reads it.
+bool DeadCodeElimination::isCritical(Instruction *inst)
+{
+    if (inst->isStore())
+        return !isLocalScalar(inst->getOperands()[0]);
+    return inst->isCall() || inst->isRet() || inst->isCond() || inst->isUncond();
+}
+
+void DeadCodeElimination::markLive(Instruction *inst)
+{
+    if (live.insert(inst).second)
+        worklist.push_back(inst);
+}
+
+void DeadCodeElimination::mark(Function *func)
+{
+    for (auto bb = func->begin(); bb != func->end(); bb++)
+        for (auto inst = (*bb)->begin(); inst != (*bb)->end(); inst = inst->getNext())
+            if (isCritical(inst))
+                markLive(inst);
+    while (!worklist.empty())
+    {
+        Instruction *inst = worklist.back();
+        worklist.pop_back();
+        for (auto &use : inst->getUse())
+            if (use->getDef() != nullptr)
+                markLive(use->getDef());
+        if (inst->isLoad() && isLocalScalar(inst->getOperands()[1]))
+        {
+            Operand *addr = inst->getOperands()[1];
+            for (auto use = addr->use_begin(); use != addr->use_end(); use++)
+                if ((*use)->isStore())
+                    markLive(*use);
+        }
+    }
+}
+
+// Delete dead instructions users first, so that an operand is only freed by
+// its defining instruction once nothing refers to it anymore.
+void DeadCodeElimination::sweep(Function *func)
+{
+    std::set<Instruction *> queued;
+    for (auto bb = func->begin(); bb != func->end(); bb++)
+        for (auto inst = (*bb)->begin(); inst != (*bb)->end(); inst = inst->getNext())
+        {
+            Operand *def = inst->getDef();
+            if (!live.count(inst) && (def == nullptr || def->usersNum() == 0))
+            {
+                worklist.push_back(inst);
+                queued.insert(inst);
+            }
+        }
+    while (!worklist.empty())
+    {
+        Instruction *inst = worklist.back();
+        worklist.pop_back();
+        std::vector<Operand *> uses = inst->getUse();
+        delete inst;
+        for (auto &use : uses)
+        {
+            Instruction *def = use->getDef();
+            if (def != nullptr && !live.count(def) && use->usersNum() == 0 && queued.insert(def).second)
+                worklist.push_back(def);
+        }
+    }
+}
@@ -0,0 +1,188 @@
+#include "IfConversion.h"
+#include "MachineCode.h"
+#include <algorithm>
+
+static void unlink(std::vector<MachineBlock *> &blocks, MachineBlock *block)
+{
+    blocks.erase(std::remove(blocks.begin(), blocks.end(), block), blocks.end());
+}
+
+void IfConversion::pass()
+{
+    for (auto &func : unit->getFuncs())
+        pass(func);
+}
+
+void IfConversion::pass(MachineFunction *func)
+{
+    this->func = func;
+    scan();
+    thread();
+    scan();
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (size_t i = 0; i < func->getBlocks().size(); i++)
+            if (convert(func->getBlocks()[i]))
+                changed = true;
+    }
+}
+
+void IfConversion::scan()
+{
+    refs.clear();
+    useBlock.clear();
+    for (auto &block : func->getBlocks())
+        for (auto &inst : block->getInsts())
+        {
+            MachineBlock *succ = func->target(inst);
+            if (succ != nullptr)
+                refs[succ->getNo()]++;
+            for (auto &use : inst->getUse())
+                if (use->isVReg())
+                {
+                    auto it = useBlock.find(use->getReg());
+                    if (it == useBlock.end())
+                        useBlock[use->getReg()] = block;
+                    else if (it->second != block)
+                        it->second = nullptr;
+                }
+        }
+}
+
+// Branches to a block holding nothing but a b go straight to its target, so
+// that the arms of an if/else are seen as successors of the compare. The
+// forwarding blocks left unreferenced are removed.
+void IfConversion::thread()
+{
+    auto forward = [this](MachineBlock *block) {
+        auto &insts = block->getInsts();
+        if (insts.size() != 1 || insts[0]->getCond() != MachineInstruction::NONE)
+            return (MachineBlock *)nullptr;
+        return func->target(insts[0]);
+    };
+    for (auto &block : func->getBlocks())
+        for (auto &inst : block->getInsts())
+        {
+            MachineBlock *succ = func->target(inst), *dest = succ;
+            for (int hops = 0; dest != nullptr && forward(dest) != nullptr && hops < 8; hops++)
+                dest = forward(dest);
+            if (dest == succ || dest == nullptr)
+                continue;
+            inst->getUse()[0] = new MachineOperand(".L" + std::to_string(dest->getNo()));
+            inst->getUse()[0]->setParent(inst);
+            refs[succ->getNo()]--;
+            refs[dest->getNo()]++;
+            unlink(block->getSuccs(), succ);
+            unlink(succ->getPreds(), block);
+            unlink(block->getSuccs(), dest);
+            unlink(dest->getPreds(), block);
+            block->addSucc(dest);
+            dest->addPred(block);
+        }
+    auto &list = func->getBlocks();
+    for (size_t i = 1; i < list.size();)
+    {
+        MachineBlock *block = list[i];
+        if (refs[block->getNo()] > 0 || forward(block) == nullptr)
+        {
+            i++;
+            continue;
+        }
+        for (auto &succ : block->getSuccs())
+            unlink(succ->getPreds(), block);
+        list.erase(list.begin() + i);
+    }
+}
+
+// If the arm can be predicated, the block it falls into, otherwise nullptr.
+// An arm is only reached from the head, ends with a plain b, and holds a few
+// instructions that neither branch, call, nor touch the flags. Its results
+// must be used in the arm alone, as the merged block defines them
+// conditionally.
+MachineBlock *IfConversion::join(MachineBlock *arm, MachineBlock *head)
+{
+    auto &insts = arm->getInsts();
+    if (arm == head || refs[arm->getNo()] != 1 || insts.empty() || insts.size() > maxArmSize + 1)
+        return nullptr;
+    MachineInstruction *last = insts.back();
+    MachineBlock *exit = func->target(last);
+    if (exit == nullptr || exit == arm || last->getCond() != MachineInstruction::NONE)
+        return nullptr;
+    for (size_t i = 0; i + 1 < insts.size(); i++)
+    {
+        MachineInstruction *inst = insts[i];
+        if (inst->getCond() != MachineInstruction::NONE || inst->isBranch() || inst->isCmp() || inst->isStack() || inst->isVector())
+            return nullptr;
+        for (auto &def : inst->getDef())
+        {
+            if (!def->isVReg())
+                return nullptr;
+            auto it = useBlock.find(def->getReg());
+            if (it != useBlock.end() && it->second != arm)
+                return nullptr;
+        }
+    }
+    return exit;
+}
+
+// head: ... b<c> T; b F
+// diamond:  T: ...; b J  F: ...; b J  ->  head: ... (T)<c>, (F)<!c>; b J
+// triangle: T: ...; b F               ->  head: ... (T)<c>; b F
+// and the triangle with the roles of T and F swapped.
+bool IfConversion::convert(MachineBlock *head)
+{
+    auto &insts = head->getInsts();
+    if (insts.size() < 2)
+        return false;
+    MachineInstruction *br = insts[insts.size() - 2], *jmp = insts.back();
+    MachineBlock *t = func->target(br), *f = func->target(jmp);
+    if (t == nullptr || f == nullptr || t == f || br->getCond() == MachineInstruction::NONE || jmp->getCond() != MachineInstruction::NONE)
+        return false;
+    int cond = br->getCond();
+    int inv = MachineInstruction::invertCond(cond);
+    MachineBlock *tExit = join(t, head), *fExit = join(f, head);
+    if (tExit != nullptr && tExit == fExit)
+        merge(head, {{t, cond}, {f, inv}}, tExit);
+    else if (tExit == f)
+        merge(head, {{t, cond}}, f);
+    else if (fExit == t)
+        merge(head, {{f, inv}}, t);
+    else
+        return false;
+    return true;
+}
+
+void IfConversion::merge(MachineBlock *head, std::vector<std::pair<MachineBlock *, int>> arms, MachineBlock *exit)
+{
+    auto &insts = head->getInsts();
+    for (int k = 0; k < 2; k++)
+    {
+        refs[func->target(insts.back())->getNo()]--;
+        insts.pop_back();
+    }
+    for (auto &arm : arms)
+    {
+        auto &body = arm.first->getInsts();
+        for (size_t i = 0; i + 1 < body.size(); i++)
+        {
+            body[i]->setCond(arm.second);
+            body[i]->setParent(head);
+            insts.push_back(body[i]);
+            for (auto &def : body[i]->getDef())
+                useBlock[def->getReg()] = head;
+        }
+        refs[exit->getNo()]--;
+        for (auto &succ : arm.first->getSuccs())
+            unlink(succ->getPreds(), arm.first);
+        unlink(head->getSuccs(), arm.first);
+        unlink(func->getBlocks(), arm.first);
+    }
+    unlink(head->getSuccs(), exit);
+    unlink(exit->getPreds(), head);
+    head->addSucc(exit);
+    exit->addPred(head);
+    refs[exit->getNo()]++;
+    insts.push_back(new BranchMInstruction(head, BranchMInstruction::B, new MachineOperand(".L" + std::to_string(exit->getNo()))));
+}
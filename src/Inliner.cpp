@@ -0,0 +1,252 @@
+#include "Inliner.h"
+#include "Unit.h"
+#include "Type.h"
+
+void Inliner::buildCallGraph()
+{
+    for (auto func = unit->begin(); func != unit->end(); func++)
+        functions[(*func)->getSymPtr()] = *func;
+    for (auto func = unit->begin(); func != unit->end(); func++)
+        for (auto bb = (*func)->begin(); bb != (*func)->end(); bb++)
+            for (auto inst = (*bb)->begin(); inst != (*bb)->end(); inst = inst->getNext())
+            {
+                if (!inst->isCall())
+                    continue;
+                auto call = dynamic_cast<CallInstruction *>(inst);
+                if (!functions.count(call->getFuncSyt()))
+                    continue;
+                calls[*func].push_back(call);
+                callSites[functions[call->getFuncSyt()]]++;
+            }
+}
+
+// a function is recursive if it can reach itself in the call graph.
+void Inliner::findRecursive()
+{
+    for (auto func = unit->begin(); func != unit->end(); func++)
+    {
+        std::set<Function *> visited;
+        std::vector<Function *> worklist = {*func};
+        while (!worklist.empty())
+        {
+            Function *cur = worklist.back();
+            worklist.pop_back();
+            for (auto &call : calls[cur])
+            {
+                Function *callee = functions[call->getFuncSyt()];
+                if (callee == *func)
+                    recursive.insert(*func);
+                if (visited.insert(callee).second)
+                    worklist.push_back(callee);
+            }
+        }
+    }
+}
+
+int Inliner::size(Function *func)
+{
+    int n = 0;
+    for (auto bb = func->begin(); bb != func->end(); bb++)
+        for (auto inst = (*bb)->begin(); inst != (*bb)->end(); inst = inst->getNext())
+            if (!inst->isAlloc())
+                n++;
+    return n;
+}
+
+bool Inliner::shouldInline(Function *caller, Function *callee)
+{
+    if (callee == caller || recursive.count(callee))
+        return false;
+    int calleeSize = size(callee);
+    if (size(caller) + calleeSize > callerLimit)
+        return false;
+    return calleeSize <= inlineThreshold || (callSites[callee] == 1 && calleeSize <= singleCallThreshold);
+}
+
+// Temporaries of the callee get fresh copies, parameters become the actual
+// arguments of the call, constants and globals are shared.
+Operand *Inliner::mapOperand(Operand *op, CallInstruction *call)
+{
+    if (op == nullptr)
+        return nullptr;
+    if (operandMap.count(op))
+        return operandMap[op];
+    SymbolEntry *se = op->getEntry();
+    Operand *rep;
+    if (se->isTemporary())
+        rep = new Operand(new TemporarySymbolEntry(se->getType(), SymbolTable::getLabel()));
+    else if (se->isVariable() && dynamic_cast<IdentifierSymbolEntry *>(se)->isParam())
+        rep = call->getOperands()[dynamic_cast<IdentifierSymbolEntry *>(se)->getParamNo() + 1];
+    else
+        rep = new Operand(se);
+    operandMap[op] = rep;
+    return rep;
+}
+
+void Inliner::cloneInstruction(Instruction *inst, BasicBlock *bb, Function *caller, CallInstruction *call)
+{
+    auto &ops = inst->getOperands();
+    if (auto alloca = dynamic_cast<AllocaInstruction *>(inst))
+        caller->getEntry()->insertFront(new AllocaInstruction(mapOperand(ops[0], call), alloca->getSymPtr()));
+    else if (inst->isLoad())
+        new LoadInstruction(mapOperand(ops[0], call), mapOperand(ops[1], call), bb);
+    else if (inst->isStore())
+        new StoreInstruction(mapOperand(ops[0], call), mapOperand(ops[1], call), bb);
+    else if (inst->isBinary())
+        new BinaryInstruction(inst->getOpcode(), mapOperand(ops[0], call), mapOperand(ops[1], call), mapOperand(ops[2], call), bb);
+    else if (inst->isGep())
+        new GepInstruction(mapOperand(ops[0], call), mapOperand(ops[1], call), mapOperand(ops[2], call), bb);
+    else if (inst->isCmp())
+        new CmpInstruction(inst->getOpcode(), mapOperand(ops[0], call), mapOperand(ops[1], call), mapOperand(ops[2], call), bb);
+    else if (dynamic_cast<SingleInstruction *>(inst))
+        new SingleInstruction(inst->getOpcode(), mapOperand(ops[0], call), mapOperand(ops[1], call), bb);
+    else if (auto conv = dynamic_cast<ConverInstruction *>(inst))
+        new ConverInstruction(conv->mode, mapOperand(ops[0], call), mapOperand(ops[1], call), bb);
+    else if (auto callee_call = dynamic_cast<CallInstruction *>(inst))
+    {
+        std::vector<Operand *> params;
+        for (size_t i = 1; i < ops.size(); i++)
+            params.push_back(mapOperand(ops[i], call));
+        auto clone = new CallInstruction(mapOperand(ops[0], call), callee_call->getFuncSyt(), params, bb);
+        if (functions.count(clone->getFuncSyt()))
+            callSites[functions[clone->getFuncSyt()]]++;
+    }
+    else if (auto br = dynamic_cast<UncondBrInstruction *>(inst))
+        new UncondBrInstruction(blockMap[br->getBranch()], bb);
+    else if (auto br = dynamic_cast<CondBrInstruction *>(inst))
+        new CondBrInstruction(blockMap[br->getTrueBranch()], blockMap[br->getFalseBranch()], mapOperand(ops[0], call), bb);
+}
+
+void Inliner::inlineCall(Function *caller, CallInstruction *call, Function *callee)
+{
+    operandMap.clear();
+    blockMap.clear();
+    BasicBlock *bb = call->getParent();
+
+    // split the block after the call, the continuation takes over the successors.
+    BasicBlock *cont = new BasicBlock(caller);
+    for (auto inst = call->getNext(); inst != bb->end();)
+    {
+        Instruction *next = inst->getNext();
+        bb->remove(inst);
+        cont->insertBack(inst);
+        inst = next;
+    }
+    while (!bb->succEmpty())
+    {
+        BasicBlock *succ = bb->getSuccB().front();
+        bb->removeSucc(succ);
+        succ->removePred(bb);
+        succ->addPred(cont);
+        cont->addSucc(succ);
+    }
+
+    std::vector<BasicBlock *> cloned;
+    for (auto b = callee->begin(); b != callee->end(); b++)
+    {
+        blockMap[*b] = new BasicBlock(caller);
+        cloned.push_back(blockMap[*b]);
+    }
+    std::vector<std::pair<BasicBlock *, Operand *>> rets;
+    for (auto b = callee->begin(); b != callee->end(); b++)
+    {
+        BasicBlock *nb = blockMap[*b];
+        for (auto succ = (*b)->succ_begin(); succ != (*b)->succ_end(); succ++)
+            nb->addSucc(blockMap[*succ]);
+        for (auto pred = (*b)->pred_begin(); pred != (*b)->pred_end(); pred++)
+            nb->addPred(blockMap[*pred]);
+        for (auto inst = (*b)->begin(); inst != (*b)->end(); inst = inst->getNext())
+        {
+            if (!inst->isRet())
+            {
+                cloneInstruction(inst, nb, caller, call);
+                continue;
+            }
+            if (!inst->getOperands().empty())
+                rets.push_back({nb, mapOperand(inst->getOperands()[0], call)});
+            new UncondBrInstruction(cont, nb);
+            nb->addSucc(cont);
+            cont->addPred(nb);
+            break;
+        }
+    }
+
+    // hand the return value over to the users of the call result.
+    Operand *dst = call->getDef();
+    Operand *retAddr = nullptr;
+    if (rets.size() == 1)
+        dst->replaceAllUsesWith(rets[0].second);
+    else if (rets.size() > 1 && dst->usersNum() > 0)
+    {
+        Type *retType = dynamic_cast<FunctionType *>(callee->getSymPtr()->getType())->getRetType();
+        retAddr = new Operand(new TemporarySymbolEntry(new PointerType(retType), SymbolTable::getLabel()));
+        caller->getEntry()->insertFront(new AllocaInstruction(retAddr, new TemporarySymbolEntry(retType, SymbolTable::getLabel())));
+        for (auto &ret : rets)
+            ret.first->insertBefore(new StoreInstruction(retAddr, ret.second), ret.first->rbegin());
+    }
+    else
+        dst = nullptr;
+    delete call;
+    if (retAddr != nullptr)
+        cont->insertFront(new LoadInstruction(dst, retAddr));
+
+    BasicBlock *entry = blockMap[callee->getEntry()];
+    new UncondBrInstruction(entry, bb);
+    bb->addSucc(entry);
+    entry->addPred(bb);
+
+    // keep the inlined body between the call block and its continuation.
+    auto &blocks = caller->getBlockList();
+    blocks.erase(blocks.end() - cloned.size() - 1, blocks.end());
+    cloned.push_back(cont);
+    blocks.insert(std::find(blocks.begin(), blocks.end(), bb) + 1, cloned.begin(), cloned.end());
+}
+
+void Inliner::pass()
+{
+    buildCallGraph();
+    findRecursive();
+
+    // visit callees before callers, so an inlined body already has its own calls inlined.
+    std::vector<Function *> order;
+    std::set<Function *> visited;
+    std::vector<std::pair<Function *, size_t>> stack;
+    for (auto func = unit->begin(); func != unit->end(); func++)
+    {
+        if (!visited.insert(*func).second)
+            continue;
+        stack.push_back({*func, 0});
+        while (!stack.empty())
+        {
+            auto &top = stack.back();
+            if (top.second < calls[top.first].size())
+            {
+                Function *callee = functions[calls[top.first][top.second++]->getFuncSyt()];
+                if (visited.insert(callee).second)
+                    stack.push_back({callee, 0});
+            }
+            else
+            {
+                order.push_back(top.first);
+                stack.pop_back();
+            }
+        }
+    }
+
+    for (auto &caller : order)
+    {
+        std::vector<CallInstruction *> worklist = calls[caller];
+        for (auto &call : worklist)
+        {
+            Function *callee = functions[call->getFuncSyt()];
+            if (!shouldInline(caller, callee))
+                continue;
+            callSites[callee]--;
+            inlineCall(caller, call, callee);
+        }
+    }
+
+    for (auto &func : order)
+        if (callSites[func] == 0 && func->getSymPtr()->toStr() != "@main")
+            unit->removeFunc(func);
+}
@@ -1,6 +1,8 @@
 #include "Instruction.h"
 #include "BasicBlock.h"
 #include <iostream>
+#include <algorithm>
+#include <climits>
 #include "Function.h"
 #include "Type.h"
 extern FILE* yyout;
@@ -23,6 +25,8 @@ Instruction::Instruction(unsigned instType, BasicBlock *insert_bb,bool GLO)
 
 Instruction::~Instruction()
 {
+    while (!use_nodes.empty())
+        use_nodes.back()->getValue()->removeUse(use_nodes.back());
     parent->remove(this);
 }
 
@@ -56,6 +60,60 @@ Instruction *Instruction::getPrev()
     return prev;
 }
 
+// the operand defined by this instruction, stores and terminators define nothing.
+Operand *Instruction::getDef()
+{
+    if (operands.empty() || instType == STORE || instType == COND || instType == UNCOND || instType == RET || instType == VECTOR)
+        return nullptr;
+    return operands[0];
+}
+
+std::vector<Operand*> Instruction::getUse()
+{
+    std::vector<Operand*> vec;
+    auto it = operands.begin();
+    if (getDef() != nullptr || (instType == CALL && !operands.empty()))
+        it++;
+    for (; it != operands.end(); it++)
+        vec.push_back(*it);
+    return vec;
+}
+
+void Instruction::removeUseNode(Use *use)
+{
+    auto it = std::find(use_nodes.begin(), use_nodes.end(), use);
+    if (it != use_nodes.end())
+        use_nodes.erase(it);
+}
+
+Use *Instruction::findUseNode(Operand *op)
+{
+    for (auto &use : use_nodes)
+        if (use->getValue() == op)
+            return use;
+    return nullptr;
+}
+
+// point the use slots holding old at rep, the Use nodes are relinked by the caller.
+void Instruction::replaceOperand(Operand *old, Operand *rep)
+{
+    for (size_t i = getDef() != nullptr ? 1 : 0; i < operands.size(); i++)
+        if (operands[i] == old)
+            operands[i] = rep;
+}
+
+// make this instruction use rep wherever it used old.
+void Instruction::replaceUse(Operand *old, Operand *rep)
+{
+    for (size_t i = getDef() != nullptr ? 1 : 0; i < operands.size(); i++)
+        if (operands[i] == old)
+        {
+            old->removeUse(this);
+            rep->addUse(this);
+            operands[i] = rep;
+        }
+}
+
 BinaryInstruction::BinaryInstruction(unsigned opcode, Operand *dst, Operand *src1, Operand *src2, BasicBlock *insert_bb) : Instruction(BINARY, insert_bb,0)
 {
     this->opcode = opcode;
@@ -103,6 +161,8 @@ void BinaryInstruction::output() const
     default:
         break;
     }
+    if (operands[0]->isFloat())
+        op = op == "sdiv" ? "fdiv" : "f" + op;
     fprintf(yyout, "  %s = %s %s %s, %s\n", s1.c_str(), op.c_str(), type.c_str(), s2.c_str(), s3.c_str());
 }
 
@@ -158,6 +218,12 @@ void CmpInstruction::output() const
         op = "";
         break;
     }
+    if (operands[1]->isFloat())
+    {
+        op = op.size() == 3 ? "o" + op.substr(1) : op == "ne" ? "one" : "o" + op;
+        fprintf(yyout, "  %s = fcmp %s %s %s, %s\n", s1.c_str(), op.c_str(), type.c_str(), s2.c_str(), s3.c_str());
+        return;
+    }
 
     fprintf(yyout, "  %s = icmp %s %s %s, %s\n", s1.c_str(), op.c_str(), type.c_str(), s2.c_str(), s3.c_str());
 }
@@ -329,6 +395,33 @@ void StoreInstruction::output() const
     fprintf(yyout, "  store %s %s, %s %s, align 4\n", src_type.c_str(), src.c_str(), dst_type.c_str(), dst.c_str());
 }
 
+GepInstruction::GepInstruction(Operand *dst, Operand *base, Operand *index, BasicBlock *insert_bb) : Instruction(GEP, insert_bb,0)
+{
+    operands.push_back(dst);
+    operands.push_back(base);
+    operands.push_back(index);
+    dst->setDef(this);
+    base->addUse(this);
+    index->addUse(this);
+}
+
+GepInstruction::~GepInstruction()
+{
+    operands[0]->setDef(nullptr);
+    if(operands[0]->usersNum() == 0)
+        delete operands[0];
+    operands[1]->removeUse(this);
+    operands[2]->removeUse(this);
+}
+
+void GepInstruction::output() const
+{
+    std::string dst = operands[0]->toStr();
+    std::string base = operands[1]->toStr();
+    std::string index = operands[2]->toStr();
+    fprintf(yyout, "  %s = getelementptr inbounds i32, i32* %s, i32 %s\n", dst.c_str(), base.c_str(), index.c_str());
+}
+
 SingleInstruction::SingleInstruction(unsigned opcode , Operand *dst, Operand *src, BasicBlock *insert_bb) : Instruction(SINGLE, insert_bb,0)
 {
     this->opcode = opcode;
@@ -380,7 +473,10 @@ ConverInstruction::ConverInstruction(int mo,
     mode=mo;
     operands.push_back(dst);
     operands.push_back(src);
-    dst->setintType();
+    if (mode == ITOF)
+        dst->setfloatType();
+    else
+        dst->setintType();
     dst->setDef(this);
     src->addUse(this);
 }
@@ -395,7 +491,11 @@ ConverInstruction::~ConverInstruction() {
 void ConverInstruction::output() const {
     Operand* dst = operands[0];
     Operand* src = operands[1];
-    if(mode)
+    if(mode == ITOF)
+        fprintf(yyout, "  %s = sitofp i32 %s to float\n", dst->toStr().c_str(), src->toStr().c_str());
+    else if(mode == FTOI)
+        fprintf(yyout, "  %s = fptosi float %s to i32\n", dst->toStr().c_str(), src->toStr().c_str());
+    else if(mode)
         fprintf(yyout, "  %s = zext i1 %s to i32\n", dst->toStr().c_str(), src->toStr().c_str());
 }
 
@@ -420,10 +520,14 @@ CallInstruction::CallInstruction(Operand* dst,
 
 
 CallInstruction::~CallInstruction() {
-    operands[0]->setDef(nullptr);
-    if (operands[0]->usersNum() == 0)
-        delete operands[0];
-    //operands[1]->removeUse(this);
+    if (operands[0] != nullptr)
+    {
+        operands[0]->setDef(nullptr);
+        if (operands[0]->usersNum() == 0)
+            delete operands[0];
+    }
+    for (auto it = operands.begin() + 1; it != operands.end(); it++)
+        (*it)->removeUse(this);
 }
 
 void CallInstruction::output() const {
@@ -450,10 +554,11 @@ MachineOperand* Instruction::genMachineOperand(Operand* ope)
 {
     auto se = ope->getEntry();
     MachineOperand* mope = nullptr;
+    // a float constant is an immediate holding its bits
     if (se->isConstant())
         mope = new MachineOperand(MachineOperand::IMM, dynamic_cast<ConstantSymbolEntry*>(se)->getValue());
     else if (se->isTemporary())
-        mope = new MachineOperand(MachineOperand::VREG, dynamic_cast<TemporarySymbolEntry*>(se)->getLabel());
+        mope = new MachineOperand(MachineOperand::VREG, dynamic_cast<TemporarySymbolEntry*>(se)->getLabel(), ope->isFloat());
     else if (se->isVariable()) 
     {
         auto id_se = dynamic_cast<IdentifierSymbolEntry*>(se);
@@ -461,9 +566,12 @@ MachineOperand* Instruction::genMachineOperand(Operand* ope)
             mope = new MachineOperand(id_se->toStr().c_str());
         else if (id_se -> isParam()) 
         {
-            if (id_se -> getParamNo() < 4)
+            // float parameters arrive in s0-s15, the others in r0-r3
+            if (ope->isFloat())
+                mope = new MachineOperand(MachineOperand::REG, id_se -> getArgNo(), true);
+            else if (id_se -> getArgNo() < 4)
             {
-                int temp = id_se -> getParamNo();
+                int temp = id_se -> getArgNo();
                 mope = new MachineOperand(MachineOperand::REG, temp);
             }
             else
@@ -474,14 +582,27 @@ MachineOperand* Instruction::genMachineOperand(Operand* ope)
     }
     return mope;
 }
-MachineOperand* Instruction::genMachineReg(int reg) 
+MachineOperand* Instruction::genMachineReg(int reg, bool fpu) 
+{
+    return new MachineOperand(MachineOperand::REG, reg, fpu);
+}
+
+MachineOperand* Instruction::genMachineVReg(bool fpu) 
 {
-    return new MachineOperand(MachineOperand::REG, reg);
+    return new MachineOperand(MachineOperand::VREG, SymbolTable::getLabel(), fpu);
 }
 
-MachineOperand* Instruction::genMachineVReg() 
+// VFP instructions only take registers, a float immediate is moved over
+// from a core register.
+MachineOperand* Instruction::genMachineFloat(MachineBlock *cur_block, MachineOperand *src)
 {
-    return new MachineOperand(MachineOperand::VREG, SymbolTable::getLabel());
+    if (!src->isImm())
+        return src;
+    auto bits = genMachineVReg();
+    cur_block->InsertInst(new LoadMInstruction(cur_block, bits, src));
+    auto reg = genMachineVReg(true);
+    cur_block->InsertInst(new MovMInstruction(cur_block, MovMInstruction::MOV, reg, new MachineOperand(*bits)));
+    return new MachineOperand(*reg);
 }
 
 MachineOperand* Instruction::genMachineImm(int val) 
@@ -503,7 +624,8 @@ void AllocaInstruction::genMachineCode(AsmBuilder* builder)
     * Allocate stack space for local variabel
     * Store frame offset in symbol entry */
     auto cur_func = builder->getFunction();
-    int offset = cur_func->AllocSpace(4);
+    int size = se->getType()->isArray() ? dynamic_cast<ArrayType*>(se->getType())->getSize() : 4;
+    int offset = cur_func->AllocSpace(size);
     dynamic_cast<TemporarySymbolEntry*>(operands[0]->getEntry())->setOffset(-offset);
 }
 
@@ -511,6 +633,17 @@ void LoadInstruction::genMachineCode(AsmBuilder* builder)
 {
     auto cur_block = builder->getBlock();
     MachineInstruction* cur_inst = nullptr;
+    // Load array element, the address goes into the addressing mode
+    // example: ldr r1, [r0, r2, lsl #2]
+    if(operands[1]->getDef() && operands[1]->getDef()->isGep()
+    && dynamic_cast<GepInstruction*>(operands[1]->getDef())->isFolded())
+    {
+        MachineOperand *base, *offset;
+        dynamic_cast<GepInstruction*>(operands[1]->getDef())->genAddress(cur_block, base, offset);
+        cur_inst = new LoadMInstruction(cur_block, genMachineOperand(operands[0]), base, offset);
+        cur_block->InsertInst(cur_inst);
+        return;
+    }
     // Load global operand
     if(operands[1]->getEntry()->isVariable()
     && dynamic_cast<IdentifierSymbolEntry*>(operands[1]->getEntry())->isGlobal())
@@ -564,7 +697,14 @@ void StoreInstruction::genMachineCode(AsmBuilder* builder)
         cur_block->InsertInst(cur_inst);
         src = new MachineOperand(*temp);
     }
-    if (operands[0]->getEntry()->isTemporary() && operands[0] -> getDef() && operands[0]->getDef()->isAlloc()) 
+    if (operands[0]->getDef() && operands[0]->getDef()->isGep()
+    && dynamic_cast<GepInstruction*>(operands[0]->getDef())->isFolded())
+    {
+        MachineOperand *base, *offset;
+        dynamic_cast<GepInstruction*>(operands[0]->getDef())->genAddress(cur_block, base, offset);
+        cur_block->InsertInst(new StoreMInstruction(cur_block, src, base, offset));
+    }
+    else if (operands[0]->getEntry()->isTemporary() && operands[0] -> getDef() && operands[0]->getDef()->isAlloc()) 
     {
         MachineOperand* temp = genMachineReg(11);
         cur_inst = new StoreMInstruction(cur_block, src, temp, genMachineImm(dynamic_cast<TemporarySymbolEntry*>(operands[0] -> getEntry())->getOffset()));
@@ -574,12 +714,114 @@ void StoreInstruction::genMachineCode(AsmBuilder* builder)
     {
         MachineOperand *temp = genMachineVReg();
         cur_block->InsertInst(new LoadMInstruction(cur_block, temp, dst));
-        cur_block->InsertInst(new StoreMInstruction(cur_block, src, temp));
+        cur_block->InsertInst(new StoreMInstruction(cur_block, src, new MachineOperand(*temp)));
     }
 
 
 }
 
+// Every user loads or stores through the address, which then needs no
+// register of its own.
+bool GepInstruction::isFolded()
+{
+    for (auto use = operands[0]->use_begin(); use != operands[0]->use_end(); use++)
+    {
+        Instruction *inst = *use;
+        if (inst->isLoad() && inst->getOperands()[1] == operands[0])
+            continue;
+        if (inst->isStore() && inst->getOperands()[0] == operands[0] && inst->getOperands()[1] != operands[0])
+            continue;
+        return false;
+    }
+    return true;
+}
+
+// Split the element address into a base register and what ldr/str accept as
+// offset: an immediate byte offset or the index register shifted left by 2.
+void GepInstruction::genAddress(MachineBlock *cur_block, MachineOperand *&base, MachineOperand *&offset)
+{
+    Operand *ptr = operands[1];
+    MachineOperand *index = genMachineOperand(operands[2]);
+    int disp = 0;
+    if (ptr->getDef() && ptr->getDef()->isAlloc())
+    {
+        // local array, at a fixed offset from fp
+        base = genMachineReg(11);
+        disp = dynamic_cast<TemporarySymbolEntry*>(ptr->getEntry())->getOffset();
+    }
+    else if (ptr->getEntry()->isVariable())
+    {
+        // global array, movw/movt its address
+        auto addr = genMachineVReg();
+        cur_block->InsertInst(new LoadMInstruction(cur_block, addr, genMachineOperand(ptr)));
+        base = new MachineOperand(*addr);
+    }
+    else
+        base = genMachineOperand(ptr);
+    if (index->isImm())
+        disp += index->getVal() * 4;
+    else if (disp != 0)
+    {
+        auto addr = genMachineVReg();
+        if (MachineOperand::isEncodableImm(disp) || MachineOperand::isEncodableImm(-disp))
+            cur_block->InsertInst(new BinaryMInstruction(cur_block, disp < 0 ? BinaryMInstruction::SUB : BinaryMInstruction::ADD, addr, base, genMachineImm(disp < 0 ? -disp : disp)));
+        else
+        {
+            auto temp = genMachineVReg();
+            cur_block->InsertInst(new LoadMInstruction(cur_block, temp, genMachineImm(disp)));
+            cur_block->InsertInst(new BinaryMInstruction(cur_block, BinaryMInstruction::ADD, addr, base, new MachineOperand(*temp)));
+        }
+        base = new MachineOperand(*addr);
+    }
+    if (!index->isImm())
+    {
+        offset = index;
+        offset->setShift(MachineOperand::LSL, 2);
+    }
+    else if (disp > -4096 && disp < 4096)
+        offset = genMachineImm(disp);
+    else
+    {
+        auto temp = genMachineVReg();
+        cur_block->InsertInst(new LoadMInstruction(cur_block, temp, genMachineImm(disp)));
+        offset = new MachineOperand(*temp);
+    }
+}
+
+void GepInstruction::genMachineCode(AsmBuilder* builder)
+{
+    if (isFolded())
+        return;
+    auto cur_block = builder->getBlock();
+    MachineOperand *base, *offset;
+    genAddress(cur_block, base, offset);
+    auto dst = genMachineOperand(operands[0]);
+    if (offset->isImm() && offset->getVal() == 0)
+        cur_block->InsertInst(new MovMInstruction(cur_block, MovMInstruction::MOV, dst, base));
+    else if (offset->isImm() && !MachineOperand::isEncodableImm(offset->getVal()) && MachineOperand::isEncodableImm(-offset->getVal()))
+        cur_block->InsertInst(new BinaryMInstruction(cur_block, BinaryMInstruction::SUB, dst, base, genMachineImm(-offset->getVal())));
+    else if (offset->isImm() && !MachineOperand::isEncodableImm(offset->getVal()))
+    {
+        auto temp = genMachineVReg();
+        cur_block->InsertInst(new LoadMInstruction(cur_block, temp, offset));
+        cur_block->InsertInst(new BinaryMInstruction(cur_block, BinaryMInstruction::ADD, dst, base, new MachineOperand(*temp)));
+    }
+    else
+        cur_block->InsertInst(new BinaryMInstruction(cur_block, BinaryMInstruction::ADD, dst, base, offset));
+}
+
+// every user is a branch taken on the flags this compare sets
+bool CmpInstruction::isFlagOnly()
+{
+    for (auto use = operands[0]->use_begin(); use != operands[0]->use_end(); use++)
+    {
+        Instruction *user = *use;
+        if (!user->isCond() || dynamic_cast<CondBrInstruction *>(user)->getFlagsCmp() != this)
+            return false;
+    }
+    return true;
+}
+
 void CmpInstruction::genMachineCode(AsmBuilder* builder)
 {
     // TODO
@@ -590,6 +832,12 @@ void CmpInstruction::genMachineCode(AsmBuilder* builder)
     // std::cout<<dst<<std::endl;
     // std::cout<<src1<<std::endl;
     MachineInstruction* cur_inst = nullptr;
+    // vcmp compares with #0 but no other immediate
+    if (operands[1]->isFloat() || operands[2]->isFloat()) {
+        src1 = genMachineFloat(cur_block, src1);
+        if (!src2->isImm() || src2->getVal() != 0)
+            src2 = genMachineFloat(cur_block, src2);
+    }
     if (src1->isImm()) {
         auto internal_reg = genMachineVReg();
         cur_inst = new LoadMInstruction(cur_block, 
@@ -597,9 +845,9 @@ void CmpInstruction::genMachineCode(AsmBuilder* builder)
         cur_block->InsertInst(cur_inst);
         src1 = new MachineOperand(*internal_reg);
     }
-    if (src2->isImm() &&
-        ((ConstantSymbolEntry*)(operands[2]->getEntry()))->getValue() >
-            255) {
+    // cmp takes the immediate directly when it or its negation (cmn) is encodable
+    if (src2->isImm() && !src1->isFloat() && !MachineOperand::isEncodableImm(src2->getVal()) &&
+        !MachineOperand::isEncodableImm(-(unsigned)src2->getVal())) {
         auto internal_reg = genMachineVReg();
         cur_inst = new LoadMInstruction(cur_block,
                                         internal_reg, src2);
@@ -609,6 +857,9 @@ void CmpInstruction::genMachineCode(AsmBuilder* builder)
     cur_inst = new CmpMInstruction(cur_block,  src1,
                                     src2, opcode);
     cur_block->InsertInst(cur_inst);
+    // branches on the result read the flags, the boolean itself is not needed
+    if (isFlagOnly())
+        return;
     if (opcode >= CmpInstruction::L && opcode <= CmpInstruction::GE) {
         auto dst = genMachineOperand(operands[0]);
         auto trueOperand = genMachineImm(1);
@@ -618,7 +869,7 @@ void CmpInstruction::genMachineCode(AsmBuilder* builder)
         cur_inst = new MovMInstruction(cur_block, MovMInstruction::MOV, dst,
                                         trueOperand, opcode);
         cur_block->InsertInst(cur_inst);
-        cur_inst = new MovMInstruction(cur_block, MovMInstruction::MOV, dst,
+        cur_inst = new MovMInstruction(cur_block, MovMInstruction::MOV, new MachineOperand(*dst),
                                         falseOperand, 7 - opcode);
         cur_block->InsertInst(cur_inst);
     } else if (opcode == CmpInstruction::E) {
@@ -628,7 +879,7 @@ void CmpInstruction::genMachineCode(AsmBuilder* builder)
         cur_inst = new MovMInstruction(cur_block, MovMInstruction::MOV, dst,
                                         trueOperand, E);
         cur_block->InsertInst(cur_inst);
-        cur_inst = new MovMInstruction(cur_block, MovMInstruction::MOV, dst,
+        cur_inst = new MovMInstruction(cur_block, MovMInstruction::MOV, new MachineOperand(*dst),
                                         falseOperand, NE);
         cur_block->InsertInst(cur_inst);
 
@@ -639,7 +890,7 @@ void CmpInstruction::genMachineCode(AsmBuilder* builder)
         cur_inst = new MovMInstruction(cur_block, MovMInstruction::MOV, dst,
                                         trueOperand, NE);
         cur_block->InsertInst(cur_inst);
-        cur_inst = new MovMInstruction(cur_block, MovMInstruction::MOV, dst,
+        cur_inst = new MovMInstruction(cur_block, MovMInstruction::MOV, new MachineOperand(*dst),
                                         falseOperand, E);
         cur_block->InsertInst(cur_inst);
     }
@@ -654,12 +905,41 @@ void UncondBrInstruction::genMachineCode(AsmBuilder* builder)
     cur_block->InsertInst(new BranchMInstruction(cur_block, BranchMInstruction::B, new MachineOperand(temp)));
 }
 
+// The flags are still those of the compare producing the condition only if
+// no other compare or call sits in between; otherwise the value is tested.
+CmpInstruction *CondBrInstruction::getFlagsCmp()
+{
+    for (auto i = prev; i != parent->end(); i = i->getPrev())
+    {
+        if (i == operands[0]->getDef())
+            return i->isCmp() ? dynamic_cast<CmpInstruction *>(i) : nullptr;
+        if (i->isCmp() || i->isCall())
+            return nullptr;
+    }
+    return nullptr;
+}
+
 void CondBrInstruction::genMachineCode(AsmBuilder* builder)
 {
     // TODO
     MachineBlock *cur_block = builder->getBlock();
+    CmpInstruction *cmp = getFlagsCmp();
+    int cond = MachineInstruction::NE;
+    if (cmp)
+        cond = cmp->getOpcode();
+    else
+    {
+        MachineOperand *src = genMachineOperand(operands[0]);
+        if (src->isImm())
+        {
+            auto internal_reg = genMachineVReg();
+            cur_block->InsertInst(new LoadMInstruction(cur_block, internal_reg, src));
+            src = new MachineOperand(*internal_reg);
+        }
+        cur_block->InsertInst(new CmpMInstruction(cur_block, src, genMachineImm(0)));
+    }
     std::string temp =".L" + std::to_string(true_branch->getNo());
-    BranchMInstruction *cur_inst = new BranchMInstruction(cur_block, BranchMInstruction::B, new MachineOperand(temp), cur_block->getCmpNo());
+    BranchMInstruction *cur_inst = new BranchMInstruction(cur_block, BranchMInstruction::B, new MachineOperand(temp), cond);
     cur_block->InsertInst(cur_inst);
     temp =  ".L" + std::to_string(false_branch->getNo());
     cur_inst = new BranchMInstruction(cur_block, BranchMInstruction::B, new MachineOperand(temp));
@@ -674,18 +954,182 @@ void RetInstruction::genMachineCode(AsmBuilder* builder)
     * 2. Restore callee saved registers and sp, fp
     * 3. Generate bx instruction */
     auto cur_block = builder->getBlock();
-    if (!operands.empty()) 
+    // a tail call has already left the function
+    if (prev != parent->end() && prev->isCall() && dynamic_cast<CallInstruction*>(prev)->isTailCall())
+        return;
+    if (!operands.empty() && operands[0]->isFloat())
+        cur_block->InsertInst(new MovMInstruction(cur_block, MovMInstruction::MOV, genMachineReg(0, true), genMachineFloat(cur_block, genMachineOperand(operands[0]))));
+    else if (!operands.empty()) 
     {
         auto *temp = new MovMInstruction(cur_block, MovMInstruction::MOV, new MachineOperand(MachineOperand::REG, 0), genMachineOperand(operands[0]));
         cur_block->InsertInst(temp);
     }
+    // fp holds sp right after the callee saved registers are pushed, restoring sp
+    // from it stays correct even when spilling grows the frame afterwards.
     MachineOperand *sp = new MachineOperand(MachineOperand::REG, 13);
-    MachineOperand *size =new MachineOperand(MachineOperand::IMM, builder->getFunction()->AllocSpace(0));
-    cur_block->InsertInst(new BinaryMInstruction(cur_block, BinaryMInstruction::ADD,sp, sp, size));
+    MachineOperand *fp = new MachineOperand(MachineOperand::REG, 11);
+    cur_block->InsertInst(new MovMInstruction(cur_block, MovMInstruction::MOV, sp, fp));
     MachineOperand *lr = new MachineOperand(MachineOperand::REG, 14);
     cur_block->InsertInst(new BranchMInstruction(cur_block, BranchMInstruction::BX, lr));
 }
 
+// Magic multiplier and shift for signed division by d >= 2,
+// see Hacker's Delight, chapter 10.
+static void divMagic(int d, int &magic, int &shift)
+{
+    const unsigned two31 = 0x80000000;
+    unsigned ad = d;
+    unsigned anc = two31 - 1 - two31 % ad;
+    unsigned q1 = two31 / anc, r1 = two31 - q1 * anc;
+    unsigned q2 = two31 / ad, r2 = two31 - q2 * ad;
+    unsigned delta;
+    int p = 31;
+    do
+    {
+        p++;
+        q1 *= 2;
+        r1 *= 2;
+        if (r1 >= anc)
+        {
+            q1++;
+            r1 -= anc;
+        }
+        q2 *= 2;
+        r2 *= 2;
+        if (r2 >= ad)
+        {
+            q2++;
+            r2 -= ad;
+        }
+        delta = ad - r2;
+    } while (q1 < delta || (q1 == delta && r1 == 0));
+    magic = (int)(q2 + 1);
+    shift = p - 32;
+}
+
+// Insert a sequence computing into fresh vregs, with the last step writing dst directly.
+static void insertSequence(MachineBlock *cur_block, std::vector<MachineInstruction*> &insts, MachineOperand *dst, MachineOperand *src)
+{
+    if (insts.empty())
+        insts.push_back(new MovMInstruction(cur_block, MovMInstruction::MOV, dst, new MachineOperand(*src)));
+    else
+    {
+        insts.back()->getDef()[0] = dst;
+        dst->setParent(insts.back());
+    }
+    for (auto &inst : insts)
+        cur_block->InsertInst(inst);
+}
+
+// dst = src / divisor rounded towards zero, without sdiv.
+// divisor is neither 0 nor INT_MIN.
+void BinaryInstruction::genDivByConst(MachineBlock *cur_block, MachineOperand *dst, MachineOperand *src, int divisor)
+{
+    std::vector<MachineInstruction*> insts;
+    auto emit = [&](int op, MachineOperand *src1, MachineOperand *src2) {
+        auto res = genMachineVReg();
+        insts.push_back(new BinaryMInstruction(cur_block, op, res, new MachineOperand(*src1), src2));
+        return res;
+    };
+    int d = divisor < 0 ? -divisor : divisor;
+    MachineOperand *q = src;
+    if (d != 1 && (d & (d - 1)) == 0)
+    {
+        // add 2^k - 1 to a negative dividend before the arithmetic shift
+        int k = 0;
+        while ((1 << k) != d)
+            k++;
+        MachineOperand *sign = src;
+        if (k > 1)
+            sign = emit(BinaryMInstruction::ASR, src, genMachineImm(31));
+        auto bias = emit(BinaryMInstruction::LSR, sign, genMachineImm(32 - k));
+        auto t = emit(BinaryMInstruction::ADD, src, new MachineOperand(*bias));
+        q = emit(BinaryMInstruction::ASR, t, genMachineImm(k));
+    }
+    else if (d != 1)
+    {
+        int magic, shift;
+        divMagic(d, magic, shift);
+        auto m = genMachineVReg();
+        insts.push_back(new LoadMInstruction(cur_block, m, genMachineImm(magic)));
+        q = emit(BinaryMInstruction::SMMUL, src, new MachineOperand(*m));
+        if (magic < 0)
+            q = emit(BinaryMInstruction::ADD, q, new MachineOperand(*src));
+        if (shift > 0)
+            q = emit(BinaryMInstruction::ASR, q, genMachineImm(shift));
+        auto sign = emit(BinaryMInstruction::LSR, src, genMachineImm(31));
+        q = emit(BinaryMInstruction::ADD, q, new MachineOperand(*sign));
+    }
+    if (divisor < 0)
+        q = emit(BinaryMInstruction::RSB, q, genMachineImm(0));
+    insertSequence(cur_block, insts, dst, q);
+}
+
+// dst = src * factor with at most two shift/add/sub/rsb instructions,
+// returns false if the factor is not that cheap and mul should be used.
+bool BinaryInstruction::genMulByConst(MachineBlock *cur_block, MachineOperand *dst, MachineOperand *src, int factor)
+{
+    std::vector<MachineInstruction*> insts;
+    auto emit = [&](int op, MachineOperand *src1, MachineOperand *src2) {
+        auto res = genMachineVReg();
+        insts.push_back(new BinaryMInstruction(cur_block, op, res, new MachineOperand(*src1), src2));
+        return res;
+    };
+    auto shifted = [&](MachineOperand *reg, int amount) {
+        auto op = new MachineOperand(*reg);
+        op->setShift(MachineOperand::LSL, amount);
+        return op;
+    };
+    auto log2 = [](unsigned v) {
+        int k = 0;
+        while ((1u << k) != v)
+            k++;
+        return k;
+    };
+    auto isPow2 = [](unsigned v) { return v != 0 && (v & (v - 1)) == 0; };
+
+    if (factor == 0)
+    {
+        cur_block->InsertInst(new MovMInstruction(cur_block, MovMInstruction::MOV, dst, genMachineImm(0)));
+        return true;
+    }
+    bool negate = factor < 0 && !isPow2((unsigned)factor);
+    unsigned m = negate ? -(unsigned)factor : (unsigned)factor;
+    int tz = 0;
+    while (!(m & 1))
+    {
+        m >>= 1;
+        tz++;
+    }
+    bool sub = negate && m != 1 && isPow2(m + 1);
+    if ((m != 1) + (tz > 0) + (negate && !sub) > 2)
+        return false;
+    MachineOperand *res = src;
+    if (m != 1)
+    {
+        if (sub)
+        {
+            // x * -(2^a - 1) = x - (x << a)
+            res = emit(BinaryMInstruction::SUB, src, shifted(src, log2(m + 1)));
+            negate = false;
+        }
+        else if (isPow2(m - 1))
+            // x * (2^a + 1) = x + (x << a)
+            res = emit(BinaryMInstruction::ADD, src, shifted(src, log2(m - 1)));
+        else if (isPow2(m + 1))
+            // x * (2^a - 1) = (x << a) - x
+            res = emit(BinaryMInstruction::RSB, src, shifted(src, log2(m + 1)));
+        else
+            return false;
+    }
+    if (tz > 0)
+        res = emit(BinaryMInstruction::LSL, res, genMachineImm(tz));
+    if (negate)
+        res = emit(BinaryMInstruction::RSB, res, genMachineImm(0));
+    insertSequence(cur_block, insts, dst, res);
+    return true;
+}
+
 void BinaryInstruction::genMachineCode(AsmBuilder* builder)
 {
     // TODO:
@@ -700,6 +1144,15 @@ void BinaryInstruction::genMachineCode(AsmBuilder* builder)
     * So you need to insert LOAD/MOV instrucrion to load immediate num into register.
     * As to other instructions, such as MUL, CMP, you need to deal with this situation, too.*/
     MachineInstruction* cur_inst = nullptr;
+    if(operands[0]->isFloat())
+    {
+        src1 = genMachineFloat(cur_block, src1);
+        src2 = genMachineFloat(cur_block, src2);
+        int op = opcode == ADD ? BinaryMInstruction::VADD : opcode == SUB ? BinaryMInstruction::VSUB
+               : opcode == MUL ? BinaryMInstruction::VMUL : BinaryMInstruction::VDIV;
+        cur_block->InsertInst(new BinaryMInstruction(cur_block, op, dst, src1, src2));
+        return;
+    }
     if(src1->isImm()&&src2->isImm()){
         //常量折叠
         auto result_IMM = genMachineImm(src1->getVal()+src2->getVal());
@@ -734,34 +1187,21 @@ void BinaryInstruction::genMachineCode(AsmBuilder* builder)
         return;
     }
 
-    // if((src1->isImm() || src2->isImm()) && opcode == MUL){
-    //     //乘法优化
-    //     int val_IMM;
-    //     if(src1->isImm()) val_IMM = src1->getVal();
-    //     else val_IMM = src2->getVal();
-    //     //std::cout<<val_IMM<<std::endl;
-    //     if(val_IMM == 0){
-    //         //std::cout<<n_IMM<<std::endl;
-    //         auto result_IMM = genMachineImm(0);
-    //         cur_inst = new MovMInstruction(cur_block,MovMInstruction::MOV,dst,result_IMM);
-    //         cur_block->InsertInst(cur_inst);
-    //         return;
-    //     }
-    //     else if(val_IMM % 2 == 0){
-    //         int n_IMM=0;
-    //         while(val_IMM!=1){
-    //             val_IMM /= 2;
-    //             n_IMM++;
-    //         }
-    //         //std::cout<<n_IMM<<std::endl;
-    //         auto result_IMM = genMachineImm(n_IMM);
-    //         cur_inst = new SalMInstruction(cur_block,dst,result_IMM);
-    //         cur_block->InsertInst(cur_inst);
-    //         return;
-    //     }
-
-    // }
+    if((src1->isImm() || src2->isImm()) && opcode == MUL)
+    {
+        //乘法优化
+        if(src1->isImm() ? genMulByConst(cur_block, dst, src2, src1->getVal()) : genMulByConst(cur_block, dst, src1, src2->getVal()))
+            return;
+    }
 
+    // immediate first operand: add is commutative, sub becomes rsb
+    if(src1->isImm() && MachineOperand::isEncodableImm(src1->getVal()) && (opcode == ADD || opcode == AND || opcode == OR))
+        std::swap(src1, src2);
+    if(src1->isImm() && MachineOperand::isEncodableImm(src1->getVal()) && opcode == SUB)
+    {
+        cur_block->InsertInst(new BinaryMInstruction(cur_block, BinaryMInstruction::RSB, dst, src2, src1));
+        return;
+    }
     if(src1->isImm())
     {
         auto internal_reg = genMachineVReg();
@@ -769,7 +1209,52 @@ void BinaryInstruction::genMachineCode(AsmBuilder* builder)
         cur_block->InsertInst(cur_inst);
         src1 = new MachineOperand(*internal_reg);
     }
-    if(src2->isImm())
+    // division by a constant: multiply by its reciprocal instead of sdiv,
+    // the remainder is n - (n / d) * d.
+    if(src2->isImm() && (opcode == DIV || opcode == MOD) && src2->getVal() != 0 && src2->getVal() != INT_MIN)
+    {
+        int d = src2->getVal();
+        if(opcode == DIV)
+        {
+            genDivByConst(cur_block, dst, src1, d);
+            return;
+        }
+        if(d == 1 || d == -1)
+        {
+            cur_block->InsertInst(new MovMInstruction(cur_block, MovMInstruction::MOV, dst, genMachineImm(0)));
+            return;
+        }
+        d = d < 0 ? -d : d;
+        auto quot = genMachineVReg();
+        genDivByConst(cur_block, quot, src1, d);
+        if((d & (d - 1)) == 0)
+        {
+            // n - (q << k)
+            int k = 0;
+            while((1 << k) != d)
+                k++;
+            auto prod = new MachineOperand(*quot);
+            prod->setShift(MachineOperand::LSL, k);
+            cur_block->InsertInst(new BinaryMInstruction(cur_block, BinaryMInstruction::SUB, dst, new MachineOperand(*src1), prod));
+        }
+        else
+        {
+            auto divisor = genMachineVReg();
+            cur_block->InsertInst(new LoadMInstruction(cur_block, divisor, genMachineImm(d)));
+            cur_block->InsertInst(new MlaMInstruction(cur_block, MlaMInstruction::MLS, dst, new MachineOperand(*quot), new MachineOperand(*divisor), new MachineOperand(*src1)));
+        }
+        return;
+    }
+    // add/sub/and/orr take an encodable immediate as second operand,
+    // add and sub swap into each other for an encodable negation.
+    bool negated = false;
+    if(src2->isImm() && (opcode == ADD || opcode == SUB) && !MachineOperand::isEncodableImm(src2->getVal())
+        && MachineOperand::isEncodableImm(-(unsigned)src2->getVal()))
+    {
+        src2 = genMachineImm(-(unsigned)src2->getVal());
+        negated = true;
+    }
+    if(src2->isImm() && !((opcode == ADD || opcode == SUB || opcode == AND || opcode == OR) && MachineOperand::isEncodableImm(src2->getVal())))
     {
         auto internal_reg = genMachineVReg();
         cur_inst = new LoadMInstruction(cur_block, internal_reg, src2);
@@ -779,10 +1264,10 @@ void BinaryInstruction::genMachineCode(AsmBuilder* builder)
     switch (opcode)
     {
     case ADD:
-        cur_inst = new BinaryMInstruction(cur_block, BinaryMInstruction::ADD, dst, src1, src2);
+        cur_inst = new BinaryMInstruction(cur_block, negated ? BinaryMInstruction::SUB : BinaryMInstruction::ADD, dst, src1, src2);
         break;
     case SUB:
-        cur_inst = new BinaryMInstruction(cur_block, BinaryMInstruction::SUB, dst, src1, src2);
+        cur_inst = new BinaryMInstruction(cur_block, negated ? BinaryMInstruction::ADD : BinaryMInstruction::SUB, dst, src1, src2);
         break;
     case AND:
         cur_inst = new BinaryMInstruction(cur_block, BinaryMInstruction::AND, dst, src1, src2);
@@ -799,13 +1284,11 @@ void BinaryInstruction::genMachineCode(AsmBuilder* builder)
         break;
     case MOD: 
         {
-            cur_inst = new BinaryMInstruction(cur_block, BinaryMInstruction::DIV, dst, src1, src2);
-            MachineOperand* temp = new MachineOperand(*dst);
-            cur_block->InsertInst(cur_inst);
-            cur_inst = new BinaryMInstruction(cur_block, BinaryMInstruction::MUL, temp, dst, new MachineOperand(*src2));
+            // n - (n / d) * d
+            auto quot = genMachineVReg();
+            cur_inst = new BinaryMInstruction(cur_block, BinaryMInstruction::DIV, quot, src1, src2);
             cur_block->InsertInst(cur_inst);
-            dst = new MachineOperand(*temp);
-            cur_inst = new BinaryMInstruction(cur_block, BinaryMInstruction::SUB, dst, new MachineOperand(*src1), temp);
+            cur_inst = new MlaMInstruction(cur_block, MlaMInstruction::MLS, dst, new MachineOperand(*quot), new MachineOperand(*src2), new MachineOperand(*src1));
             break;
         }
     default:
@@ -822,6 +1305,11 @@ void SingleInstruction::genMachineCode(AsmBuilder* builder)
     auto dst = genMachineOperand(operands[0]);
     auto src = genMachineOperand(operands[1]);
     MachineInstruction* cur_inst = nullptr;
+    if(opcode == MIN && operands[0]->isFloat())
+    {
+        cur_block->InsertInst(new VUnaryMInstruction(cur_block, VUnaryMInstruction::VNEG, dst, genMachineFloat(cur_block, src)));
+        return;
+    }
     if(src->isImm())
     {
         auto internal_reg = genMachineVReg();
@@ -865,6 +1353,27 @@ void ConverInstruction::genMachineCode(AsmBuilder* builder)
     auto cur_block = builder->getBlock();
     auto dst = genMachineOperand(operands[0]);
     auto src = genMachineOperand(operands[1]);
+    // vcvt converts within the VFP registers, vmov crosses over
+    if (mode == ITOF)
+    {
+        if (src->isImm())
+        {
+            auto internal_reg = genMachineVReg();
+            cur_block->InsertInst(new LoadMInstruction(cur_block, internal_reg, src));
+            src = new MachineOperand(*internal_reg);
+        }
+        auto temp = genMachineVReg(true);
+        cur_block->InsertInst(new MovMInstruction(cur_block, MovMInstruction::MOV, temp, src));
+        cur_block->InsertInst(new VUnaryMInstruction(cur_block, VUnaryMInstruction::S2F, dst, new MachineOperand(*temp)));
+        return;
+    }
+    if (mode == FTOI)
+    {
+        auto temp = genMachineVReg(true);
+        cur_block->InsertInst(new VUnaryMInstruction(cur_block, VUnaryMInstruction::F2S, temp, genMachineFloat(cur_block, src)));
+        cur_block->InsertInst(new MovMInstruction(cur_block, MovMInstruction::MOV, dst, new MachineOperand(*temp)));
+        return;
+    }
     //std::cout<<src->isVReg()<<std::endl;
     auto cur_inst =new MovMInstruction(cur_block, MovMInstruction::MOV, dst, src);
     cur_block->InsertInst(cur_inst);
@@ -876,51 +1385,112 @@ void CallInstruction::genMachineCode(AsmBuilder* builder)
     auto cur_block = builder->getBlock();
     MachineOperand* operand;  
     MachineInstruction* cur_inst;
-    int index = 0;
-    long unsigned int i = 1;
-    while(i != operands.size()) 
+    // floats go in s0-s15, the first four others in r0-r3, the rest on the stack
+    std::vector<MachineOperand*> stack_args;
+    int ints = 0, floats = 0;
+    for (long unsigned int i = 1; i < operands.size(); i++)
     {
-        if (index == 4)
-        {
-            break;
-        }
-        if (genMachineOperand(operands[index+1])->isImm()) 
-        {
-            cur_block->InsertInst(new LoadMInstruction(cur_block, genMachineReg(index), genMachineOperand(operands[index+1])));
-        } 
+        operand = genMachineOperand(operands[i]);
+        if (operands[i]->isFloat())
+            cur_block->InsertInst(new MovMInstruction(cur_block, MovMInstruction::MOV, genMachineReg(floats++, true), genMachineFloat(cur_block, operand)));
+        else if (ints == 4)
+            stack_args.push_back(operand);
+        else if (operand->isImm()) 
+            cur_block->InsertInst(new LoadMInstruction(cur_block, genMachineReg(ints++), operand));
         else
-        {
-            cur_block->InsertInst(new MovMInstruction(cur_block, MovMInstruction::MOV, genMachineReg(index), genMachineOperand(operands[index+1])));
-        }
-        index++;
-        i++;
+            cur_block->InsertInst(new MovMInstruction(cur_block, MovMInstruction::MOV, genMachineReg(ints++), operand));
     }
-    for (int i = operands.size() - 1; i >= 5; i--) 
+    for (auto it = stack_args.rbegin(); it != stack_args.rend(); it++) 
     {
-        operand = genMachineOperand(operands[i]);
+        operand = *it;
         if (operand->isImm()) 
         {
             auto temp_reg = genMachineVReg();
             cur_inst = new LoadMInstruction(cur_block, temp_reg, operand);
             cur_block->InsertInst(cur_inst);
-            operand = genMachineVReg();
+            operand = new MachineOperand(*temp_reg);
         }
         std::vector<MachineOperand*> temp;
         cur_block->InsertInst(new StackMInstrcuton(cur_block, StackMInstrcuton::PUSH, temp, operand));
     }
+    if (tail)
+    {
+        // sibling call: release the frame and jump, the callee returns to our caller.
+        cur_block->InsertInst(new MovMInstruction(cur_block, MovMInstruction::MOV, genMachineReg(13), genMachineReg(11)));
+        cur_block->InsertInst(new BranchMInstruction(cur_block, BranchMInstruction::B, new MachineOperand(func->toStr().c_str())));
+        return;
+    }
     cur_inst = new BranchMInstruction(cur_block, BranchMInstruction::BL, new MachineOperand(func->toStr().c_str()));
     cur_block->InsertInst(cur_inst);
-    if (operands.size() > 5) 
+    if (!stack_args.empty()) 
     {
         auto sp = genMachineReg(13); 
-        cur_inst = new BinaryMInstruction(cur_block, BinaryMInstruction::ADD,sp, sp, genMachineImm((operands.size() - 5) * 4));
+        cur_inst = new BinaryMInstruction(cur_block, BinaryMInstruction::ADD,sp, sp, genMachineImm(stack_args.size() * 4));
         cur_block->InsertInst(cur_inst);
     }
     if (dst) 
     {
-        cur_inst = new MovMInstruction(cur_block, MovMInstruction::MOV, genMachineOperand(dst), genMachineReg(0));
+        cur_inst = new MovMInstruction(cur_block, MovMInstruction::MOV, genMachineOperand(dst), genMachineReg(0, dst->isFloat()));
         cur_block->InsertInst(cur_inst);
     }
 
 
 }
+
+VectorInstruction::VectorInstruction(unsigned opcode, int qd, int qa, int qb, Operand *src, BasicBlock *insert_bb) : Instruction(VECTOR, insert_bb)
+{
+    this->opcode = opcode;
+    this->qd = qd;
+    this->qa = qa;
+    this->qb = qb;
+    if (src)
+    {
+        operands.push_back(src);
+        src->addUse(this);
+    }
+}
+
+VectorInstruction::~VectorInstruction()
+{
+    if (!operands.empty())
+        operands[0]->removeUse(this);
+}
+
+void VectorInstruction::output() const
+{
+    static const char *op[] = {"", "", "add", "sub", "mul"};
+    switch (opcode)
+    {
+    case LOAD:
+        fprintf(yyout, "  %%q%d = load <4 x i32>, <4 x i32>* %s, align 4\n", qd, operands[0]->toStr().c_str());
+        break;
+    case STORE:
+        fprintf(yyout, "  store <4 x i32> %%q%d, <4 x i32>* %s, align 4\n", qd, operands[0]->toStr().c_str());
+        break;
+    case DUP:
+        fprintf(yyout, "  %%q%d = splat <4 x i32> %s\n", qd, operands[0]->toStr().c_str());
+        break;
+    default:
+        fprintf(yyout, "  %%q%d = %s <4 x i32> %%q%d, %%q%d\n", qd, op[opcode], qa, qb);
+        break;
+    }
+}
+
+void VectorInstruction::genMachineCode(AsmBuilder* builder)
+{
+    static const int op[] = {VectorMInstruction::VLD1, VectorMInstruction::VST1, VectorMInstruction::VADD,
+                             VectorMInstruction::VSUB, VectorMInstruction::VMUL, VectorMInstruction::VDUP};
+    auto cur_block = builder->getBlock();
+    MachineOperand *src = nullptr;
+    if (!operands.empty())
+    {
+        src = genMachineOperand(operands[0]);
+        if (src->isImm())
+        {
+            auto internal_reg = genMachineVReg();
+            cur_block->InsertInst(new LoadMInstruction(cur_block, internal_reg, src));
+            src = new MachineOperand(*internal_reg);
+        }
+    }
+    cur_block->InsertInst(new VectorMInstruction(cur_block, op[opcode], qd, qa, qb, src));
+}
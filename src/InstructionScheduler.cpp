@@ -0,0 +1,341 @@
+#include "InstructionScheduler.h"
+#include "MachineCode.h"
+#include <map>
+#include <set>
+
+// two integer pipes, one multi-cycle pipe, one load and one store pipe,
+// and two FP/NEON pipes
+const int InstructionScheduler::ports[NUM_PORTS] = {2, 1, 1, 1, 2};
+
+void InstructionScheduler::pass()
+{
+    for (auto &func : unit->getFuncs())
+    {
+        this->func = func;
+        for (auto &block : func->getBlocks())
+            pass(block);
+    }
+}
+
+// result latencies from the cortex-a72 software optimization guide, the
+// worst case for sdiv and vdiv
+int InstructionScheduler::latency(MachineInstruction *inst)
+{
+    auto &defs = inst->getDef(), &uses = inst->getUse();
+    if (inst->isLoad() && uses[0]->isImm())
+        return 1;
+    if (inst->isLoad() && uses[0]->isLabel())
+        return 2;
+    if (inst->isLoad())
+        return defs[0]->isFloat() ? 5 : 4;
+    if (inst->isStore())
+        return 1;
+    if (inst->isMov())
+        return defs[0]->isFloat() != uses[0]->isFloat() ? 5 : defs[0]->isFloat() ? 3 : 1;
+    if (inst->isCmp())
+        return uses[0]->isFloat() ? 4 : 1;
+    if (inst->isVector())
+    {
+        switch (inst->getOp())
+        {
+        case VectorMInstruction::VLD1:
+            return 5;
+        case VectorMInstruction::VST1:
+            return 1;
+        case VectorMInstruction::VMUL:
+            return 4;
+        case VectorMInstruction::VDUP:
+            return 8;
+        default:
+            return 3;
+        }
+    }
+    if (dynamic_cast<MlaMInstruction *>(inst))
+        return 3;
+    if (dynamic_cast<VUnaryMInstruction *>(inst))
+        return 3;
+    if (inst->isBinary())
+    {
+        switch (inst->getOp())
+        {
+        case BinaryMInstruction::MUL:
+        case BinaryMInstruction::SMMUL:
+            return 3;
+        case BinaryMInstruction::DIV:
+            return 12;
+        case BinaryMInstruction::VADD:
+        case BinaryMInstruction::VSUB:
+        case BinaryMInstruction::VMUL:
+            return 4;
+        case BinaryMInstruction::VDIV:
+            return 11;
+        default:
+            return uses[1]->isShifted() ? 2 : 1;
+        }
+    }
+    return 1;
+}
+
+int InstructionScheduler::port(MachineInstruction *inst)
+{
+    auto &defs = inst->getDef(), &uses = inst->getUse();
+    if (inst->isLoad())
+        return uses[0]->isImm() || uses[0]->isLabel() ? ALU : LOAD;
+    if (inst->isStore())
+        return STORE;
+    if (inst->isVector())
+        return inst->getOp() == VectorMInstruction::VLD1 ? LOAD : inst->getOp() == VectorMInstruction::VST1 ? STORE : FP;
+    if (dynamic_cast<MlaMInstruction *>(inst))
+        return MUL;
+    if (dynamic_cast<VUnaryMInstruction *>(inst))
+        return FP;
+    if (inst->isBinary())
+    {
+        int op = inst->getOp();
+        if (op == BinaryMInstruction::MUL || op == BinaryMInstruction::DIV || op == BinaryMInstruction::SMMUL)
+            return MUL;
+        return op >= BinaryMInstruction::VADD ? FP : ALU;
+    }
+    if ((inst->isMov() || inst->isCmp()) && ((!defs.empty() && defs[0]->isFloat()) || uses[0]->isFloat()))
+        return FP;
+    return ALU;
+}
+
+bool InstructionScheduler::isMemory(MachineInstruction *inst)
+{
+    if (inst->isLoad())
+        return !inst->getUse()[0]->isImm() && !inst->getUse()[0]->isLabel();
+    if (inst->isVector())
+        return inst->getOp() == VectorMInstruction::VLD1 || inst->getOp() == VectorMInstruction::VST1;
+    return inst->isStore();
+}
+
+bool InstructionScheduler::writesMemory(MachineInstruction *inst)
+{
+    return inst->isStore() || (inst->isVector() && inst->getOp() == VectorMInstruction::VST1);
+}
+
+// only word accesses to different frame slots are told apart
+bool InstructionScheduler::mayAlias(MachineInstruction *a, MachineInstruction *b)
+{
+    if (a->isVector() || b->isVector())
+        return true;
+    auto slot = [](MachineInstruction *inst, int &offset) {
+        auto &uses = inst->getUse();
+        size_t base = inst->isStore() ? 1 : 0;
+        if (!uses[base]->isReg() || uses[base]->getReg() != 11)
+            return false;
+        offset = uses.size() > base + 1 ? (uses[base + 1]->isImm() ? uses[base + 1]->getVal() : -1) : 0;
+        return uses.size() == base + 1 || uses[base + 1]->isImm();
+    };
+    int offsetA, offsetB;
+    return !slot(a, offsetA) || !slot(b, offsetB) || offsetA == offsetB;
+}
+
+// Calls, pushes, branches and writes to sp stay in place and split the
+// block into regions; frame slots below sp are not safe to touch. With
+// more than four parameters, MachineBlock::output reloads r0 in front of
+// each store of r0, counting them in order.
+bool InstructionScheduler::isBarrier(MachineInstruction *inst)
+{
+    if (inst->isBranch() || inst->isStack())
+        return true;
+    for (auto &def : inst->getDef())
+        if (def->isReg() && def->getReg() == 13)
+            return true;
+    if (func->getParaNum() > 4 && inst->isStore())
+    {
+        MachineOperand *src = inst->getUse()[0];
+        return src->isReg() && src->getReg() == 0 && !src->isFloat();
+    }
+    return false;
+}
+
+void InstructionScheduler::pass(MachineBlock *block)
+{
+    auto &insts = block->getInsts();
+    size_t begin = 0;
+    for (size_t i = 0; i <= insts.size(); i++)
+        if (i == insts.size() || isBarrier(insts[i]))
+        {
+            if (i - begin > 1)
+                schedule(insts, begin, i);
+            begin = i + 1;
+        }
+        else if (i - begin == maxRegion)
+        {
+            schedule(insts, begin, i);
+            begin = i;
+        }
+}
+
+// Build the dependence graph of insts[begin, end) over registers, flags and
+// memory, then issue cycle by cycle the ready instruction with the longest
+// path to the end of the region, as the ports allow.
+void InstructionScheduler::schedule(std::vector<MachineInstruction *> &insts, size_t begin, size_t end)
+{
+    std::vector<Node> nodes(end - begin);
+    std::map<MachineOperand, Node *> lastDef;
+    std::map<MachineOperand, std::vector<Node *>> lastUses;
+    Node *flagsDef = nullptr, *lastVector = nullptr;
+    std::vector<Node *> flagsUses, memory;
+    auto depend = [](Node *from, Node *to, int latency) {
+        from->succs.push_back({to, latency});
+        to->preds++;
+    };
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+        Node *node = &nodes[i];
+        MachineInstruction *inst = insts[begin + i];
+        node->inst = inst;
+        node->index = i;
+        node->latency = latency(inst);
+        node->port = port(inst);
+        bool conditional = inst->getCond() != MachineInstruction::NONE;
+
+        // a conditional instruction may leave its destination as it was
+        std::vector<MachineOperand *> uses;
+        for (auto &op : inst->getUse())
+            if (op->isReg() || op->isVReg())
+                uses.push_back(op);
+        if (conditional)
+            uses.insert(uses.end(), inst->getDef().begin(), inst->getDef().end());
+        for (auto &use : uses)
+            if (lastDef.count(*use))
+                depend(lastDef[*use], node, lastDef[*use]->latency);
+        for (auto &def : inst->getDef())
+        {
+            if (lastDef.count(*def))
+                depend(lastDef[*def], node, 1);
+            for (auto &reader : lastUses[*def])
+                if (reader != node)
+                    depend(reader, node, 0);
+        }
+        if (conditional && flagsDef)
+            depend(flagsDef, node, flagsDef->latency);
+        if (inst->isCmp())
+        {
+            if (flagsDef)
+                depend(flagsDef, node, 1);
+            for (auto &reader : flagsUses)
+                depend(reader, node, 0);
+        }
+        if (isMemory(inst))
+        {
+            bool store = writesMemory(inst);
+            for (auto &other : memory)
+            {
+                bool otherStore = writesMemory(other->inst);
+                if ((store || otherStore) && mayAlias(other->inst, inst))
+                    depend(other, node, otherStore ? other->latency : 0);
+            }
+            memory.push_back(node);
+        }
+        // q registers are not operands, NEON code keeps its order
+        if (inst->isVector())
+        {
+            if (lastVector)
+                depend(lastVector, node, lastVector->latency);
+            lastVector = node;
+        }
+
+        for (auto &use : uses)
+            lastUses[*use].push_back(node);
+        for (auto &def : inst->getDef())
+        {
+            lastDef[*def] = node;
+            lastUses[*def].clear();
+        }
+        if (inst->isCmp())
+        {
+            flagsDef = node;
+            flagsUses.clear();
+        }
+        if (conditional)
+            flagsUses.push_back(node);
+    }
+
+    for (size_t i = nodes.size(); i-- > 0;)
+    {
+        nodes[i].height = nodes[i].latency;
+        for (auto &succ : nodes[i].succs)
+            nodes[i].height = std::max(nodes[i].height, succ.second + succ.first->height);
+    }
+
+    // Before allocation, hoisting by height alone can keep more vregs live
+    // than there are registers for them. Once the live vregs of a class come
+    // close to its registers, the ready instruction that grows them least is
+    // taken instead, the earliest on ties. Vregs read before the region
+    // defines them are live from its start.
+    std::map<MachineOperand, int> usesLeft;
+    std::set<MachineOperand> live, defined;
+    int pressure[2] = {0, 0};
+    for (auto &node : nodes)
+    {
+        for (auto &use : node.inst->getUse())
+            if (use->isVReg())
+            {
+                usesLeft[*use]++;
+                if (!defined.count(*use) && live.insert(*use).second)
+                    pressure[use->isFloat()]++;
+            }
+        for (auto &def : node.inst->getDef())
+            if (def->isVReg())
+                defined.insert(*def);
+    }
+
+    std::vector<Node *> ready;
+    for (auto &node : nodes)
+        if (node.preds == 0)
+            ready.push_back(&node);
+    size_t next = begin;
+    for (int cycle = 0; next < end; cycle++)
+    {
+        int used[NUM_PORTS] = {0};
+        for (int issued = 0; issued < issueWidth; issued++)
+        {
+            bool tight = pressure[0] >= intRegs - 1 || pressure[1] >= floatRegs - 1;
+            auto best = ready.end();
+            int bestGrowth = 0;
+            for (auto it = ready.begin(); it != ready.end(); it++)
+                if (tight)
+                {
+                    int growth = 0;
+                    for (auto &use : (*it)->inst->getUse())
+                        if (use->isVReg() && usesLeft[*use] == 1 && live.count(*use))
+                            growth--;
+                    for (auto &def : (*it)->inst->getDef())
+                        if (def->isVReg() && !live.count(*def))
+                            growth++;
+                    if (best == ready.end() || growth < bestGrowth ||
+                        (growth == bestGrowth && (*it)->index < (*best)->index))
+                    {
+                        best = it;
+                        bestGrowth = growth;
+                    }
+                }
+                else if ((*it)->earliest <= cycle && used[(*it)->port] < ports[(*it)->port] &&
+                    (best == ready.end() || (*it)->height > (*best)->height ||
+                     ((*it)->height == (*best)->height && (*it)->index < (*best)->index)))
+                    best = it;
+            if (best == ready.end())
+                break;
+            Node *node = *best;
+            ready.erase(best);
+            used[node->port]++;
+            insts[next++] = node->inst;
+            for (auto &use : node->inst->getUse())
+                if (use->isVReg() && --usesLeft[*use] == 0 && live.erase(*use))
+                    pressure[use->isFloat()]--;
+            for (auto &def : node->inst->getDef())
+                if (def->isVReg() && live.insert(*def).second)
+                    pressure[def->isFloat()]++;
+            for (auto &succ : node->succs)
+            {
+                succ.first->earliest = std::max(succ.first->earliest, cycle + succ.second);
+                if (--succ.first->preds == 0)
+                    ready.push_back(succ.first);
+            }
+        }
+    }
+}
@@ -1,7 +1,9 @@
 #include <algorithm>
+#include <functional>
+#include <cmath>
+#include <cstdio>
 #include "LinearScan.h"
 #include "MachineCode.h"
-#include "LiveVariableAnalysis.h"
 
 LinearScan::LinearScan(MachineUnit *unit)
 {
@@ -15,6 +17,11 @@ void LinearScan::allocateRegisters()
     for (auto &f : unit->getFuncs())
     {
         func = f;
+        findLoops();
+        loopReloads.clear();
+        blockReloads.clear();
+        spillCode.clear();
+        split.clear();
         bool success;
         success = false;
         while (!success)        // repeat until all vregs can be mapped
@@ -29,133 +36,150 @@ void LinearScan::allocateRegisters()
     }
 }
 
-void LinearScan::makeDuChains()
+// Liveness of the vregs of func as bit vectors over their indices, found
+// by iterating the blocks backwards until nothing changes.
+void LinearScan::computeLiveness(std::map<MachineOperand, int> &index)
 {
-    LiveVariableAnalysis lva;
-    lva.pass(func);
-    du_chains.clear();
-    int i = 0;
-    std::map<MachineOperand, std::set<MachineOperand *>> liveVar;
-    for (auto &bb : func->getBlocks())
+    size_t words = (index.size() + 63) / 64;
+    liveIn.clear();
+    liveOut.clear();
+    std::map<MachineBlock *, BitVector> gen, kill;
+    for (auto &block : func->getBlocks())
     {
-        liveVar.clear();
-        for (auto &t : bb->getLiveOut())
-            liveVar[*t].insert(t);
-        int no;
-        no = i = bb->getInsts().size() + i;
-        for (auto inst = bb->getInsts().rbegin(); inst != bb->getInsts().rend(); inst++)
+        BitVector &g = gen[block], &k = kill[block];
+        g.assign(words, 0);
+        k.assign(words, 0);
+        liveIn[block].assign(words, 0);
+        liveOut[block].assign(words, 0);
+        for (auto &inst : block->getInsts())
         {
-            (*inst)->setNo(no--);
-            for (auto &def : (*inst)->getDef())
-            {
+            for (auto &use : inst->getUse())
+                if (use->isVReg())
+                {
+                    int i = index[*use];
+                    if (!(k[i / 64] >> (i % 64) & 1))
+                        g[i / 64] |= 1ull << (i % 64);
+                }
+            for (auto &def : inst->getDef())
                 if (def->isVReg())
                 {
-                    auto &uses = liveVar[*def];
-                    du_chains[def].insert(uses.begin(), uses.end());
-                    auto &kill = lva.getAllUses()[*def];
-                    std::set<MachineOperand *> res;
-                    set_difference(uses.begin(), uses.end(), kill.begin(), kill.end(), inserter(res, res.end()));
-                    liveVar[*def] = res;
+                    int i = index[*def];
+                    k[i / 64] |= 1ull << (i % 64);
                 }
-            }
-            for (auto &use : (*inst)->getUse())
+        }
+    }
+    bool change = true;
+    while (change)
+    {
+        change = false;
+        for (auto it = func->getBlocks().rbegin(); it != func->getBlocks().rend(); it++)
+        {
+            MachineBlock *block = *it;
+            BitVector &out = liveOut[block], &in = liveIn[block];
+            for (auto &succ : block->getSuccs())
+                for (size_t w = 0; w < words; w++)
+                    out[w] |= liveIn[succ][w];
+            for (size_t w = 0; w < words; w++)
             {
-                if (use->isVReg())
-                    liveVar[*use].insert(use);
+                uint64_t bits = gen[block][w] | (out[w] & ~kill[block][w]);
+                change = change || bits != in[w];
+                in[w] = bits;
             }
         }
     }
 }
 
+// One interval per vreg, spill code giving every reload a vreg of its own.
+// With the instructions numbered in block order, a backward pass over each
+// block closes a segment at each def and opens one at a use, starting from
+// the vregs live out; segments come out sorted and adjacent ones are joined.
 void LinearScan::computeLiveIntervals()
 {
-    makeDuChains();
     intervals.clear();
-    for (auto &du_chain : du_chains)
-    {
-        int t = -1;
-        for (auto &use : du_chain.second)
-            t = std::max(t, use->getParent()->getNo());
-        Interval *interval = new Interval({du_chain.first->getParent()->getNo(), t, false, 0, 0, {du_chain.first}, du_chain.second});
-        intervals.push_back(interval);
-    }
-    for (auto& interval : intervals) {
-        auto uses = interval->uses;
-        auto begin = interval->start;
-        auto end = interval->end;
-        for (auto block : func->getBlocks()) {
-            auto liveIn = block->getLiveIn();
-            auto liveOut = block->getLiveOut();
-            bool in = false;
-            bool out = false;
-            for (auto use : uses)
-                if (liveIn.count(use)) {
-                    in = true;
-                    break;
-                }
-            for (auto use : uses)
-                if (liveOut.count(use)) {
-                    out = true;
-                    break;
-                }
-            if (in && out) {
-                begin = std::min(begin, (*(block->begin()))->getNo());
-                end = std::max(end, (*(block->rbegin()))->getNo());
-            } else if (!in && out) {
-                for (auto i : block->getInsts())
-                    if (i->getDef().size() > 0 &&
-                        i->getDef()[0] == *(uses.begin())) {
-                        begin = std::min(begin, i->getNo());
-                        break;
+    std::map<MachineOperand, int> index;
+    int no = 0;
+    for (auto &block : func->getBlocks())
+        for (auto &inst : block->getInsts())
+        {
+            inst->setNo(++no);
+            for (auto &ops : {inst->getDef(), inst->getUse()})
+                for (auto &op : ops)
+                    if (op->isVReg() && !index.count(*op))
+                    {
+                        index[*op] = intervals.size();
+                        Interval *interval = new Interval();
+                        interval->fpu = op->isFloat();
+                        intervals.push_back(interval);
                     }
-                end = std::max(end, (*(block->rbegin()))->getNo());
-            } else if (in && !out) {
-                begin = std::min(begin, (*(block->begin()))->getNo());
-                int temp = 0;
-                for (auto use : uses)
-                    if (use->getParent()->getParent() == block)
-                        temp = std::max(temp, use->getParent()->getNo());
-                end = std::max(temp, end);
-            }
         }
-        interval->start = begin;
-        interval->end = end;
-    }
-    bool change;
-    change = true;
-    while (change)
+    computeLiveness(index);
+
+    std::vector<int> open(intervals.size(), -1);   // end of the segment being built
+    for (auto it = func->getBlocks().rbegin(); it != func->getBlocks().rend(); it++)
     {
-        change = false;
-        std::vector<Interval *> t(intervals.begin(), intervals.end());
-        for (size_t i = 0; i < t.size(); i++)
-            for (size_t j = i + 1; j < t.size(); j++)
-            {
-                Interval *w1 = t[i];
-                Interval *w2 = t[j];
-                if (**w1->defs.begin() == **w2->defs.begin())
+        MachineBlock *block = *it;
+        auto &insts = block->getInsts();
+        if (insts.empty())
+            continue;
+        int first = insts.front()->getNo(), last = insts.back()->getNo();
+        BitVector &out = liveOut[block], &in = liveIn[block];
+        for (size_t w = 0; w < out.size(); w++)
+            for (uint64_t bits = out[w]; bits; bits &= bits - 1)
+                open[w * 64 + __builtin_ctzll(bits)] = last;
+        for (auto inst = insts.rbegin(); inst != insts.rend(); inst++)
+        {
+            int at = (*inst)->getNo();
+            for (auto &def : (*inst)->getDef())
+                if (def->isVReg())
                 {
-                    std::set<MachineOperand *> temp;
-                    set_intersection(w1->uses.begin(), w1->uses.end(), w2->uses.begin(), w2->uses.end(), inserter(temp, temp.end()));
-                    if (!temp.empty())
-                    {
-                        change = true;
-                        w1->defs.insert(w2->defs.begin(), w2->defs.end());
-                        w1->uses.insert(w2->uses.begin(), w2->uses.end());
-                        // w1->start = std::min(w1->start, w2->start);
-                        // w1->end = std::max(w1->end, w2->end);
-                        auto w1Min = std::min(w1->start, w1->end);
-                        auto w1Max = std::max(w1->start, w1->end);
-                        auto w2Min = std::min(w2->start, w2->end);
-                        auto w2Max = std::max(w2->start, w2->end);
-                        w1->start = std::min(w1Min, w2Min);
-                        w1->end = std::max(w1Max, w2Max);
-                        auto it = std::find(intervals.begin(), intervals.end(), w2);
-                        if (it != intervals.end())
-                            intervals.erase(it);
-                    }
+                    int i = index[*def];
+                    intervals[i]->defs.insert(def);
+                    intervals[i]->segments.push_back({at, open[i] < 0 ? at : open[i]});
+                    open[i] = -1;
                 }
+            for (auto &use : (*inst)->getUse())
+                if (use->isVReg())
+                {
+                    int i = index[*use];
+                    intervals[i]->uses.insert(use);
+                    if (open[i] < 0)
+                        open[i] = at;
+                }
+        }
+        for (size_t w = 0; w < in.size(); w++)
+            for (uint64_t bits = in[w]; bits; bits &= bits - 1)
+            {
+                int i = w * 64 + __builtin_ctzll(bits);
+                intervals[i]->segments.push_back({first, open[i]});
+                open[i] = -1;
             }
     }
+
+    for (auto &interval : intervals)
+    {
+        // collected backwards
+        auto &segments = interval->segments;
+        std::reverse(segments.begin(), segments.end());
+        size_t n = 0;
+        for (size_t i = 1; i < segments.size(); i++)
+            if (segments[i].first <= segments[n].second + 1)
+                segments[n].second = std::max(segments[n].second, segments[i].second);
+            else
+                segments[++n] = segments[i];
+        segments.resize(n + 1);
+        interval->start = segments.front().first;
+        interval->end = segments.back().second;
+        if (unspillable(interval))
+        {
+            interval->weight = HUGE_VAL;
+            continue;
+        }
+        for (auto &def : interval->defs)
+            interval->weight += std::pow(10, depth[def->getParent()->getParent()]);
+        for (auto &use : interval->uses)
+            interval->weight += std::pow(10, depth[use->getParent()->getParent()]);
+        interval->weight /= std::sqrt(interval->end - interval->start + 1);
+    }
     sort(intervals.begin(), intervals.end(), compareStart);
 }
 
@@ -167,19 +191,24 @@ bool LinearScan::linearScanRegisterAllocation()
     regs.clear();
     for (int i = 4; i < 11; i++)
         regs.push_back(i);
+    // floats get the callee saved s16-s31, calls clobber s0-s15
+    fregs.clear();
+    for (int i = 16; i < 32; i++)
+        fregs.push_back(i);
     for (auto& i : intervals) 
     {
         expireOldIntervals(i);
+        auto &pool = i->fpu ? fregs : regs;
         
-        if (regs.empty())
+        if (pool.empty())
         {
             spillAtInterval(i);
             success = false;
         } 
         else 
         {
-            i->rreg = regs.front();
-            regs.erase(regs.begin());
+            i->rreg = pool.front();
+            pool.erase(pool.begin());
             active.push_back(i);
             sort(active.begin(), active.end(), compareEnd);
         }
@@ -191,7 +220,10 @@ void LinearScan::modifyCode()
 {
     for (auto &interval : intervals)
     {
-        func->addSavedRegs(interval->rreg);
+        if (interval->fpu)
+            func->addSavedFRegs(interval->rreg);
+        else
+            func->addSavedRegs(interval->rreg);
         for (auto def : interval->defs)
             def->setReg(interval->rreg);
         for (auto use : interval->uses)
@@ -201,34 +233,337 @@ void LinearScan::modifyCode()
 
 void LinearScan::genSpillCode()
 {
+    computePressure();
     for(auto &interval:intervals)
     {
         if(!interval->spill)
             continue;
+        countSpill(interval);
         // TODO
         /* HINT:
          * The vreg should be spilled to memory.
          * 1. insert ldr inst before the use of vreg
          * 2. insert str inst after the def of vreg
          */ 
+        MachineInstruction *def = (*interval->defs.begin())->getParent();
+        if (interval->defs.size() == 1 && loopReloads.count(def))
+        {
+            // the loop is too crowded, reload per block in it instead
+            reloadPerBlock(interval, interval->uses, def->getUse()[1]->getVal());
+            remove(def);
+            continue;
+        }
+        // a constant, an address or a block's reload is computed again in front of each use
+        if (interval->defs.size() == 1 && (isRematerializable(def) || blockReloads.count(def)))
+        {
+            for (auto use : interval->uses)
+            {
+                MachineOperand *temp = freshVReg(use);
+                auto inst = rematerialize(def, use->getParent()->getParent(), temp);
+                use->getParent()->insertBefore(inst);
+                spillCode.insert(inst);
+                rename(use, temp);
+            }
+            remove(def);
+            continue;
+        }
         interval->disp = -func->AllocSpace(4);
         auto off = new MachineOperand(MachineOperand::IMM, interval->disp);
         auto fp = new MachineOperand(MachineOperand::REG, 11);
-        for (auto use : interval->uses) 
-        {
-            MachineOperand* temp = new MachineOperand(*use);
-            auto inst = new LoadMInstruction(use->getParent()->getParent(), temp, fp, off);
-            use->getParent()->insertBefore(inst);
-        }
         for (auto def : interval->defs) 
         {
             MachineOperand* temp = new MachineOperand(*def);
             auto inst = new StoreMInstruction(def->getParent()->getParent(), temp, fp, off);
             def->getParent()->insertAfter(inst);
+            spillCode.insert(inst);
+        }
+        // the first spill of a vreg splits it, a part spilled again reloads at each use
+        int vreg = (*interval->defs.begin())->getReg();
+        if (!split.count(vreg))
+        {
+            split.insert(vreg);
+            reloadPerBlock(interval, reloadPerLoop(interval), interval->disp);
+            continue;
+        }
+        for (auto use : interval->uses) 
+        {
+            auto inst = reload(use->getParent()->getParent(), use, interval->disp);
+            use->getParent()->insertBefore(inst);
+            spillCode.insert(inst);
+            rename(use, inst->getDef()[0]);
         }
     }
 }
 
+// the most intervals of each class live at once in each loop, the spilled
+// ones among them
+void LinearScan::computePressure()
+{
+    int n = 0;
+    for (auto &block : func->getBlocks())
+        n += block->getInsts().size();
+    std::vector<int> live[2];
+    for (int fpu = 0; fpu < 2; fpu++)
+        live[fpu].assign(n + 2, 0);
+    for (auto &interval : intervals)
+        for (auto &segment : interval->segments)
+        {
+            live[interval->fpu][segment.first]++;
+            live[interval->fpu][segment.second + 1]--;
+        }
+    for (int fpu = 0; fpu < 2; fpu++)
+        for (int i = 1; i < n + 2; i++)
+            live[fpu][i] += live[fpu][i - 1];
+    for (auto &loop : loops)
+        for (int fpu = 0; fpu < 2; fpu++)
+        {
+            loop.pressure[fpu] = 0;
+            for (auto &block : loop.blocks)
+                for (auto &inst : block->getInsts())
+                    loop.pressure[fpu] = std::max(loop.pressure[fpu], live[fpu][inst->getNo()]);
+        }
+}
+
+// The uses in a loop that never defines the vreg read a single reload in
+// the preheader, giving the loop its own interval; the other uses are
+// returned.
+std::set<MachineOperand *> LinearScan::reloadPerLoop(Interval *interval)
+{
+    MachineOperand *vreg = *interval->defs.begin();
+    std::set<MachineOperand *> rest = interval->uses;
+    for (auto &loop : loops)
+    {
+        std::vector<MachineOperand *> inside;
+        for (auto &use : rest)
+            if (loop.blocks.count(use->getParent()->getParent()))
+                inside.push_back(use);
+        if (loop.preheader == nullptr || inside.empty() || loop.pressure[interval->fpu] >= (interval->fpu ? 16 : 7))
+            continue;
+        bool defined = false;
+        for (auto &def : interval->defs)
+            defined = defined || loop.blocks.count(def->getParent()->getParent());
+        if (defined)
+            continue;
+        auto &insts = loop.preheader->getInsts();
+        auto it = insts.end();
+        while (it != insts.begin() && (*(it - 1))->isBranch())
+            it--;
+        auto inst = reload(loop.preheader, vreg, interval->disp);
+        insts.insert(it, inst);
+        loopReloads.insert(inst);
+        for (auto &use : inside)
+        {
+            rename(use, inst->getDef()[0]);
+            rest.erase(use);
+        }
+    }
+    return rest;
+}
+
+// Reload in front of the first of uses in each block, unless the block
+// defines the vreg before; the uses close after it read the same register.
+// Only the stretch of a block from its first def or use to its last use is
+// walked.
+void LinearScan::reloadPerBlock(Interval *interval, const std::set<MachineOperand *> &uses, int disp)
+{
+    MachineOperand *vreg = *interval->defs.begin();
+    std::set<MachineInstruction *> readers, definers;
+    std::map<MachineBlock *, int> blocks;   // readers left in each block
+    for (auto &use : uses)
+        if (readers.insert(use->getParent()).second)
+            blocks[use->getParent()->getParent()]++;
+    for (auto &def : interval->defs)
+        definers.insert(def->getParent());
+    for (auto &it : blocks)
+    {
+        MachineBlock *block = it.first;
+        auto &insts = block->getInsts();
+        int last = -1;                      // the last instruction with the value in a register
+        MachineOperand *current = nullptr;  // the register, nullptr after a def of vreg
+        int i = std::find_if(insts.begin(), insts.end(), [&](MachineInstruction *inst) {
+            return readers.count(inst) || definers.count(inst);
+        }) - insts.begin();
+        for (int left = it.second; left > 0; i++)
+        {
+            if (readers.count(insts[i]))
+            {
+                left--;
+                std::vector<MachineOperand *> reads;
+                for (auto &use : insts[i]->getUse())
+                    if (uses.count(use))
+                        reads.push_back(use);
+                if (last < 0 || i - last > reuseDistance)
+                {
+                    auto inst = reload(block, vreg, disp);
+                    insts.insert(insts.begin() + i++, inst);
+                    blockReloads.insert(inst);
+                    current = inst->getDef()[0];
+                }
+                last = i;
+                if (current != nullptr)
+                    for (auto &use : reads)
+                        rename(use, current);
+            }
+            if (definers.count(insts[i]))
+            {
+                last = i;
+                current = nullptr;
+            }
+        }
+    }
+}
+
+// a vreg of the class of vreg that nothing uses yet
+MachineOperand *LinearScan::freshVReg(MachineOperand *vreg)
+{
+    return new MachineOperand(MachineOperand::VREG, SymbolTable::getLabel(), vreg->isFloat());
+}
+
+// use reads vreg instead, keeping its shift
+void LinearScan::rename(MachineOperand *use, MachineOperand *vreg)
+{
+    MachineInstruction *inst = use->getParent();
+    MachineOperand *temp = new MachineOperand(*use);
+    temp->setVReg(vreg->getReg());
+    std::replace(inst->getUse().begin(), inst->getUse().end(), use, temp);
+}
+
+MachineInstruction *LinearScan::reload(MachineBlock *block, MachineOperand *vreg, int disp)
+{
+    return new LoadMInstruction(block, freshVReg(vreg), new MachineOperand(MachineOperand::REG, 11), new MachineOperand(MachineOperand::IMM, disp));
+}
+
+void LinearScan::remove(MachineInstruction *inst)
+{
+    auto &insts = inst->getParent()->getInsts();
+    insts.erase(std::find(insts.begin(), insts.end(), inst));
+}
+
+// Natural loops of the retreating edges met by a depth first search, the
+// CFG being reducible. A loop entered from a single block that only jumps
+// to its header has that block as preheader.
+void LinearScan::findLoops()
+{
+    loops.clear();
+    std::map<MachineBlock *, std::vector<MachineBlock *>> preds;
+    for (auto &block : func->getBlocks())
+        for (auto &succ : block->getSuccs())
+            preds[succ].push_back(block);
+    std::map<MachineBlock *, std::set<MachineBlock *>> bodies;
+    std::set<MachineBlock *> visited, onStack;
+    std::function<void(MachineBlock *)> dfs = [&](MachineBlock *block) {
+        visited.insert(block);
+        onStack.insert(block);
+        for (auto &succ : block->getSuccs())
+        {
+            if (onStack.count(succ))
+            {
+                auto &body = bodies[succ];
+                body.insert(succ);
+                std::vector<MachineBlock *> worklist;
+                if (body.insert(block).second)
+                    worklist.push_back(block);
+                while (!worklist.empty())
+                {
+                    MachineBlock *b = worklist.back();
+                    worklist.pop_back();
+                    for (auto &pred : preds[b])
+                        if (body.insert(pred).second)
+                            worklist.push_back(pred);
+                }
+            }
+            else if (!visited.count(succ))
+                dfs(succ);
+        }
+        onStack.erase(block);
+    };
+    if (!func->getBlocks().empty())
+        dfs(func->getBlocks()[0]);
+    for (auto &body : bodies)
+    {
+        MachineBlock *preheader = nullptr;
+        int entries = 0;
+        for (auto &pred : preds[body.first])
+            if (!body.second.count(pred))
+            {
+                preheader = pred;
+                entries++;
+            }
+        if (entries != 1 || preheader->getSuccs().size() != 1)
+            preheader = nullptr;
+        loops.push_back({preheader, body.second, {0, 0}});
+    }
+    // outer loops first
+    std::sort(loops.begin(), loops.end(), [](const Loop &a, const Loop &b) { return a.blocks.size() > b.blocks.size(); });
+    depth.clear();
+    for (auto &loop : loops)
+        for (auto &block : loop.blocks)
+            depth[block]++;
+}
+
+// inst only reads constants and fp: ldr v, =imm, ldr v, addr_g, mov v, #imm
+// or add/sub v, fp, #imm
+bool LinearScan::isRematerializable(MachineInstruction *inst)
+{
+    if (inst->getCond() != MachineInstruction::NONE)
+        return false;
+    auto &uses = inst->getUse();
+    if (inst->isLoad())
+        return uses.size() == 1 && (uses[0]->isImm() || uses[0]->isLabel());
+    if (inst->isMov())
+        return uses[0]->isImm() && !uses[0]->isShifted();
+    if (inst->isBinary() && (inst->getOp() == BinaryMInstruction::ADD || inst->getOp() == BinaryMInstruction::SUB))
+        return uses[0]->isReg() && uses[0]->getReg() == 11 && uses[1]->isImm();
+    return false;
+}
+
+// a copy of a rematerializable inst, defining dst instead
+MachineInstruction *LinearScan::rematerialize(MachineInstruction *inst, MachineBlock *block, MachineOperand *dst)
+{
+    auto &uses = inst->getUse();
+    if (inst->isLoad() && uses.size() == 2)
+        return new LoadMInstruction(block, dst, new MachineOperand(*uses[0]), new MachineOperand(*uses[1]));
+    if (inst->isLoad())
+        return new LoadMInstruction(block, dst, new MachineOperand(*uses[0]));
+    if (inst->isMov())
+        return new MovMInstruction(block, inst->getOp(), dst, new MachineOperand(*uses[0]));
+    return new BinaryMInstruction(block, inst->getOp(), dst, new MachineOperand(*uses[0]), new MachineOperand(*uses[1]));
+}
+
+// Spilling gains nothing for an interval from a def right to its use, a
+// reload in front of its use or a def only kept for its spill stores.
+bool LinearScan::unspillable(Interval *interval)
+{
+    if (std::abs(interval->end - interval->start) <= 1)
+        return true;
+    if (interval->defs.size() == 1 && spillCode.count((*interval->defs.begin())->getParent()))
+        return true;
+    for (auto &use : interval->uses)
+        if (!spillCode.count(use->getParent()))
+            return false;
+    return true;
+}
+
+void LinearScan::countSpill(Interval *interval)
+{
+    auto &count = spills[func];
+    count.first++;
+    for (auto &ops : {interval->defs, interval->uses})
+        for (auto &op : ops)
+            if (depth[op->getParent()->getParent()] > 0)
+            {
+                count.second++;
+                return;
+            }
+}
+
+void LinearScan::report()
+{
+    for (auto &f : unit->getFuncs())
+        if (spills.count(f))
+            fprintf(stderr, "regalloc: %-26s spills %d, in loops %d\n", f->getSymPtr()->toStr().c_str() + 1, spills[f].first, spills[f].second);
+}
+
 void LinearScan::expireOldIntervals(Interval *interval)
 {
     // Todo
@@ -236,23 +571,28 @@ void LinearScan::expireOldIntervals(Interval *interval)
     while (it != active.end()) {
         if ((*it)->end >= interval->start)
             return;
-        regs.push_back((*it)->rreg);
+        auto &pool = (*it)->fpu ? fregs : regs;
+        pool.push_back((*it)->rreg);
         it = active.erase(find(active.begin(), active.end(), *it));
-        sort(regs.begin(), regs.end());
+        sort(pool.begin(), pool.end());
     }
 }
 
 void LinearScan::spillAtInterval(Interval *interval)
 {
     // Todo
-    auto spill = active.back();
-    if (spill->end > interval->end) {
-        spill->spill = true;
+    // the cheapest of the interval and the active ones of its class,
+    // among equals the one ending last
+    Interval *spill = interval;
+    for (auto &i : active)
+        if (i->fpu == interval->fpu && (i->weight < spill->weight || (i->weight == spill->weight && i->end > spill->end)))
+            spill = i;
+    spill->spill = true;
+    if (spill != interval) {
         interval->rreg = spill->rreg;
+        active.erase(std::find(active.begin(), active.end(), spill));
         active.push_back(interval);
         sort(active.begin(), active.end(), compareEnd);
-    } else {
-        interval->spill = true;
     }
 }
 
@@ -0,0 +1,255 @@
+#include <algorithm>
+#include "LoopAnalysis.h"
+#include "Function.h"
+
+LoopAnalysis::~LoopAnalysis()
+{
+    for (auto &loop : loops)
+        delete loop;
+}
+
+void LoopAnalysis::pass(Function *func)
+{
+    this->func = func;
+    for (auto &loop : loops)
+        delete loop;
+    loops.clear();
+    computeRPO();
+    computeDominators();
+    findLoops();
+}
+
+void LoopAnalysis::computeRPO()
+{
+    rpo.clear();
+    order.clear();
+    std::set<BasicBlock *> visited;
+    std::vector<std::pair<BasicBlock *, int>> stack;
+    std::vector<BasicBlock *> post;
+    stack.push_back({func->getEntry(), 0});
+    visited.insert(func->getEntry());
+    while (!stack.empty())
+    {
+        auto &top = stack.back();
+        BasicBlock *bb = top.first;
+        if (top.second < bb->getNumOfSucc())
+        {
+            BasicBlock *succ = bb->getSuccB()[top.second++];
+            if (visited.insert(succ).second)
+                stack.push_back({succ, 0});
+        }
+        else
+        {
+            post.push_back(bb);
+            stack.pop_back();
+        }
+    }
+    rpo.assign(post.rbegin(), post.rend());
+    for (size_t i = 0; i < rpo.size(); i++)
+        order[rpo[i]] = i;
+}
+
+BasicBlock *LoopAnalysis::intersect(BasicBlock *a, BasicBlock *b)
+{
+    while (a != b)
+    {
+        while (order[a] > order[b])
+            a = idom[a];
+        while (order[b] > order[a])
+            b = idom[b];
+    }
+    return a;
+}
+
+// "A Simple, Fast Dominance Algorithm", Cooper, Harvey and Kennedy.
+void LoopAnalysis::computeDominators()
+{
+    idom.clear();
+    BasicBlock *entry = func->getEntry();
+    idom[entry] = entry;
+    bool change = true;
+    while (change)
+    {
+        change = false;
+        for (auto &bb : rpo)
+        {
+            if (bb == entry)
+                continue;
+            BasicBlock *new_idom = nullptr;
+            for (auto pred = bb->pred_begin(); pred != bb->pred_end(); pred++)
+            {
+                if (!idom.count(*pred))
+                    continue;
+                new_idom = new_idom ? intersect(*pred, new_idom) : *pred;
+            }
+            if (new_idom && idom[bb] != new_idom)
+            {
+                idom[bb] = new_idom;
+                change = true;
+            }
+        }
+    }
+}
+
+bool LoopAnalysis::dominates(BasicBlock *a, BasicBlock *b)
+{
+    if (!idom.count(b))
+        return false;
+    while (b != a && idom[b] != b)
+        b = idom[b];
+    return b == a;
+}
+
+void LoopAnalysis::findLoops()
+{
+    std::map<BasicBlock *, Loop *> header2loop;
+    for (auto &bb : rpo)
+    {
+        for (auto succ = bb->succ_begin(); succ != bb->succ_end(); succ++)
+        {
+            BasicBlock *header = *succ;
+            if (!dominates(header, bb))
+                continue;
+            // back edge bb -> header, collect the natural loop
+            Loop *loop = header2loop[header];
+            if (loop == nullptr)
+            {
+                loop = new Loop();
+                loop->header = header;
+                loop->blocks.insert(header);
+                header2loop[header] = loop;
+                loops.push_back(loop);
+            }
+            loop->latches.push_back(bb);
+            std::vector<BasicBlock *> worklist;
+            if (loop->blocks.insert(bb).second)
+                worklist.push_back(bb);
+            while (!worklist.empty())
+            {
+                BasicBlock *cur = worklist.back();
+                worklist.pop_back();
+                for (auto pred = cur->pred_begin(); pred != cur->pred_end(); pred++)
+                    if (isReachable(*pred) && loop->blocks.insert(*pred).second)
+                        worklist.push_back(*pred);
+            }
+        }
+    }
+    std::sort(loops.begin(), loops.end(), [](Loop *a, Loop *b) { return a->blocks.size() < b->blocks.size(); });
+    for (size_t i = 0; i < loops.size(); i++)
+        for (size_t j = i + 1; j < loops.size(); j++)
+            if (loops[j]->contains(loops[i]->header))
+            {
+                loops[i]->parent = loops[j];
+                break;
+            }
+    for (auto &loop : loops)
+        for (Loop *p = loop->parent; p; p = p->parent)
+            loop->depth++;
+}
+
+Loop *LoopAnalysis::getLoopFor(BasicBlock *bb)
+{
+    for (auto &loop : loops)
+        if (loop->contains(bb))
+            return loop;
+    return nullptr;
+}
+
+// Return the single block entering the loop from outside, create one if the
+// header has several outside predecessors or the predecessor branches elsewhere too.
+BasicBlock *LoopAnalysis::getPreheader(Loop *loop)
+{
+    BasicBlock *header = loop->header;
+    std::vector<BasicBlock *> outside;
+    for (auto pred = header->pred_begin(); pred != header->pred_end(); pred++)
+        if (!loop->contains(*pred))
+            outside.push_back(*pred);
+    if (outside.size() == 1 && outside[0]->getNumOfSucc() == 1 && outside[0]->rbegin()->isUncond())
+        return outside[0];
+
+    BasicBlock *preheader = new BasicBlock(func);
+    auto &block_list = func->getBlockList();
+    block_list.pop_back();
+    block_list.insert(std::find(block_list.begin(), block_list.end(), header), preheader);
+    for (auto &pred : outside)
+    {
+        Instruction *last = pred->rbegin();
+        if (last->isUncond())
+            dynamic_cast<UncondBrInstruction *>(last)->setBranch(preheader);
+        else if (last->isCond())
+        {
+            auto br = dynamic_cast<CondBrInstruction *>(last);
+            if (br->getTrueBranch() == header)
+                br->setTrueBranch(preheader);
+            if (br->getFalseBranch() == header)
+                br->setFalseBranch(preheader);
+        }
+        pred->removeSucc(header);
+        pred->addSucc(preheader);
+        header->removePred(pred);
+        preheader->addPred(pred);
+    }
+    new UncondBrInstruction(header, preheader);
+    preheader->addSucc(header);
+    header->addPred(preheader);
+
+    rpo.insert(std::find(rpo.begin(), rpo.end(), header), preheader);
+    order[preheader] = order[header];
+    idom[preheader] = idom[header];
+    idom[header] = preheader;
+    for (Loop *p = loop->parent; p; p = p->parent)
+        p->blocks.insert(preheader);
+    return preheader;
+}
+
+Operand *newConstant(int value)
+{
+    return new Operand(new ConstantSymbolEntry(TypeSystem::intType, value));
+}
+
+ConstantSymbolEntry *constant(Operand *op)
+{
+    return op ? dynamic_cast<ConstantSymbolEntry *>(op->getEntry()) : nullptr;
+}
+
+bool LoopAnalysis::getCounted(Loop *loop, CountedLoop &counted)
+{
+    if (loop->blocks.size() != 2 || loop->latches.size() != 1)
+        return false;
+    BasicBlock *header = loop->header, *body = loop->latches[0];
+    Instruction *load = header->begin();
+    Instruction *cmp = load->getNext();
+    Instruction *br = header->rbegin();
+    if (!load->isLoad() || !cmp->isCmp() || !br->isCond() || cmp->getNext() != br)
+        return false;
+    Operand *iv = load->getOperands()[1];
+    if (iv->getDef() == nullptr || !iv->getDef()->isAlloc())
+        return false;
+    auto &ops = cmp->getOperands();
+    unsigned cond = cmp->getOpcode();
+    if ((cond != CmpInstruction::L && cond != CmpInstruction::LE) || ops[1] != load->getDef())
+        return false;
+    if (ops[2]->getDef() != nullptr && loop->contains(ops[2]->getDef()->getParent()))
+        return false;
+    auto condBr = dynamic_cast<CondBrInstruction *>(br);
+    if (br->getOperands()[0] != ops[0] || ops[0]->usersNum() != 1 || load->getDef()->usersNum() != 1 ||
+        condBr->getTrueBranch() != body || body->getNumOfPred() != 1)
+        return false;
+
+    Instruction *last = body->rbegin();
+    Instruction *store = last->getPrev();
+    if (!last->isUncond() || store == body->end() || !store->isStore() || store->getOperands()[0] != iv)
+        return false;
+    Instruction *add = store->getOperands()[1]->getDef();
+    if (add == nullptr || add->getParent() != body || !add->isBinary() || add->getOpcode() != BinaryInstruction::ADD ||
+        add->getOperands()[0]->usersNum() != 1)
+        return false;
+    Operand *a = add->getOperands()[1], *b = add->getOperands()[2];
+    if (constant(a))
+        std::swap(a, b);
+    if (!constant(b) || constant(b)->getValue() <= 0 || a->getDef() == nullptr || a->getDef()->getParent() != body ||
+        !a->getDef()->isLoad() || a->getDef()->getOperands()[1] != iv)
+        return false;
+    counted = {header, body, condBr->getFalseBranch(), iv, ops[2], cond, constant(b)->getValue(), store};
+    return true;
+}
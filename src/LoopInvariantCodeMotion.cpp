@@ -0,0 +1,109 @@
+#include "LoopInvariantCodeMotion.h"
+#include "Unit.h"
+
+void LoopInvariantCodeMotion::pass()
+{
+    for (auto func = unit->begin(); func != unit->end(); func++)
+        pass(*func);
+}
+
+void LoopInvariantCodeMotion::pass(Function *func)
+{
+    analysis.pass(func);
+    // inner loops first, so that code hoisted into an inner preheader
+    // can be moved further out by the enclosing loop.
+    for (auto &loop : analysis.getLoops())
+        hoist(loop);
+}
+
+void LoopInvariantCodeMotion::collectMemoryEffects(Loop *loop)
+{
+    stored.clear();
+    exiting.clear();
+    hasCall = false;
+    for (auto &bb : loop->blocks)
+    {
+        for (auto inst = bb->begin(); inst != bb->end(); inst = inst->getNext())
+        {
+            if (inst->isStore())
+                stored.insert(inst->getOperands()[0]->getEntry());
+            else if (inst->isCall())
+                hasCall = true;
+        }
+        for (auto succ = bb->succ_begin(); succ != bb->succ_end(); succ++)
+            if (!loop->contains(*succ))
+            {
+                exiting.push_back(bb);
+                break;
+            }
+    }
+}
+
+bool LoopInvariantCodeMotion::isInvariant(Loop *loop, Instruction *inst)
+{
+    if (!inst->isPure() && !inst->isLoad())
+        return false;
+    for (auto &use : inst->getUse())
+    {
+        Instruction *def = use->getDef();
+        if (def != nullptr && loop->contains(def->getParent()))
+            return false;
+    }
+    if (inst->isLoad())
+    {
+        // only scalars living in an alloca or a global variable, which are
+        // not written inside the loop, can be loaded once before it.
+        Operand *addr = inst->getOperands()[1];
+        SymbolEntry *se = addr->getEntry();
+        if (stored.count(se))
+            return false;
+        if (addr->getDef() != nullptr)
+            return addr->getDef()->isAlloc();
+        if (!se->isVariable() || !dynamic_cast<IdentifierSymbolEntry *>(se)->isGlobal())
+            return false;
+        return !hasCall;
+    }
+    return true;
+}
+
+// A hoisted instruction runs even when the loop body would not, so anything
+// with a possible side effect must be executed on every path through the loop.
+bool LoopInvariantCodeMotion::isSafeToHoist(Instruction *inst)
+{
+    if (inst->isLoad() || !inst->isBinary())
+        return true;
+    if (inst->getOpcode() != BinaryInstruction::DIV && inst->getOpcode() != BinaryInstruction::MOD)
+        return true;
+    for (auto &bb : exiting)
+        if (!analysis.dominates(inst->getParent(), bb))
+            return false;
+    return true;
+}
+
+void LoopInvariantCodeMotion::hoist(Loop *loop)
+{
+    BasicBlock *preheader = analysis.getPreheader(loop);
+    collectMemoryEffects(loop);
+    bool change = true;
+    while (change)
+    {
+        change = false;
+        // visit blocks in reverse post order so that operands are hoisted before their users
+        for (auto &bb : analysis.getRPO())
+        {
+            if (!loop->contains(bb))
+                continue;
+            for (auto inst = bb->begin(); inst != bb->end();)
+            {
+                Instruction *next = inst->getNext();
+                if (isInvariant(loop, inst) && isSafeToHoist(inst))
+                {
+                    bb->remove(inst);
+                    preheader->insertBefore(inst, preheader->rbegin());
+                    change = true;
+                }
+                inst = next;
+            }
+        }
+    }
+}
@@ -0,0 +1,271 @@
+/**
+ * unrolling of innermost counted loops
+ */
+#include "LoopUnroll.h"
+#include "Unit.h"
+
+void LoopUnroll::pass()
+{
+    for (auto func = unit->begin(); func != unit->end(); func++)
+        pass(*func);
+}
+
+// Small loops with a known trip count are unrolled completely, one at a
+// time since that can turn the enclosing loop into a candidate. The rest
+// is unrolled by factor.
+void LoopUnroll::pass(Function *func)
+{
+    this->func = func;
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        analysis.pass(func);
+        for (auto &loop : analysis.getLoops())
+        {
+            this->loop = loop;
+            int trip = analyze() ? tripCount() : 0;
+            if (trip > 0 && trip * size <= fullLimit)
+            {
+                unrollFully(trip);
+                changed = true;
+                break;
+            }
+        }
+    }
+    if (factor < 2)
+        return;
+    analysis.pass(func);
+    for (auto &loop : analysis.getLoops())
+    {
+        this->loop = loop;
+        if (!analyze() || size > bodyLimit)
+            continue;
+        int trip = tripCount();
+        if (trip == -1 || trip >= 2 * factor)
+            unroll();
+    }
+}
+
+// A counted loop whose body writes iv only at its end. Loops entered by a
+// conditional branch are the remainder of an unrolled or vectorized loop,
+// they are left alone.
+bool LoopUnroll::analyze()
+{
+    CountedLoop counted;
+    if (!analysis.getCounted(loop, counted))
+        return false;
+    header = counted.header;
+    body = counted.body;
+    exit = counted.exit;
+    iv = counted.iv;
+    bound = counted.bound;
+    cond = counted.cond;
+    step = counted.step;
+    for (auto pred = header->pred_begin(); pred != header->pred_end(); pred++)
+        if (*pred != body && !(*pred)->rbegin()->isUncond())
+            return false;
+
+    Instruction *last = body->rbegin();
+    size = 0;
+    for (auto inst = body->begin(); inst != last; inst = inst->getNext(), size++)
+    {
+        if (inst->isCall() || inst->isCmp() || inst->isLoad() || inst->isStore() || inst->isBinary() || inst->isGep() ||
+            dynamic_cast<SingleInstruction *>(inst) || dynamic_cast<ConverInstruction *>(inst))
+        {
+            if (inst->isStore() && inst->getOperands()[0] == iv && inst != counted.update)
+                return false;
+            Operand *dst = inst->getDef();
+            if (dst != nullptr)
+                for (auto use = dst->use_begin(); use != dst->use_end(); use++)
+                    if ((*use)->getParent() != body)
+                        return false;
+        }
+        else
+            return false;
+    }
+    return true;
+}
+
+// the number of iterations when iv starts from a constant stored on the
+// straight line path into the loop and bound is a constant, -1 otherwise
+int LoopUnroll::tripCount()
+{
+    ConstantSymbolEntry *end = constant(bound);
+    Operand *init = nullptr;
+    BasicBlock *bb = nullptr;
+    for (auto pred = header->pred_begin(); pred != header->pred_end(); pred++)
+        if (*pred != body)
+            bb = *pred;
+    while (bb != nullptr && init == nullptr)
+    {
+        for (auto inst = bb->rbegin(); inst != bb->rend(); inst = inst->getPrev())
+            if (inst->isStore() && inst->getOperands()[0] == iv)
+            {
+                init = inst->getOperands()[1];
+                break;
+            }
+        bb = bb->getNumOfPred() == 1 ? *bb->pred_begin() : nullptr;
+    }
+    if (end == nullptr || init == nullptr || constant(init) == nullptr)
+        return -1;
+    int distance = end->getValue() - constant(init)->getValue() + (cond == CmpInstruction::LE);
+    start = constant(init)->getValue();
+    return distance > 0 ? (distance + step - 1) / step : 0;
+}
+
+// Append one iteration of the body to bb, iv is i + offset in it. Only the
+// last copy writes iv back.
+void LoopUnroll::cloneBody(BasicBlock *bb, Operand *i, int offset, bool last)
+{
+    Operand *value = nullptr;
+    Instruction *store = body->rbegin()->getPrev();
+    Instruction *add = store->getOperands()[1]->getDef();
+    auto map = [this](Operand *op) {
+        if (op == nullptr || op->getDef() == nullptr || op->getDef()->getParent() != body)
+            return op;
+        if (!operandMap.count(op))
+            operandMap[op] = new Operand(new TemporarySymbolEntry(op->getType(), SymbolTable::getLabel()));
+        return operandMap[op];
+    };
+    operandMap.clear();
+    for (auto inst = body->begin(); inst != body->rbegin(); inst = inst->getNext())
+    {
+        auto &ops = inst->getOperands();
+        if (!last && (inst == add || inst == store ||
+                      (inst->isLoad() && ops[0]->usersNum() == 1 && *ops[0]->use_begin() == add)))
+            continue;
+        if (inst->isLoad() && ops[1] == iv)
+        {
+            if (value == nullptr && constant(i))
+                value = newConstant(constant(i)->getValue() + offset);
+            else if (value == nullptr && offset == 0)
+                value = i;
+            else if (value == nullptr)
+            {
+                value = new Operand(new TemporarySymbolEntry(TypeSystem::intType, SymbolTable::getLabel()));
+                new BinaryInstruction(BinaryInstruction::ADD, value, i, newConstant(offset), bb);
+            }
+            operandMap[ops[0]] = value;
+        }
+        else if (inst->isLoad())
+            new LoadInstruction(map(ops[0]), map(ops[1]), bb);
+        else if (inst->isStore())
+            new StoreInstruction(map(ops[0]), map(ops[1]), bb);
+        else if (inst->isBinary())
+            new BinaryInstruction(inst->getOpcode(), map(ops[0]), map(ops[1]), map(ops[2]), bb);
+        else if (inst->isGep())
+            new GepInstruction(map(ops[0]), map(ops[1]), map(ops[2]), bb);
+        else if (inst->isCmp())
+            new CmpInstruction(inst->getOpcode(), map(ops[0]), map(ops[1]), map(ops[2]), bb);
+        else if (dynamic_cast<SingleInstruction *>(inst))
+            new SingleInstruction(inst->getOpcode(), map(ops[0]), map(ops[1]), bb);
+        else if (auto conv = dynamic_cast<ConverInstruction *>(inst))
+            new ConverInstruction(conv->mode, map(ops[0]), map(ops[1]), bb);
+        else if (auto call = dynamic_cast<CallInstruction *>(inst))
+        {
+            std::vector<Operand *> params;
+            for (size_t k = 1; k < ops.size(); k++)
+                params.push_back(map(ops[k]));
+            new CallInstruction(map(ops[0]), call->getFuncSyt(), params, bb);
+        }
+    }
+}
+
+// bb falls through to next, its only predecessor, so they become one block
+void LoopUnroll::merge(BasicBlock *bb, BasicBlock *next)
+{
+    delete bb->rbegin();
+    bb->removeSucc(next);
+    next->removePred(bb);
+    for (auto inst = next->begin(); inst != next->end();)
+    {
+        Instruction *following = inst->getNext();
+        next->remove(inst);
+        bb->insertBack(inst);
+        inst = following;
+    }
+    while (!next->succEmpty())
+    {
+        BasicBlock *succ = next->getSuccB().front();
+        next->removeSucc(succ);
+        succ->removePred(next);
+        succ->addPred(bb);
+        bb->addSucc(succ);
+    }
+    delete next;
+}
+
+// the iterations replace the loop in the preheader, which then absorbs the
+// straight line blocks before and after it
+void LoopUnroll::unrollFully(int trip)
+{
+    BasicBlock *preheader = analysis.getPreheader(loop);
+    delete preheader->rbegin();
+    preheader->removeSucc(header);
+    header->removePred(preheader);
+    for (int k = 0; k < trip; k++)
+        cloneBody(preheader, newConstant(start), k * step, k == trip - 1);
+    delete body;
+    delete header;
+    new UncondBrInstruction(exit, preheader);
+    preheader->addSucc(exit);
+    exit->addPred(preheader);
+
+    BasicBlock *bb = preheader;
+    while (bb->getNumOfPred() == 1 && *bb->pred_begin() != bb && (*bb->pred_begin())->getNumOfSucc() == 1 &&
+           (*bb->pred_begin())->rbegin()->isUncond())
+    {
+        BasicBlock *pred = *bb->pred_begin();
+        merge(pred, bb);
+        bb = pred;
+    }
+    while (bb->getNumOfSucc() == 1 && bb->rbegin()->isUncond() && bb->getSuccB().front() != bb &&
+           bb->getSuccB().front()->getNumOfPred() == 1)
+        merge(bb, bb->getSuccB().front());
+}
+
+// preheader -> unrolled header: iv still in range of bound - (factor - 1) * step?
+//   -> unrolled body with factor iterations -> back to the unrolled header
+//   -> the original loop, which runs the remaining iterations.
+void LoopUnroll::unroll()
+{
+    BasicBlock *preheader = analysis.getPreheader(loop);
+    auto &blocks = func->getBlockList();
+    BasicBlock *uheader = new BasicBlock(func);
+    BasicBlock *ubody = new BasicBlock(func);
+    blocks.erase(blocks.end() - 2, blocks.end());
+    blocks.insert(std::find(blocks.begin(), blocks.end(), header), {uheader, ubody});
+
+    dynamic_cast<UncondBrInstruction *>(preheader->rbegin())->setBranch(uheader);
+    preheader->removeSucc(header);
+    header->removePred(preheader);
+    preheader->addSucc(uheader);
+    uheader->addPred(preheader);
+
+    // the bound is moved rather than iv, which could overflow
+    Operand *limit;
+    if (constant(bound))
+        limit = newConstant(constant(bound)->getValue() - (factor - 1) * step);
+    else
+    {
+        limit = new Operand(new TemporarySymbolEntry(TypeSystem::intType, SymbolTable::getLabel()));
+        preheader->insertBefore(new BinaryInstruction(BinaryInstruction::SUB, limit, bound, newConstant((factor - 1) * step)),
+                                preheader->rbegin());
+    }
+    Operand *i = new Operand(new TemporarySymbolEntry(TypeSystem::intType, SymbolTable::getLabel()));
+    Operand *inRange = new Operand(new TemporarySymbolEntry(TypeSystem::boolType, SymbolTable::getLabel()));
+    new LoadInstruction(i, iv, uheader);
+    new CmpInstruction(cond, inRange, i, limit, uheader);
+    new CondBrInstruction(ubody, header, inRange, uheader);
+    uheader->addSucc(ubody);
+    ubody->addPred(uheader);
+    uheader->addSucc(header);
+    header->addPred(uheader);
+
+    for (int k = 0; k < factor; k++)
+        cloneBody(ubody, i, k * step, k == factor - 1);
+    new UncondBrInstruction(uheader, ubody);
+    ubody->addSucc(uheader);
+    uheader->addPred(ubody);
+}
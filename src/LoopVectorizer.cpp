@@ -0,0 +1,337 @@
+/**
+ * vectorization of innermost counted loops over int arrays with NEON
+ */
+#include "LoopVectorizer.h"
+#include "Unit.h"
+
+static Operand *newTemp(Type *type = TypeSystem::intType)
+{
+    return new Operand(new TemporarySymbolEntry(type, SymbolTable::getLabel()));
+}
+
+static bool isInt(Operand *op)
+{
+    return op->getType()->isInt() || op->getType()->isConstInt();
+}
+
+// array parameters are loaded from their alloca, everything else is the
+// address of a global or a local array itself
+static SymbolEntry *object(Operand *base)
+{
+    Instruction *def = base->getDef();
+    if (def != nullptr && def->isLoad())
+        return def->getOperands()[1]->getEntry();
+    return base->getEntry();
+}
+
+static bool isNamed(Operand *base)
+{
+    return base->getDef() == nullptr || base->getDef()->isAlloc();
+}
+
+// a nullptr offset is 0
+static bool sameOffset(Operand *a, Operand *b)
+{
+    if (a == b)
+        return true;
+    ConstantSymbolEntry *ca = constant(a), *cb = constant(b);
+    if ((a && !ca) || (b && !cb))
+        return false;
+    return (ca ? ca->getValue() : 0) == (cb ? cb->getValue() : 0);
+}
+
+void LoopVectorizer::pass()
+{
+    for (auto func = unit->begin(); func != unit->end(); func++)
+        pass(*func);
+}
+
+void LoopVectorizer::pass(Function *func)
+{
+    this->func = func;
+    analysis.pass(func);
+    for (auto &loop : analysis.getLoops())
+    {
+        this->loop = loop;
+        if (analyzeHeader() && analyzeBody() && analyzeAliasing())
+            vectorize();
+    }
+}
+
+bool LoopVectorizer::isInvariant(Operand *op)
+{
+    return op->getDef() == nullptr || !loop->contains(op->getDef()->getParent());
+}
+
+// the q register holding op, invariants get one to be broadcast to
+int LoopVectorizer::vectorOperand(Operand *op)
+{
+    if (qregs.count(op))
+        return qregs[op];
+    if (!isInvariant(op) || !isInt(op))
+        return -1;
+    for (auto &dup : dups)
+        if (constant(op) && constant(dup) && constant(op)->getValue() == constant(dup)->getValue())
+            return qregs[op] = qregs[dup];
+    if (nqregs == 8)
+        return -1;
+    dups.push_back(op);
+    return qregs[op] = 8 + nqregs++;
+}
+
+// a counted loop stepping by one
+bool LoopVectorizer::analyzeHeader()
+{
+    CountedLoop counted;
+    if (!analysis.getCounted(loop, counted) || counted.step != 1)
+        return false;
+    header = counted.header;
+    body = counted.body;
+    iv = counted.iv;
+    bound = counted.bound;
+    cond = counted.cond;
+    update = counted.update;
+    return true;
+}
+
+void LoopVectorizer::addAccess(Operand *addr, bool store)
+{
+    Access &access = addrs[addr];
+    for (auto &other : accesses)
+        if (object(other.base) == object(access.base) && sameOffset(other.offset, access.offset))
+        {
+            other.store |= store;
+            return;
+        }
+    accesses.push_back({access.base, access.offset, store});
+}
+
+// Everything in the body has to be element loads and stores at iv plus an
+// invariant offset, int add/sub/mul on them and on invariants, and the
+// increment of iv by one at the end.
+bool LoopVectorizer::analyzeBody()
+{
+    index.clear();
+    addrs.clear();
+    accesses.clear();
+    qregs.clear();
+    dups.clear();
+    nqregs = 0;
+    bool stepped = false;
+    Instruction *last = body->rbegin();
+    if (!last->isUncond() || dynamic_cast<UncondBrInstruction *>(last)->getBranch() != header)
+        return false;
+    for (auto inst = body->begin(); inst != last; inst = inst->getNext())
+    {
+        if (stepped)
+            return false;
+        auto &ops = inst->getOperands();
+        Operand *dst = inst->getDef();
+        if (dst != nullptr)
+            for (auto use = dst->use_begin(); use != dst->use_end(); use++)
+                if ((*use)->getParent() != body)
+                    return false;
+        if (inst->isLoad() && ops[1] == iv)
+            index[dst] = nullptr;
+        else if (inst->isLoad() && addrs.count(ops[1]))
+        {
+            if (!isInt(dst) || nqregs == 8)
+                return false;
+            qregs[dst] = 8 + nqregs++;
+            addAccess(ops[1], false);
+        }
+        else if (inst->isBinary() && inst->getOpcode() == BinaryInstruction::ADD &&
+                 ((index.count(ops[1]) && !index[ops[1]]) || (index.count(ops[2]) && !index[ops[2]])))
+        {
+            Operand *offset = index.count(ops[1]) && !index[ops[1]] ? ops[2] : ops[1];
+            if (!isInvariant(offset) || !isInt(offset))
+                return false;
+            if (dst != update->getOperands()[1])
+                index[dst] = offset;
+        }
+        else if (inst->isBinary() && inst->getOpcode() <= BinaryInstruction::MUL)
+        {
+            if (!isInt(dst) || (isInvariant(ops[1]) && isInvariant(ops[2])))
+                return false;
+            if (vectorOperand(ops[1]) < 0 || vectorOperand(ops[2]) < 0 || nqregs == 8)
+                return false;
+            qregs[dst] = 8 + nqregs++;
+        }
+        else if (inst->isGep() && isInvariant(ops[1]) && index.count(ops[2]))
+            addrs[dst] = {ops[1], index[ops[2]], false};
+        else if (inst == update)
+            stepped = true;
+        else if (inst->isStore() && addrs.count(ops[0]))
+        {
+            if (!isInt(ops[1]) || vectorOperand(ops[1]) < 0)
+                return false;
+            addAccess(ops[0], true);
+        }
+        else
+            return false;
+    }
+    return stepped;
+}
+
+// A vector iteration loads four elements before storing any. Two accesses
+// to the same element keep their order, arrays overlapping at a distance
+// of less than four elements would not; when the bases are not known to
+// differ, their distance is checked before entering the vector loop.
+bool LoopVectorizer::analyzeAliasing()
+{
+    checks.clear();
+    for (size_t i = 0; i < accesses.size(); i++)
+        for (size_t j = i + 1; j < accesses.size(); j++)
+        {
+            Access &a = accesses[i], &b = accesses[j];
+            if (!a.store && !b.store)
+                continue;
+            if (object(a.base) != object(b.base))
+            {
+                if (!isNamed(a.base) || !isNamed(b.base))
+                    checks.push_back({a, b});
+                continue;
+            }
+            ConstantSymbolEntry *ca = constant(a.offset), *cb = constant(b.offset);
+            if ((a.offset && !ca) || (b.offset && !cb))
+                checks.push_back({a, b});
+            else if (std::abs((ca ? ca->getValue() : 0) - (cb ? cb->getValue() : 0)) < 4)
+                return false;
+        }
+    return checks.size() <= 4;
+}
+
+BasicBlock *LoopVectorizer::newBlock()
+{
+    BasicBlock *bb = new BasicBlock(func);
+    auto &blocks = func->getBlockList();
+    blocks.pop_back();
+    blocks.insert(std::find(blocks.begin(), blocks.end(), header), bb);
+    return bb;
+}
+
+void LoopVectorizer::branch(BasicBlock *from, BasicBlock *to)
+{
+    new UncondBrInstruction(to, from);
+    from->addSucc(to);
+    to->addPred(from);
+}
+
+void LoopVectorizer::condBranch(BasicBlock *from, Operand *cond, BasicBlock *taken, BasicBlock *other)
+{
+    new CondBrInstruction(taken, other, cond, from);
+    from->addSucc(taken);
+    taken->addPred(from);
+    from->addSucc(other);
+    other->addPred(from);
+}
+
+// four more iterations to go: iv < bound - 3, or <= bound - 3, the bound
+// being moved rather than iv, which could overflow; otherwise the scalar
+// loop does the rest
+void LoopVectorizer::genTripTest(BasicBlock *bb, BasicBlock *taken)
+{
+    Operand *i = newTemp(), *cmp = newTemp(TypeSystem::boolType);
+    new LoadInstruction(i, iv, bb);
+    new CmpInstruction(cond, cmp, i, limit, bb);
+    condBranch(bb, cmp, taken, header);
+}
+
+Operand *LoopVectorizer::genAddress(Operand *base, Operand *idx, BasicBlock *bb)
+{
+    Operand *addr = newTemp(new PointerType(TypeSystem::intType));
+    new GepInstruction(addr, base, idx, bb);
+    return addr;
+}
+
+// d = &a[offset] - &b[offset], the vector loop is safe for d == 0 or |d| >= 16
+BasicBlock *LoopVectorizer::genChecks(BasicBlock *bb)
+{
+    for (auto &check : checks)
+    {
+        Access &a = check.first, &b = check.second;
+        Operand *d = newTemp();
+        new BinaryInstruction(BinaryInstruction::SUB, d,
+                              genAddress(a.base, a.offset ? a.offset : newConstant(0), bb),
+                              genAddress(b.base, b.offset ? b.offset : newConstant(0), bb), bb);
+        BasicBlock *above = newBlock(), *below = newBlock(), *next = newBlock();
+        Operand *same = newTemp(TypeSystem::boolType);
+        new CmpInstruction(CmpInstruction::E, same, d, newConstant(0), bb);
+        condBranch(bb, same, next, above);
+        Operand *far = newTemp(TypeSystem::boolType);
+        new CmpInstruction(CmpInstruction::GE, far, d, newConstant(16), above);
+        condBranch(above, far, next, below);
+        far = newTemp(TypeSystem::boolType);
+        new CmpInstruction(CmpInstruction::LE, far, d, newConstant(-16), below);
+        condBranch(below, far, next, header);
+        bb = next;
+    }
+    return bb;
+}
+
+// preheader -> [trip test, overlap checks] -> broadcasts -> vector loop
+// -> the original loop, which finishes the remaining iterations.
+void LoopVectorizer::vectorize()
+{
+    BasicBlock *preheader = analysis.getPreheader(loop);
+    BasicBlock *bb = newBlock();
+    dynamic_cast<UncondBrInstruction *>(preheader->rbegin())->setBranch(bb);
+    preheader->removeSucc(header);
+    header->removePred(preheader);
+    preheader->addSucc(bb);
+    bb->addPred(preheader);
+    if (constant(bound))
+        limit = newConstant(constant(bound)->getValue() - 3);
+    else
+    {
+        limit = newTemp();
+        new BinaryInstruction(BinaryInstruction::SUB, limit, bound, newConstant(3), bb);
+    }
+    if (!checks.empty())
+    {
+        // only pay for the checks when the vector loop runs at all
+        BasicBlock *next = newBlock();
+        genTripTest(bb, next);
+        bb = genChecks(next);
+    }
+    for (auto &op : dups)
+        new VectorInstruction(VectorInstruction::DUP, qregs[op], 0, 0, op, bb);
+    BasicBlock *vheader = newBlock(), *vbody = newBlock();
+    branch(bb, vheader);
+    genTripTest(vheader, vbody);
+
+    Operand *i = newTemp();
+    new LoadInstruction(i, iv, vbody);
+    std::map<Operand *, Operand *> shifted;     // iv + offset
+    std::map<Operand *, Operand *> addr;        // element addresses in the vector body
+    for (auto inst = body->begin(); inst != body->rbegin(); inst = inst->getNext())
+    {
+        auto &ops = inst->getOperands();
+        if (inst->isGep())
+        {
+            Operand *offset = addrs[ops[0]].offset, *idx = i;
+            if (offset && !shifted.count(offset))
+            {
+                shifted[offset] = newTemp();
+                new BinaryInstruction(BinaryInstruction::ADD, shifted[offset], offset, i, vbody);
+            }
+            if (offset)
+                idx = shifted[offset];
+            addr[ops[0]] = genAddress(ops[1], idx, vbody);
+        }
+        else if (inst->isLoad() && addrs.count(ops[1]))
+            new VectorInstruction(VectorInstruction::LOAD, qregs[ops[0]], 0, 0, addr[ops[1]], vbody);
+        else if (inst->isStore() && addrs.count(ops[0]))
+            new VectorInstruction(VectorInstruction::STORE, qregs[ops[1]], 0, 0, addr[ops[0]], vbody);
+        else if (inst->isBinary() && qregs.count(ops[0]))
+        {
+            unsigned op = inst->getOpcode() == BinaryInstruction::ADD ? VectorInstruction::ADD
+                        : inst->getOpcode() == BinaryInstruction::SUB ? VectorInstruction::SUB : VectorInstruction::MUL;
+            new VectorInstruction(op, qregs[ops[0]], qregs[ops[1]], qregs[ops[2]], nullptr, vbody);
+        }
+    }
+    Operand *next = newTemp();
+    new BinaryInstruction(BinaryInstruction::ADD, next, i, newConstant(4), vbody);
+    new StoreInstruction(iv, next, vbody);
+    branch(vbody, vheader);
+}
@@ -1,10 +1,12 @@
 #include "MachineCode.h"
 #include <iostream>
+#include <string.h>
 extern FILE* yyout;
 
-MachineOperand::MachineOperand(int tp, int val)
+MachineOperand::MachineOperand(int tp, int val, bool fpu)
 {
     this->type = tp;
+    this->fpu = fpu;
     if(tp == MachineOperand::IMM)
         this->val = val;
     else 
@@ -15,6 +17,7 @@ MachineOperand::MachineOperand(std::string label)
 {
     this->type = MachineOperand::LABEL;
     this->label = label;
+    this->fpu = false;
 }
 
 bool MachineOperand::operator==(const MachineOperand&a) const
@@ -23,11 +26,13 @@ bool MachineOperand::operator==(const MachineOperand&a) const
         return false;
     if (this->type == IMM)
         return this->val == a.val;
-    return this->reg_no == a.reg_no;
+    return this->reg_no == a.reg_no && this->fpu == a.fpu;
 }
 
 bool MachineOperand::operator<(const MachineOperand&a) const
 {
+    if(this->type == a.type && this->type != IMM && this->fpu != a.fpu)
+        return this->fpu < a.fpu;
     if(this->type == a.type)
     {
         if(this->type == IMM)
@@ -45,6 +50,11 @@ bool MachineOperand::operator<(const MachineOperand&a) const
 
 void MachineOperand::PrintReg()
 {
+    if (fpu)
+    {
+        fprintf(yyout, "s%d", reg_no);
+        return;
+    }
     switch (reg_no)
     {
     case 11:
@@ -93,6 +103,107 @@ void MachineOperand::output()
     default:
         break;
     }
+    if (this->shift != NOSHIFT)
+    {
+        static const char *name[] = {"", "lsl", "lsr", "asr"};
+        fprintf(yyout, ", %s #%d", name[this->shift], this->shift_amount);
+    }
+}
+
+// ARM data processing immediates are an 8-bit value rotated right by an even amount.
+bool MachineOperand::isEncodableImm(int val)
+{
+    unsigned v = val;
+    for (int rot = 0; rot < 32; rot += 2)
+        if (((v << rot) | (v >> ((32 - rot) & 31))) <= 0xff)
+            return true;
+    return false;
+}
+
+// Constants never go through the literal pool: mov or mvn when the value or its
+// complement is encodable, otherwise movw and, for a non zero upper half, movt.
+void MachineInstruction::PrintImmMove(MachineOperand* dst, int val)
+{
+    unsigned v = val;
+    const char *op = "movw";
+    bool wide = true;
+    if (MachineOperand::isEncodableImm(val))
+    {
+        op = "mov";
+        wide = false;
+    }
+    else if (MachineOperand::isEncodableImm(~val))
+    {
+        op = "mvn";
+        v = ~v;
+        wide = false;
+    }
+    fprintf(yyout, "\t%s", op);
+    PrintCond();
+    fprintf(yyout, " ");
+    dst->output();
+    if (!wide)
+    {
+        fprintf(yyout, ", #%d\n", (int)v);
+        return;
+    }
+    fprintf(yyout, ", #%u\n", v & 0xffff);
+    if ((v >> 16) == 0)
+        return;
+    fprintf(yyout, "\tmovt");
+    PrintCond();
+    fprintf(yyout, " ");
+    dst->output();
+    fprintf(yyout, ", #%u\n", v >> 16);
+}
+
+// vldr/vstr only encode a word aligned immediate offset up to 1020, any
+// other address is formed in ip first, which the allocator never hands out.
+void MachineInstruction::PrintVfpAccess(const char* op, MachineOperand* reg, MachineOperand* base, MachineOperand* offset)
+{
+    if (offset && !(offset->isImm() && offset->getVal() % 4 == 0 && offset->getVal() >= -1020 && offset->getVal() <= 1020))
+    {
+        MachineOperand *ip = new MachineOperand(MachineOperand::REG, 12);
+        if (offset->isImm() && !MachineOperand::isEncodableImm(offset->getVal()))
+        {
+            PrintImmMove(ip, offset->getVal());
+            offset = ip;
+        }
+        fprintf(yyout, "\tadd");
+        PrintCond();
+        fprintf(yyout, " ");
+        ip->output();
+        fprintf(yyout, ", ");
+        base->output();
+        fprintf(yyout, ", ");
+        offset->output();
+        fprintf(yyout, "\n");
+        base = ip;
+        offset = nullptr;
+    }
+    fprintf(yyout, "\t%s", op);
+    PrintCond();
+    fprintf(yyout, " ");
+    reg->output();
+    fprintf(yyout, ", [");
+    base->output();
+    if (offset)
+    {
+        fprintf(yyout, ", ");
+        offset->output();
+    }
+    fprintf(yyout, "]\n");
+}
+
+// ldr/str encode an immediate offset up to 4095 either way, a larger one,
+// as in a big frame, goes through ip as a register offset.
+MachineOperand* MachineInstruction::PrintFarOffset(MachineOperand* offset)
+{
+    if (!offset->isImm() || (offset->getVal() >= -4095 && offset->getVal() <= 4095))
+        return offset;
+    MachineOperand *ip = new MachineOperand(MachineOperand::REG, 12);
+    PrintImmMove(ip, offset->getVal());
+    return ip;
 }
 
 void MachineInstruction::PrintCond()
@@ -144,19 +255,10 @@ void SingleMInstruction::output(){
     switch (this->op)
     {
     case SingleMInstruction::MIN:
-        //std::cout<<"MIN"<<std::endl;
-        fprintf(yyout, "\tsub ");
-        this->PrintCond();
-        this->def_list[0]->output();
-        fprintf(yyout, ", ");
-        this->use_list[0]->output();
-        fprintf(yyout, ", ");
-        this->use_list[1]->output();
-        fprintf(yyout, "\n");
-        break;
     case SingleMInstruction::NOT:
-        fprintf(yyout, "\teor ");
+        fprintf(yyout, this->op == SingleMInstruction::MIN ? "\tsub" : "\teor");
         this->PrintCond();
+        fprintf(yyout, " ");
         this->def_list[0]->output();
         fprintf(yyout, ", ");
         this->use_list[0]->output();
@@ -186,67 +288,113 @@ BinaryMInstruction::BinaryMInstruction(
 
 void BinaryMInstruction::output() 
 {
-    // TODO: 
-    // Complete other instructions
-    switch (this->op)
+    static const char *name[] = {"add", "sub", "mul", "sdiv", "and", "orr", "lsl", "lsr", "asr", "smmul", "rsb",
+                                 "vadd", "vsub", "vmul", "vdiv"};
+    fprintf(yyout, "\t%s", name[this->op]);
+    this->PrintCond();
+    if (this->op >= VADD)
+        fprintf(yyout, ".f32");
+    fprintf(yyout, " ");
+    this->def_list[0]->output();
+    fprintf(yyout, ", ");
+    this->use_list[0]->output();
+    fprintf(yyout, ", ");
+    this->use_list[1]->output();
+    fprintf(yyout, "\n");
+}
+
+MlaMInstruction::MlaMInstruction(MachineBlock* p, int op,
+    MachineOperand* dst, MachineOperand* src1, MachineOperand* src2, MachineOperand* acc,
+    int cond)
+{
+    this->parent = p;
+    this->type = MachineInstruction::MLA;
+    this->op = op;
+    this->cond = cond;
+    this->def_list.push_back(dst);
+    this->use_list.push_back(src1);
+    this->use_list.push_back(src2);
+    this->use_list.push_back(acc);
+    dst->setParent(this);
+    src1->setParent(this);
+    src2->setParent(this);
+    acc->setParent(this);
+}
+
+void MlaMInstruction::output()
+{
+    fprintf(yyout, this->op == MLA ? "\tmla" : "\tmls");
+    PrintCond();
+    fprintf(yyout, " ");
+    this->def_list[0]->output();
+    for (auto &use : this->use_list)
     {
-    case BinaryMInstruction::ADD:
-        fprintf(yyout, "\tadd ");
-        this->PrintCond();
-        this->def_list[0]->output();
-        fprintf(yyout, ", ");
-        this->use_list[0]->output();
-        fprintf(yyout, ", ");
-        this->use_list[1]->output();
-        fprintf(yyout, "\n");
-        break;
-    case BinaryMInstruction::SUB:
-        fprintf(yyout, "\tsub ");
-        this->PrintCond();
-        this->def_list[0]->output();
-        fprintf(yyout, ", ");
-        this->use_list[0]->output();
-        fprintf(yyout, ", ");
-        this->use_list[1]->output();
-        fprintf(yyout, "\n");
-        break;
-    case BinaryMInstruction::AND:
-        fprintf(yyout, "\tand ");
-        this->def_list[0]->output();
-        fprintf(yyout, ", ");
-        this->use_list[0]->output();
-        fprintf(yyout, ", ");
-        this->use_list[1]->output();
-        fprintf(yyout, "\n");
-        break;
-    case BinaryMInstruction::OR:
-        fprintf(yyout, "\torr ");
-        this->def_list[0]->output();
-        fprintf(yyout, ", ");
-        this->use_list[0]->output();
-        fprintf(yyout, ", ");
-        this->use_list[1]->output();
-        fprintf(yyout, "\n");
-        break;
-    case BinaryMInstruction::MUL:
-        fprintf(yyout, "\tmul ");
-        this->def_list[0]->output();
         fprintf(yyout, ", ");
+        use->output();
+    }
+    fprintf(yyout, "\n");
+}
+
+VUnaryMInstruction::VUnaryMInstruction(MachineBlock* p, int op,
+    MachineOperand* dst, MachineOperand* src,
+    int cond)
+{
+    this->parent = p;
+    this->type = MachineInstruction::VUNARY;
+    this->op = op;
+    this->cond = cond;
+    this->def_list.push_back(dst);
+    this->use_list.push_back(src);
+    dst->setParent(this);
+    src->setParent(this);
+}
+
+void VUnaryMInstruction::output()
+{
+    static const char *name[] = {"vneg", "vcvt", "vcvt"};
+    static const char *suffix[] = {".f32", ".f32.s32", ".s32.f32"};
+    fprintf(yyout, "\t%s", name[this->op]);
+    PrintCond();
+    fprintf(yyout, "%s ", suffix[this->op]);
+    this->def_list[0]->output();
+    fprintf(yyout, ", ");
+    this->use_list[0]->output();
+    fprintf(yyout, "\n");
+}
+
+VectorMInstruction::VectorMInstruction(MachineBlock* p, int op, int qd, int qa, int qb, MachineOperand* src)
+{
+    this->parent = p;
+    this->type = MachineInstruction::VECTOR;
+    this->op = op;
+    this->qd = qd;
+    this->qa = qa;
+    this->qb = qb;
+    if (src)
+    {
+        this->use_list.push_back(src);
+        src->setParent(this);
+    }
+}
+
+void VectorMInstruction::output()
+{
+    static const char *name[] = {"vld1", "vst1", "vadd", "vsub", "vmul", "vdup"};
+    switch (this->op)
+    {
+    case VLD1:
+    case VST1:
+        fprintf(yyout, "\t%s.32 {q%d}, [", name[this->op], qd);
         this->use_list[0]->output();
-        fprintf(yyout, ", ");
-        this->use_list[1]->output();
-        fprintf(yyout, "\n");
+        fprintf(yyout, "]\n");
         break;
-    case BinaryMInstruction::DIV:
-        fprintf(yyout, "\tsdiv ");
-        this->def_list[0]->output();
-        fprintf(yyout, ", ");
+    case VDUP:
+        fprintf(yyout, "\tvdup.32 q%d, ", qd);
         this->use_list[0]->output();
-        fprintf(yyout, ", ");
-        this->use_list[1]->output();
         fprintf(yyout, "\n");
         break;
     default:
+        fprintf(yyout, "\t%s.i32 q%d, q%d, q%d\n", name[this->op], qd, qa, qb);
         break;
     }
 }
@@ -271,26 +419,53 @@ LoadMInstruction::LoadMInstruction(MachineBlock* p,
 
 void LoadMInstruction::output()
 {
-    fprintf(yyout, "\tldr ");
-    this->def_list[0]->output();
-    fprintf(yyout, ", ");
 
-    // Load immediate num, eg: ldr r1, =8
+    // Load immediate num, eg: mov r1, #8
     if(this->use_list[0]->isImm())
     {
-        fprintf(yyout, "=%d\n", this->use_list[0]->getVal());
+        PrintImmMove(this->def_list[0], this->use_list[0]->getVal());
         return;
     }
 
+    // Load address of a global, eg: movw r1, #:lower16:a
+    if(this->use_list[0]->isLabel())
+    {
+        std::string name = this->use_list[0]->getLabel();
+        fprintf(yyout, "\tmovw");
+        PrintCond();
+        fprintf(yyout, " ");
+        this->def_list[0]->output();
+        fprintf(yyout, ", #:lower16:%s\n", name.c_str());
+        fprintf(yyout, "\tmovt");
+        PrintCond();
+        fprintf(yyout, " ");
+        this->def_list[0]->output();
+        fprintf(yyout, ", #:upper16:%s\n", name.c_str());
+        return;
+    }
+
+    if(this->def_list[0]->isFloat())
+    {
+        PrintVfpAccess("vldr", this->def_list[0], this->use_list[0], this->use_list.size() > 1 ? this->use_list[1] : nullptr);
+        return;
+    }
+
+    MachineOperand *offset = this->use_list.size() > 1 ? PrintFarOffset(this->use_list[1]) : nullptr;
+    fprintf(yyout, "\tldr");
+    PrintCond();
+    fprintf(yyout, " ");
+    this->def_list[0]->output();
+    fprintf(yyout, ", ");
+
     // Load address
     if(this->use_list[0]->isReg()||this->use_list[0]->isVReg())
         fprintf(yyout, "[");
 
     this->use_list[0]->output();
-    if( this->use_list.size() > 1 )
+    if( offset )
     {
         fprintf(yyout, ", ");
-        this->use_list[1]->output();
+        offset->output();
     }
 
     if(this->use_list[0]->isReg()||this->use_list[0]->isVReg())
@@ -321,16 +496,24 @@ StoreMInstruction::StoreMInstruction(MachineBlock* p,
 void StoreMInstruction::output()
 {
     // TODO
-    fprintf(yyout, "\tstr ");
+    if (this->use_list[0]->isFloat())
+    {
+        PrintVfpAccess("vstr", this->use_list[0], this->use_list[1], this->use_list.size() > 2 ? this->use_list[2] : nullptr);
+        return;
+    }
+    MachineOperand *offset = this->use_list.size() > 2 ? PrintFarOffset(this->use_list[2]) : nullptr;
+    fprintf(yyout, "\tstr");
+        PrintCond();
+        fprintf(yyout, " ");
         this->use_list[0]->output();
         fprintf(yyout, ", ");
         // store address
         if (this->use_list[1]->isReg() || this->use_list[1]->isVReg())
             fprintf(yyout, "[");
         this->use_list[1]->output();
-        if (this->use_list.size() > 2) {
+        if (offset) {
             fprintf(yyout, ", ");
-            this->use_list[2]->output();
+            offset->output();
         }
         if (this->use_list[1]->isReg() || this->use_list[1]->isVReg())
             fprintf(yyout, "]");
@@ -356,8 +539,17 @@ MovMInstruction::MovMInstruction(MachineBlock* p, int op,
 void MovMInstruction::output() 
 {
     // TODO
-    fprintf(yyout, "\tmov");
+    if (this->op == MovMInstruction::MOV && this->use_list[0]->isImm())
+    {
+        PrintImmMove(this->def_list[0], this->use_list[0]->getVal());
+        return;
+    }
+    // vmov between VFP registers, or across to and from a core register
+    bool vfp = this->def_list[0]->isFloat() || this->use_list[0]->isFloat();
+    fprintf(yyout, vfp ? "\tvmov" : "\tmov");
     PrintCond();
+    if (this->def_list[0]->isFloat() && this->use_list[0]->isFloat())
+        fprintf(yyout, ".f32");
     fprintf(yyout, " ");
     this->def_list[0]->output();
     fprintf(yyout, ", ");
@@ -378,6 +570,12 @@ BranchMInstruction::BranchMInstruction(MachineBlock* p, int op,
     dst->setParent(this);
 }
 
+// b to a function label instead of a block
+bool MachineInstruction::isTailCall() const
+{
+    return type == BRANCH && op == BranchMInstruction::B && use_list[0]->isLabel() && use_list[0]->getLabel()[0] == '@';
+}
+
 void BranchMInstruction::output()
 {
     // TODO
@@ -428,6 +626,24 @@ void CmpMInstruction::output()
     // TODO
     // Jsut for reg alloca test
     // delete it after test
+    // vcmp sets the VFP flags, vmrs copies them over for the conditional code
+    if (this->use_list[0]->isFloat())
+    {
+        fprintf(yyout, "\tvcmp.f32 ");
+        this->use_list[0]->output();
+        fprintf(yyout, ", ");
+        this->use_list[1]->output();
+        fprintf(yyout, "\n\tvmrs APSR_nzcv, FPSCR\n");
+        return;
+    }
+    // cmp r, #-imm is cmn r, #imm
+    if (this->use_list[1]->isImm() && !MachineOperand::isEncodableImm(this->use_list[1]->getVal()))
+    {
+        fprintf(yyout, "\tcmn ");
+        this->use_list[0]->output();
+        fprintf(yyout, ", #%d\n", -this->use_list[1]->getVal());
+        return;
+    }
     fprintf(yyout, "\tcmp ");
     this->use_list[0]->output();
     fprintf(yyout, ", ");
@@ -435,25 +651,6 @@ void CmpMInstruction::output()
     fprintf(yyout, "\n");
 }
 
-SalMInstruction::SalMInstruction(MachineBlock* p, MachineOperand* dst, MachineOperand* src){
-    this->op = -1;
-    this->cond = 0;
-    this->parent = p;
-    this->def_list.push_back(dst);
-    this->use_list.push_back(src);
-    dst->setParent(this);
-    src->setParent(this);
-}
-
-void SalMInstruction::output()
-{
-    fprintf(yyout, "\tlsl ");
-    this->def_list[0]->output();
-    fprintf(yyout, ", ");
-    this->use_list[0]->output();
-    fprintf(yyout, "\n");
-}
-
 StackMInstrcuton::StackMInstrcuton(MachineBlock* p, int op, std::vector<MachineOperand*> srcs, MachineOperand* src, MachineOperand* src1, int cond) 
 {
     this->parent = p;
@@ -486,6 +683,12 @@ void StackMInstrcuton::output()
         case POP:
             fprintf(yyout, "\tpop ");
             break;
+        case VPUSH:
+            fprintf(yyout, "\tvpush ");
+            break;
+        case VPOP:
+            fprintf(yyout, "\tvpop ");
+            break;
     }
     fprintf(yyout, "{");
     this->use_list[0]->output();
@@ -504,23 +707,52 @@ MachineFunction::MachineFunction(MachineUnit* p, SymbolEntry* sym_ptr)
     this->parent = p; 
     this->sym_ptr = sym_ptr; 
     this->stack_size = 0;
-    this->paramsNum = ((FunctionType*)(sym_ptr->getType()))->getParaType().size();
+    // parameters in core registers or on the stack, floats come in s0-s15
+    this->paramsNum = 0;
+    for (auto type : ((FunctionType*)(sym_ptr->getType()))->getParaType())
+        if (!type->isFloat())
+            this->paramsNum++;
+    this->leaf = false;
+    this->frame_pointer = true;
 };
 
+// the block a b to a local label jumps to
+MachineBlock* MachineFunction::target(MachineInstruction* inst)
+{
+    if (!inst->isBranch() || inst->getOp() != BranchMInstruction::B)
+        return nullptr;
+    std::string label = inst->getUse()[0]->getLabel();
+    if (label.compare(0, 2, ".L") != 0)
+        return nullptr;
+    int no = std::stoi(label.substr(2));
+    for (auto &block : block_list)
+        if (block->getNo() == no)
+            return block;
+    return nullptr;
+}
+
+// mov sp, fp ahead of a return
+static bool isFrameRestore(MachineInstruction* inst)
+{
+    return inst->isMov() && inst->getDef()[0]->isReg() && inst->getDef()[0]->getReg() == 13 &&
+           inst->getUse()[0]->isReg() && inst->getUse()[0]->getReg() == 11;
+}
+
 void MachineBlock::output()
 {
-    int offset = (parent->getSavedRegs().size() + 2) * 4;
+    int offset = (parent->getFrameRegs().size() + parent->getSavedFRegs().size()) * 4;
     int num = parent->getParaNum();
     int count = 0;
+    // the label is printed even for a block left empty, others may branch to it
+    fprintf(yyout, ".L%d:\n", this->no);
     if (!inst_list.empty()) 
     {
-        fprintf(yyout, ".L%d:\n", this->no);
         for (long unsigned int i = 0; i < inst_list.size(); i++) 
         {
             if (num > 4 && (inst_list[i])->isStore()) 
             {
                 MachineOperand* operand = (inst_list[i])->getUse()[0];
-                if (operand->isReg() && operand->getReg() == 0) 
+                if (operand->isReg() && operand->getReg() == 0 && !operand->isFloat()) 
                 {
                     if (count != 0) 
                     {
@@ -534,10 +766,29 @@ void MachineBlock::output()
                     }
                 }
             }
-            if ((inst_list[i])->isBX()) 
+            if (!parent->hasFramePointer() && isFrameRestore(inst_list[i]))
+                continue;
+            if ((inst_list[i])->isBX() || (inst_list[i])->isTailCall()) 
             {
-                auto cur_inst = new StackMInstrcuton(this, StackMInstrcuton::POP, parent->getSavedRegs(), new MachineOperand(MachineOperand::REG, 11), new MachineOperand(MachineOperand::REG, 14));
-                cur_inst->output();
+                // returning pops the saved lr straight into pc, unless s16-s31
+                // still have to be restored from below it
+                auto fregs = parent->getSavedFRegs();
+                bool ret = inst_list[i]->isBX() && !parent->isLeaf() && fregs.empty();
+                auto regs = parent->getFrameRegs(ret);
+                if (!regs.empty())
+                {
+                    MachineOperand *last = regs.back();
+                    regs.pop_back();
+                    (new StackMInstrcuton(this, StackMInstrcuton::POP, regs, last))->output();
+                }
+                if (!fregs.empty())
+                {
+                    MachineOperand *last = fregs.back();
+                    fregs.pop_back();
+                    (new StackMInstrcuton(this, StackMInstrcuton::VPOP, fregs, last))->output();
+                }
+                if (ret)
+                    continue;
             }
             /*if ((inst_list[i])->isAdd()) 
             {
@@ -571,11 +822,33 @@ void MachineFunction::output()
     // Traverse all the block in block_list to print assembly code.
     MachineOperand *fp = new MachineOperand(MachineOperand::REG, 11);
     MachineOperand *sp = new MachineOperand(MachineOperand::REG, 13);
-    MachineOperand *lr = new MachineOperand(MachineOperand::REG, 14);
-    (new StackMInstrcuton(nullptr, StackMInstrcuton::PUSH, getSavedRegs(), fp, lr)) ->output();
-    (new MovMInstruction(nullptr, MovMInstruction::MOV, fp, sp))->output();
+    layoutFrame();
+    auto fregs = getSavedFRegs();
+    if (!fregs.empty())
+    {
+        MachineOperand *last = fregs.back();
+        fregs.pop_back();
+        (new StackMInstrcuton(nullptr, StackMInstrcuton::VPUSH, fregs, last))->output();
+    }
+    auto regs = getFrameRegs();
+    if (!regs.empty())
+    {
+        MachineOperand *last = regs.back();
+        regs.pop_back();
+        (new StackMInstrcuton(nullptr, StackMInstrcuton::PUSH, regs, last))->output();
+    }
+    if (frame_pointer)
+        (new MovMInstruction(nullptr, MovMInstruction::MOV, fp, sp))->output();
 
-    (new BinaryMInstruction(nullptr, BinaryMInstruction::SUB, sp, sp, new MachineOperand(MachineOperand::IMM, AllocSpace(0))))->output();
+    if (AllocSpace(0) != 0 && MachineOperand::isEncodableImm(AllocSpace(0)))
+        (new BinaryMInstruction(nullptr, BinaryMInstruction::SUB, sp, sp, new MachineOperand(MachineOperand::IMM, AllocSpace(0))))->output();
+    else if (AllocSpace(0) != 0)
+    {
+        // large frames: the size goes through ip, which is free in the prologue
+        MachineOperand *ip = new MachineOperand(MachineOperand::REG, 12);
+        (new MovMInstruction(nullptr, MovMInstruction::MOV, ip, new MachineOperand(MachineOperand::IMM, AllocSpace(0))))->output();
+        (new BinaryMInstruction(nullptr, BinaryMInstruction::SUB, sp, sp, new MachineOperand(*ip)))->output();
+    }
     
     for(auto iter : block_list)
         iter->output();
@@ -583,6 +856,37 @@ void MachineFunction::output()
     //(new StackMInstrcuton(nullptr, StackMInstrcuton::POP, getSavedRegs(), fp, lr)) ->output();
 }
 
+// Leaf functions keep lr in place, and fp is only set up when the frame
+// has slots, parameters are passed on the stack, or code addresses it.
+void MachineFunction::layoutFrame()
+{
+    leaf = true;
+    frame_pointer = AllocSpace(0) > 0 || paramsNum > 4;
+    for (auto &block : block_list)
+        for (auto &inst : block->getInsts())
+        {
+            if (inst->isCall())
+                leaf = false;
+            if (isFrameRestore(inst))
+                continue;
+            for (auto &ops : {inst->getDef(), inst->getUse()})
+                for (auto &op : ops)
+                    if (op->isReg() && op->getReg() == 11)
+                        frame_pointer = true;
+        }
+}
+
+// registers pushed by the prologue; when popped to return, lr goes to pc
+std::vector<MachineOperand*> MachineFunction::getFrameRegs(bool ret)
+{
+    std::vector<MachineOperand*> regs = getSavedRegs();
+    if (frame_pointer)
+        regs.push_back(new MachineOperand(MachineOperand::REG, 11));
+    if (!leaf)
+        regs.push_back(new MachineOperand(MachineOperand::REG, ret ? 15 : 14));
+    return regs;
+}
+
 std::vector<MachineOperand*> MachineFunction::getSavedRegs() 
 {
     std::vector<MachineOperand*> regs;
@@ -593,6 +897,29 @@ std::vector<MachineOperand*> MachineFunction::getSavedRegs()
     }
     return regs;
 }
+
+// vpush/vpop take a consecutive list, so s16 up to the highest one used
+std::vector<MachineOperand*> MachineFunction::getSavedFRegs()
+{
+    std::vector<MachineOperand*> regs;
+    if (!saved_fregs.empty())
+        for (int reg = 16; reg <= *saved_fregs.rbegin(); reg++)
+            regs.push_back(new MachineOperand(MachineOperand::REG, reg, true));
+    return regs;
+}
+
+// the initial value of a global as the word to emit, converted to its type
+static int initWord(SymbolEntry *se, ConstantSymbolEntry *con)
+{
+    if (se->getType()->isFloat() == con->getType()->isFloat())
+        return con->getValue();
+    if (con->getType()->isFloat())
+        return (int)con->getFloatValue();
+    float value = con->getValue();
+    int word;
+    memcpy(&word, &value, sizeof(word));
+    return word;
+}
     
 void MachineUnit::PrintGlobalDecl()
 {
@@ -614,12 +941,12 @@ void MachineUnit::PrintGlobalDecl()
                 constIdx.push_back(i);
             }  
             
-            else if(se->getType()==TypeSystem::intType)
+            else if(se->getType()==TypeSystem::intType || se->getType()==TypeSystem::floatType)
             {
                 fprintf(yyout, ".global %s\n", se->toStr().c_str());
                 fprintf(yyout, ".size %s, %d\n", se->toStr().c_str(), 4);
                 fprintf(yyout, "%s:\n", se->toStr().c_str());
-                fprintf(yyout, "\t.word %d\n", con->getValue());
+                fprintf(yyout, "\t.word %d\n", initWord(se, con));
             }
         }
         else if (se->getIsArr()) 
@@ -656,7 +983,7 @@ void MachineUnit::PrintGlobalDecl()
                 fprintf(yyout, ".size %s, %d\n", se->toStr().c_str(), 4);
             if(nu){
                 fprintf(yyout, "%s:\n", se->toStr().c_str());
-                fprintf(yyout, "\t.word %d\n", con->getValue());
+                fprintf(yyout, "\t.word %d\n", initWord(se, con));
             }
         }
     }
@@ -670,17 +997,6 @@ void MachineUnit::insertGlobal(SymbolEntry* se, ExprNode* nu)
     glonum_list.push_back(nu);
 }
 
-void MachineUnit::printGlobal()
-{
-    for (auto s : global_list) {
-        IdentifierSymbolEntry* se = (IdentifierSymbolEntry*)s;
-        fprintf(yyout, "addr_%s:\n", se->toStr().c_str());
-        fprintf(yyout, "\t.word %s\n", se->toStr().c_str());
-    }
-    gnumber++;
-}
-
-
 void MachineUnit::output()
 {
     // TODO
@@ -691,13 +1007,13 @@ void MachineUnit::output()
     fprintf(yyout, "\t.arch armv8-a\n");
     fprintf(yyout, "\t.arch_extension crc\n");
     fprintf(yyout, "\t.arm\n");
+    fprintf(yyout, "\t.fpu neon-fp-armv8\n");
     PrintGlobalDecl();
     fprintf(yyout, "\t.text\n");
     if(func_list.empty()) std::cout<<"empty function list"<<std::endl;
     for(auto iter : func_list){
         iter->output();
     }
-    printGlobal();
 }
 
 
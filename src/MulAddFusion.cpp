@@ -0,0 +1,81 @@
+#include "MulAddFusion.h"
+#include "MachineCode.h"
+
+void MulAddFusion::pass()
+{
+    for (auto &func : unit->getFuncs())
+        pass(func);
+}
+
+void MulAddFusion::pass(MachineFunction *func)
+{
+    countOperands(func);
+    for (auto &block : func->getBlocks())
+        for (size_t i = 0; i < block->getInsts().size();)
+            if (!fuse(block, i))
+                i++;
+}
+
+void MulAddFusion::countOperands(MachineFunction *func)
+{
+    defs.clear();
+    uses.clear();
+    for (auto &block : func->getBlocks())
+        for (auto &inst : block->getInsts())
+        {
+            for (auto &def : inst->getDef())
+                if (def->isVReg())
+                    defs[def->getReg()]++;
+            for (auto &use : inst->getUse())
+                if (use->isVReg())
+                    uses[use->getReg()]++;
+        }
+}
+
+// add d, p, c / add d, c, p -> mla d, a, b, c
+// sub d, c, p               -> mls d, a, b, c
+// where p = mul a, b earlier in the block is used nowhere else, and a and b
+// still hold the same values at the add.
+bool MulAddFusion::fuse(MachineBlock *block, size_t i)
+{
+    auto &insts = block->getInsts();
+    MachineInstruction *inst = insts[i];
+    if (!inst->isBinary() || inst->getCond() != MachineInstruction::NONE)
+        return false;
+    int op = inst->getOp();
+    if (op != BinaryMInstruction::ADD && op != BinaryMInstruction::SUB)
+        return false;
+    for (int k = op == BinaryMInstruction::ADD ? 0 : 1; k < 2; k++)
+    {
+        MachineOperand *prod = inst->getUse()[k];
+        MachineOperand *acc = inst->getUse()[1 - k];
+        if (!prod->isVReg() || prod->isShifted() || acc->isImm() || acc->isShifted())
+            continue;
+        if (defs[prod->getReg()] != 1 || uses[prod->getReg()] != 1)
+            continue;
+        size_t j = i;
+        while (j-- > 0)
+        {
+            MachineInstruction *mul = insts[j];
+            if (mul->getDef().empty() || !(*mul->getDef()[0] == *prod))
+                continue;
+            if (!mul->isBinary() || mul->getOp() != BinaryMInstruction::MUL || mul->getCond() != MachineInstruction::NONE)
+                break;
+            MachineOperand *a = mul->getUse()[0], *b = mul->getUse()[1];
+            if (!a->isVReg() || !b->isVReg())
+                break;
+            bool clobbered = false;
+            for (size_t m = j + 1; m < i && !clobbered; m++)
+                for (auto &def : insts[m]->getDef())
+                    if (*def == *a || *def == *b)
+                        clobbered = true;
+            if (clobbered)
+                break;
+            int mop = op == BinaryMInstruction::ADD ? MlaMInstruction::MLA : MlaMInstruction::MLS;
+            insts[i] = new MlaMInstruction(block, mop, inst->getDef()[0], a, b, acc);
+            insts.erase(insts.begin() + j);
+            return true;
+        }
+    }
+    return false;
+}
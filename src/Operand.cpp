@@ -1,4 +1,5 @@
 #include "Operand.h"
+#include "Instruction.h"
 #include <sstream>
 #include <algorithm>
 #include <string.h>
@@ -8,10 +9,70 @@ std::string Operand::toStr() const
     return se->toStr();
 }
 
+// the result of a call counts as the type the function returns
+bool Operand::isFloat()
+{
+    Type *type = se->getType();
+    if (type->isFunc())
+        type = dynamic_cast<FunctionType*>(type)->getRetType();
+    return type->isFloat();
+}
+
+void Operand::link(Use *use)
+{
+    use->value = this;
+    use->prev = nullptr;
+    use->next = uses;
+    if (uses != nullptr)
+        uses->prev = use;
+    uses = use;
+    num_uses++;
+}
+
+void Operand::unlink(Use *use)
+{
+    if (use->prev != nullptr)
+        use->prev->next = use->next;
+    else
+        uses = use->next;
+    if (use->next != nullptr)
+        use->next->prev = use->prev;
+    use->prev = use->next = nullptr;
+    num_uses--;
+}
+
+void Operand::addUse(Instruction *inst)
+{
+    Use *use = new Use(inst, this);
+    link(use);
+    inst->addUseNode(use);
+}
+
+// remove one use of this operand by inst, the lookup only scans the uses held by inst.
 void Operand::removeUse(Instruction *inst)
 {
-    auto i = std::find(uses.begin(), uses.end(), inst);
-    if(i != uses.end())
-        uses.erase(i);
+    Use *use = inst->findUseNode(this);
+    if (use != nullptr)
+        removeUse(use);
+}
+
+void Operand::removeUse(Use *use)
+{
+    unlink(use);
+    use->getUser()->removeUseNode(use);
+    delete use;
 }
 
+// make every instruction using this operand use rep instead.
+void Operand::replaceAllUsesWith(Operand *rep)
+{
+    if (rep == this)
+        return;
+    while (uses != nullptr)
+    {
+        Use *use = uses;
+        unlink(use);
+        rep->link(use);
+        use->getUser()->replaceOperand(this, rep);
+    }
+}
@@ -0,0 +1,165 @@
+#include "Peephole.h"
+#include "MachineCode.h"
+
+const Peephole::Rule Peephole::rules[] = {
+    {"store-to-load forwarding", &Peephole::forwardStore},
+    {"redundant move", &Peephole::removeMove},
+    {"zero immediate", &Peephole::removeZeroImm},
+    {"redundant compare", &Peephole::removeCmp},
+};
+const size_t Peephole::numRules = sizeof(rules) / sizeof(rules[0]);
+
+void Peephole::pass()
+{
+    for (auto &func : unit->getFuncs())
+        for (auto &block : func->getBlocks())
+            pass(block);
+}
+
+// Rules are tried in table order at each instruction; after a rewrite the
+// same position is examined again, as the rewrite may enable another one.
+void Peephole::pass(MachineBlock *block)
+{
+    for (size_t i = 0; i < block->getInsts().size();)
+    {
+        size_t r = 0;
+        while (r < numRules && !(this->*rules[r].rewrite)(block, i))
+            r++;
+        if (r < numRules)
+            counts[r]++;
+        else
+            i++;
+    }
+}
+
+void Peephole::report()
+{
+    for (size_t r = 0; r < numRules; r++)
+        fprintf(stderr, "peephole: %-26s %d\n", rules[r].name, counts[r]);
+}
+
+// str and ldr through the same base register and immediate offset
+bool Peephole::sameAddress(MachineInstruction *store, MachineInstruction *load)
+{
+    auto &s = store->getUse(), &l = load->getUse();
+    if (s.size() != l.size() + 1 || !s[1]->isReg() || !l[0]->isReg() || !(*s[1] == *l[0]))
+        return false;
+    return s.size() == 2 || (s[2]->isImm() && l[1]->isImm() && s[2]->getVal() == l[1]->getVal());
+}
+
+bool Peephole::writes(MachineInstruction *inst, MachineOperand *reg)
+{
+    for (auto &def : inst->getDef())
+        if (*def == *reg)
+            return true;
+    return false;
+}
+
+// str rX, [rB, #n] ... ldr rY, [rB, #n] -> str rX, [rB, #n] ... mov rY, rX
+// as long as nothing in between stores, branches, or writes rX or rB.
+bool Peephole::forwardStore(MachineBlock *block, size_t i)
+{
+    auto &insts = block->getInsts();
+    MachineInstruction *store = insts[i];
+    if (!store->isStore() || store->getCond() != MachineInstruction::NONE)
+        return false;
+    MachineOperand *src = store->getUse()[0], *base = store->getUse()[1];
+    if (!src->isReg() || !base->isReg())
+        return false;
+    for (size_t j = i + 1; j < insts.size(); j++)
+    {
+        MachineInstruction *inst = insts[j];
+        if (inst->isLoad() && inst->getCond() == MachineInstruction::NONE && sameAddress(store, inst))
+        {
+            MachineOperand *dst = inst->getDef()[0];
+            if (*dst == *src)
+                insts.erase(insts.begin() + j);
+            else
+                insts[j] = new MovMInstruction(block, MovMInstruction::MOV, new MachineOperand(*dst), new MachineOperand(*src));
+            return true;
+        }
+        if (inst->isStore() || inst->isVector() || inst->isBranch() || inst->isStack() || writes(inst, src) || writes(inst, base))
+            return false;
+    }
+    return false;
+}
+
+// mov rX, rX is dropped, so is mov rY, rX right after mov rX, rY
+bool Peephole::removeMove(MachineBlock *block, size_t i)
+{
+    auto &insts = block->getInsts();
+    MachineInstruction *mov = insts[i];
+    if (!mov->isMov() || mov->getOp() != MovMInstruction::MOV)
+        return false;
+    MachineOperand *dst = mov->getDef()[0], *src = mov->getUse()[0];
+    if (!src->isReg() || src->isShifted())
+        return false;
+    bool redundant = *dst == *src;
+    if (!redundant && i > 0 && mov->getCond() == MachineInstruction::NONE)
+    {
+        MachineInstruction *prev = insts[i - 1];
+        redundant = prev->isMov() && prev->getOp() == MovMInstruction::MOV && prev->getCond() == MachineInstruction::NONE &&
+                    prev->getUse()[0]->isReg() && !prev->getUse()[0]->isShifted() &&
+                    *prev->getDef()[0] == *src && *prev->getUse()[0] == *dst;
+    }
+    if (redundant)
+        insts.erase(insts.begin() + i);
+    return redundant;
+}
+
+// add/sub/orr/lsl/lsr/asr rX, rY, #0 -> mov rX, rY, or nothing when rX is rY
+bool Peephole::removeZeroImm(MachineBlock *block, size_t i)
+{
+    auto &insts = block->getInsts();
+    MachineInstruction *inst = insts[i];
+    if (!inst->isBinary())
+        return false;
+    switch (inst->getOp())
+    {
+    case BinaryMInstruction::ADD:
+    case BinaryMInstruction::SUB:
+    case BinaryMInstruction::OR:
+    case BinaryMInstruction::LSL:
+    case BinaryMInstruction::LSR:
+    case BinaryMInstruction::ASR:
+        break;
+    default:
+        return false;
+    }
+    MachineOperand *dst = inst->getDef()[0], *src = inst->getUse()[0], *imm = inst->getUse()[1];
+    if (!imm->isImm() || imm->getVal() != 0 || !src->isReg() || src->isShifted())
+        return false;
+    if (*dst == *src)
+        insts.erase(insts.begin() + i);
+    else
+        insts[i] = new MovMInstruction(block, MovMInstruction::MOV, new MachineOperand(*dst), new MachineOperand(*src), inst->getCond());
+    return true;
+}
+
+// a cmp of the same operands as the last cmp, neither of them written since
+bool Peephole::removeCmp(MachineBlock *block, size_t i)
+{
+    auto &insts = block->getInsts();
+    MachineInstruction *cmp = insts[i];
+    if (!cmp->isCmp())
+        return false;
+    auto &ops = cmp->getUse();
+    for (auto &op : ops)
+        if (op->isShifted())
+            return false;
+    for (size_t j = i; j-- > 0;)
+    {
+        MachineInstruction *inst = insts[j];
+        if (inst->isCmp())
+        {
+            auto &prev = inst->getUse();
+            if (prev[0]->isShifted() || prev[1]->isShifted() || !(*prev[0] == *ops[0]) || !(*prev[1] == *ops[1]))
+                return false;
+            insts.erase(insts.begin() + i);
+            return true;
+        }
+        if (inst->isBranch() || inst->isStack() || writes(inst, ops[0]) || writes(inst, ops[1]))
+            return false;
+    }
+    return false;
+}
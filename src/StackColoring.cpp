@@ -0,0 +1,172 @@
+#include "StackColoring.h"
+#include "MachineCode.h"
+#include <vector>
+#include <algorithm>
+
+void StackColoring::pass()
+{
+    for (auto &func : unit->getFuncs())
+        pass(func);
+}
+
+void StackColoring::pass(MachineFunction *func)
+{
+    this->func = func;
+    words.clear();
+    liveIn.clear();
+    liveOut.clear();
+    interference.clear();
+    if (!collectSlots() || words.size() < 2)
+        return;
+    computeLiveness();
+    buildInterference();
+    assignSlots();
+}
+
+// ldr/str [fp, #offset]
+bool StackColoring::frameAccess(MachineInstruction *inst, int &offset)
+{
+    auto &uses = inst->getUse();
+    size_t base = inst->isStore() ? 1 : 0;
+    if ((!inst->isLoad() && !inst->isStore()) || uses.size() != base + 2)
+        return false;
+    if (!uses[base]->isReg() || uses[base]->getReg() != 11 || !uses[base + 1]->isImm())
+        return false;
+    offset = uses[base + 1]->getVal();
+    return true;
+}
+
+// The word slots are locals and spills only ever accessed as a whole,
+// through fp and a constant offset. A word whose address is formed is
+// left where it is, as is the whole frame if fp is used in any other way.
+bool StackColoring::collectSlots()
+{
+    for (auto &slot : func->getSlots())
+        if (slot.second == 4)
+            words.insert(-slot.first);
+    for (auto &block : func->getBlocks())
+        for (auto &inst : block->getInsts())
+        {
+            int offset;
+            if (frameAccess(inst, offset))
+                continue;
+            for (auto &use : inst->getUse())
+            {
+                if (!use->isReg() || use->getReg() != 11)
+                    continue;
+                if (inst->isMov() && inst->getDef()[0]->isReg() && inst->getDef()[0]->getReg() == 13)
+                    continue;
+                auto &uses = inst->getUse();
+                if (!inst->isBinary() || uses.size() != 2 || !uses[1]->isImm() ||
+                    (inst->getOp() != BinaryMInstruction::ADD && inst->getOp() != BinaryMInstruction::SUB))
+                    return false;
+                words.erase(inst->getOp() == BinaryMInstruction::ADD ? uses[1]->getVal() : -uses[1]->getVal());
+            }
+        }
+    return true;
+}
+
+void StackColoring::computeLiveness()
+{
+    std::map<MachineBlock *, std::set<int>> gen, kill;
+    for (auto &block : func->getBlocks())
+        for (auto &inst : block->getInsts())
+        {
+            int offset;
+            if (!frameAccess(inst, offset) || !words.count(offset))
+                continue;
+            if (inst->isLoad() && !kill[block].count(offset))
+                gen[block].insert(offset);
+            else if (inst->isStore() && inst->getCond() == MachineInstruction::NONE)
+                kill[block].insert(offset);
+        }
+    bool change = true;
+    while (change)
+    {
+        change = false;
+        for (auto it = func->getBlocks().rbegin(); it != func->getBlocks().rend(); it++)
+        {
+            MachineBlock *block = *it;
+            std::set<int> out;
+            for (auto &succ : block->getSuccs())
+                out.insert(liveIn[succ].begin(), liveIn[succ].end());
+            std::set<int> in = gen[block];
+            for (auto &offset : out)
+                if (!kill[block].count(offset))
+                    in.insert(offset);
+            liveOut[block] = out;
+            if (in != liveIn[block])
+            {
+                liveIn[block] = in;
+                change = true;
+            }
+        }
+    }
+}
+
+// a store interferes with every other slot live across it
+void StackColoring::buildInterference()
+{
+    for (auto &block : func->getBlocks())
+    {
+        std::set<int> live = liveOut[block];
+        auto &insts = block->getInsts();
+        for (auto it = insts.rbegin(); it != insts.rend(); it++)
+        {
+            int offset;
+            if (!frameAccess(*it, offset) || !words.count(offset))
+                continue;
+            if ((*it)->isStore())
+            {
+                for (auto &other : live)
+                    if (other != offset)
+                    {
+                        interference[offset].insert(other);
+                        interference[other].insert(offset);
+                    }
+                if ((*it)->getCond() == MachineInstruction::NONE)
+                    live.erase(offset);
+            }
+            else
+                live.insert(offset);
+        }
+    }
+}
+
+// Slots are colored greedily, and the colors take the word addresses
+// closest to fp, so the frame shrinks by the slots no longer needed.
+void StackColoring::assignSlots()
+{
+    std::vector<int> addresses(words.rbegin(), words.rend());
+    std::map<int, int> color;
+    for (auto &offset : addresses)
+    {
+        std::set<int> taken;
+        for (auto &other : interference[offset])
+            if (color.count(other))
+                taken.insert(color[other]);
+        int c = 0;
+        while (taken.count(c))
+            c++;
+        color[offset] = c;
+    }
+
+    int size = 0;
+    for (auto &slot : func->getSlots())
+        if (!words.count(-slot.first))
+            size = std::max(size, slot.first);
+    for (auto &offset : addresses)
+        size = std::max(size, -addresses[color[offset]]);
+    func->setStackSize(size);
+
+    for (auto &block : func->getBlocks())
+        for (auto &inst : block->getInsts())
+        {
+            int offset;
+            if (!frameAccess(inst, offset) || !words.count(offset) || addresses[color[offset]] == offset)
+                continue;
+            // spill code shares its offset operands
+            inst->getUse().back() = new MachineOperand(MachineOperand::IMM, addresses[color[offset]]);
+            inst->getUse().back()->setParent(inst);
+        }
+}
@@ -2,6 +2,7 @@
 #include "Type.h"
 #include <iostream>
 #include <sstream>
+#include <string.h>
 
 SymbolEntry::SymbolEntry(Type *type, int kind) 
 {
@@ -14,10 +15,31 @@ ConstantSymbolEntry::ConstantSymbolEntry(Type *type, int value) : SymbolEntry(ty
     this->value = value;
 }
 
+ConstantSymbolEntry::ConstantSymbolEntry(Type *type, float value) : SymbolEntry(type, SymbolEntry::CONSTANT)
+{
+    memcpy(&this->value, &value, sizeof(value));
+}
+
+float ConstantSymbolEntry::getFloatValue() const
+{
+    float f;
+    memcpy(&f, &value, sizeof(f));
+    return f;
+}
+
 std::string ConstantSymbolEntry::toStr()
 {
     std::ostringstream buffer;
-    buffer << value;
+    if (type->isFloat())
+    {
+        // LLVM spells float constants as the hex digits of the equal double
+        double d = getFloatValue();
+        unsigned long long bits;
+        memcpy(&bits, &d, sizeof(bits));
+        buffer << "0x" << std::hex << std::uppercase << bits;
+    }
+    else
+        buffer << value;
     return buffer.str();
 }
 
@@ -25,6 +47,9 @@ IdentifierSymbolEntry::IdentifierSymbolEntry(Type *type, std::string name, int s
 {
     this->scope = scope;
     addr = nullptr;
+    value = nullptr;
+    isArr = false;
+    arrLen = 0;
 }
 
 std::string IdentifierSymbolEntry::toStr()
@@ -0,0 +1,129 @@
+#include "TailCallElimination.h"
+#include "Unit.h"
+
+void TailCallElimination::pass()
+{
+    for (auto func = unit->begin(); func != unit->end(); func++)
+        pass(*func);
+}
+
+// the call is directly followed by a return of its result, or of nothing.
+bool TailCallElimination::isTailCall(CallInstruction *call)
+{
+    Instruction *next = call->getNext();
+    if (next == call->getParent()->end() || !next->isRet())
+        return false;
+    return next->getOperands().empty() || next->getOperands()[0] == call->getDef();
+}
+
+// Arguments beyond r0-r3 and addresses of locals live in the caller's frame,
+// which a sibling call releases.
+bool TailCallElimination::isSiblingCall(CallInstruction *call)
+{
+    if (call->getOperands().size() > 5)
+        return false;
+    for (size_t i = 1; i < call->getOperands().size(); i++)
+        if (call->getOperands()[i]->getType()->isPtr() || call->getOperands()[i]->getType()->isArray())
+            return false;
+    return true;
+}
+
+// The next iteration reuses this frame, so an argument that may point into
+// one of its local arrays would see them overwritten.
+bool TailCallElimination::reusesFrame(CallInstruction *call)
+{
+    if (!localArrays)
+        return false;
+    for (size_t i = 1; i < call->getOperands().size(); i++)
+        if (call->getOperands()[i]->getType()->isPtr() || call->getOperands()[i]->getType()->isArray())
+            return true;
+    return false;
+}
+
+// Split the entry block after the parameter stores, the rest becomes the loop header.
+void TailCallElimination::createHeader()
+{
+    BasicBlock *entry = func->getEntry();
+    header = new BasicBlock(func);
+    auto &blocks = func->getBlockList();
+    blocks.pop_back();
+    blocks.insert(blocks.begin() + 1, header);
+    for (auto inst = entry->begin(); inst != entry->end();)
+    {
+        Instruction *next = inst->getNext();
+        bool isParamStore = false;
+        if (inst->isStore())
+        {
+            auto se = dynamic_cast<IdentifierSymbolEntry *>(inst->getOperands()[1]->getEntry());
+            if (se != nullptr && se->isParam())
+            {
+                paramAddr[se->getParamNo()] = inst->getOperands()[0];
+                isParamStore = true;
+            }
+        }
+        if (!inst->isAlloc() && !isParamStore)
+        {
+            entry->remove(inst);
+            header->insertBack(inst);
+        }
+        inst = next;
+    }
+    while (!entry->succEmpty())
+    {
+        BasicBlock *succ = entry->getSuccB().front();
+        entry->removeSucc(succ);
+        succ->removePred(entry);
+        succ->addPred(header);
+        header->addSucc(succ);
+    }
+    new UncondBrInstruction(header, entry);
+    entry->addSucc(header);
+    header->addPred(entry);
+}
+
+// store the arguments into the parameters and jump back to the header.
+void TailCallElimination::eliminate(CallInstruction *call)
+{
+    if (header == nullptr)
+        createHeader();
+    BasicBlock *bb = call->getParent();
+    auto &ops = call->getOperands();
+    for (size_t i = 1; i < ops.size(); i++)
+        if (paramAddr.count(i - 1))
+            new StoreInstruction(paramAddr[i - 1], ops[i], bb);
+    delete call->getNext();
+    delete call;
+    new UncondBrInstruction(header, bb);
+    bb->addSucc(header);
+    header->addPred(bb);
+}
+
+void TailCallElimination::pass(Function *func)
+{
+    this->func = func;
+    header = nullptr;
+    paramAddr.clear();
+    localArrays = false;
+    for (auto inst = func->getEntry()->begin(); inst != func->getEntry()->end(); inst = inst->getNext())
+        if (inst->isAlloc())
+        {
+            auto se = dynamic_cast<IdentifierSymbolEntry *>(dynamic_cast<AllocaInstruction *>(inst)->getSymPtr());
+            if (se != nullptr && !se->isParam() && se->getType()->isArray())
+                localArrays = true;
+        }
+    std::vector<CallInstruction *> calls;
+    for (auto bb = func->begin(); bb != func->end(); bb++)
+        for (auto inst = (*bb)->begin(); inst != (*bb)->end(); inst = inst->getNext())
+            if (inst->isCall() && isTailCall(dynamic_cast<CallInstruction *>(inst)))
+                calls.push_back(dynamic_cast<CallInstruction *>(inst));
+    for (auto &call : calls)
+    {
+        if (call->getFuncSyt() == func->getSymPtr())
+        {
+            if (!reusesFrame(call))
+                eliminate(call);
+        }
+        else if (isSiblingCall(call))
+            call->setTailCall();
+    }
+}
@@ -5,11 +5,13 @@ ConstIntType TypeSystem::commonConstInt =ConstIntType(32);
 IntType TypeSystem::commonInt = IntType(32);
 IntType TypeSystem::commonBool = IntType(1);
 VoidType TypeSystem::commonVoid = VoidType();
+FloatType TypeSystem::commonFloat = FloatType(32);
 
 Type* TypeSystem::constintType=&commonConstInt;
 Type* TypeSystem::intType = &commonInt;
 Type* TypeSystem::voidType = &commonVoid;
 Type* TypeSystem::boolType = &commonBool;
+Type* TypeSystem::floatType = &commonFloat;
 
 std::string IntType::toStr()
 {
@@ -32,6 +34,11 @@ std::string BoolType::toStr()
     return buffer.str();
 }
 
+std::string FloatType::toStr()
+{
+    return "float";
+}
+
 std::string VoidType::toStr()
 {
     return "void";
@@ -63,7 +70,7 @@ std::string ArrayType::toStr() {
     std::ostringstream buffer;
     for (auto it = vec.begin(); it != vec.end(); it++)
         buffer << *it;
-    buffer << "i32";
+    buffer << temp->toStr();
     while (count--)
         buffer << ']';
     if (flag)
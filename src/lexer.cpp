@@ -355,8 +355,8 @@ static void yynoreturn yy_fatal_error ( const char* msg  );
 	(yy_hold_char) = *yy_cp; \
 	*yy_cp = '\0'; \
 	(yy_c_buf_p) = yy_cp;
-#define YY_NUM_RULES 44
-#define YY_END_OF_BUFFER 45
+#define YY_NUM_RULES 47
+#define YY_END_OF_BUFFER 48
 /* This struct is not used in this scanner,
    but its presence is necessary. */
 struct yy_trans_info
@@ -364,20 +364,22 @@ struct yy_trans_info
 	flex_int32_t yy_verify;
 	flex_int32_t yy_nxt;
 	};
-static const flex_int16_t yy_accept[104] =
+static const flex_int16_t yy_accept[127] =
     {   0,
-        0,    0,    0,    0,   45,   44,   43,   42,   42,   18,
-       20,   44,   29,   30,   25,   23,   27,   24,   26,   37,
-       37,   28,   21,   19,   22,   41,   33,   34,   41,   41,
-       41,   41,   41,   41,   41,   41,   41,   31,   44,   32,
-       42,   14,   12,    0,    1,   36,    0,   37,   16,   15,
-       17,   41,   41,   41,   41,   41,    9,   41,   41,   41,
-       41,   41,   13,    0,    0,    0,    1,   35,   41,   41,
-       41,   41,    7,   41,   41,   41,   41,    2,   41,   41,
-       41,   10,   41,   41,   41,   41,    8,   41,    4,    6,
-       41,   41,   40,   41,   41,    3,   41,   39,   38,   11,
-
-       41,    5,    0
+        0,    0,    0,    0,   48,   47,   46,   45,   45,   19,
+       21,   47,   30,   31,   26,   24,   28,   25,   47,   27,
+       40,   40,   29,   22,   20,   23,   44,   34,   35,   44,
+       44,   44,   44,   44,   44,   44,   44,   44,   44,   32,
+       47,   33,   47,   45,   15,   13,   37,    0,    1,   37,
+       39,    0,    0,    0,   40,   17,   16,   18,   44,   44,
+       44,   44,   44,   44,   10,   44,   44,   44,   44,   44,
+       14,    0,    0,    0,    0,    1,    0,   37,    0,   38,
+       44,   44,   44,   44,   44,    7,   44,   44,   44,   44,
+        0,   37,    0,    2,    0,    0,    0,   44,   44,   44,
+
+       11,   44,   44,   44,   44,   44,    9,   44,    0,   36,
+        4,    6,   44,    8,   44,   43,   44,   44,    3,   44,
+       42,   41,   12,   44,    5,    0
     } ;
 
 static const YY_CHAR yy_ec[256] =
@@ -386,16 +388,16 @@ static const YY_CHAR yy_ec[256] =
         1,    1,    4,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    2,    5,    1,    1,    1,    6,    7,    1,    8,
-        9,   10,   11,   12,   13,    1,   14,   15,   16,   16,
-       16,   16,   16,   16,   16,   17,   17,    1,   18,   19,
-       20,   21,    1,    1,   22,   22,   22,   22,   22,   22,
-       23,   23,   23,   23,   23,   23,   23,   23,   23,   23,
-       23,   23,   23,   23,   23,   23,   23,   24,   23,   23,
-       25,    1,   26,    1,   23,    1,   27,   28,   29,   30,
-
-       31,   32,   33,   34,   35,   23,   36,   37,   23,   38,
-       39,   40,   23,   41,   42,   43,   44,   45,   46,   24,
-       23,   23,   47,   48,   49,    1,    1,    1,    1,    1,
+        9,   10,   11,   12,   13,   14,   15,   16,   17,   17,
+       17,   17,   17,   17,   17,   18,   18,    1,   19,   20,
+       21,   22,    1,    1,   23,   23,   23,   23,   24,   23,
+       25,   25,   25,   25,   25,   25,   25,   25,   25,   26,
+       25,   25,   25,   25,   25,   25,   25,   27,   25,   25,
+       28,    1,   29,    1,   25,    1,   30,   31,   32,   33,
+
+       34,   35,   36,   37,   38,   25,   39,   40,   25,   41,
+       42,   43,   25,   44,   45,   46,   47,   48,   49,   27,
+       25,   25,   50,   51,   52,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
@@ -412,93 +414,158 @@ static const YY_CHAR yy_ec[256] =
         1,    1,    1,    1,    1
     } ;
 
-static const YY_CHAR yy_meta[50] =
+static const YY_CHAR yy_meta[53] =
     {   0,
-        1,    1,    2,    2,    1,    1,    1,    2,    2,    1,
-        1,    1,    1,    1,    3,    3,    3,    1,    1,    1,
-        1,    3,    4,    4,    1,    1,    3,    3,    3,    3,
-        3,    3,    4,    4,    4,    4,    4,    4,    4,    4,
-        4,    4,    4,    4,    4,    4,    1,    2,    1
+        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+        1,    1
     } ;
 
-static const flex_int16_t yy_base[110] =
+static const flex_int16_t yy_base[127] =
     {   0,
-        0,    0,    0,    0,  139,  140,  140,  140,  135,  117,
-      140,  129,  140,  140,  140,  140,  140,  140,   40,   36,
-       40,  140,  115,  114,  113,    0,  140,  140,   91,   92,
-       93,   98,   21,   84,   96,   87,   91,  140,   76,  140,
-      140,  140,  140,   48,    0,   48,    0,   50,  140,  140,
-      140,    0,   92,   84,   79,   77,    0,   76,   75,   74,
-       81,   80,  140,   58,   59,   60,    0,    0,   87,   33,
-       82,   77,    0,   42,   67,   80,   72,  140,   72,   64,
-       71,    0,   67,   70,   65,   61,    0,   70,    0,    0,
-       62,   56,    0,   55,   59,    0,   52,    0,    0,    0,
-
-       58,    0,  140,   77,   79,   83,   87,   58,   91
+        0,    0,   51,    0,  104,  407,  407,  407,  102,   85,
+      407,  100,  407,  407,  407,  407,  407,  407,   92,  101,
+      101,   96,  407,   99,  100,  101,  113,  407,  407,   80,
+       84,   87,   92,   99,  128,   87,  107,  100,  127,  407,
+      114,  407,  407,  407,  407,  407,  142,  176,  228,    0,
+      140,  154,  268,  273,    0,  407,  407,  407,    0,  134,
+      131,  128,  132,  129,    0,  185,  186,  190,  199,  244,
+      407,  282,    0,  308,    0,    0,  281,    0,  345,  356,
+      253,  256,  254,  288,  326,    0,  333,  319,  334,  332,
+      370,    0,    0,  407,  347,    0,  375,  335,  338,  347,
+
+        0,  341,  348,  357,  354,  352,    0,  363,  387,    0,
+        0,    0,  360,    0,  356,    0,  357,  363,    0,  358,
+        0,    0,    0,  372,    0,  407
     } ;
 
-static const flex_int16_t yy_def[110] =
+static const flex_int16_t yy_def[127] =
     {   0,
-      103,    1,  104,  104,  103,  103,  103,  103,  103,  103,
-      103,  103,  103,  103,  103,  103,  103,  103,  103,  103,
-      103,  103,  103,  103,  103,  105,  103,  103,  105,  105,
-      105,  105,  105,  105,  105,  105,  105,  103,  103,  103,
-      103,  103,  103,  106,  107,  103,  108,  103,  103,  103,
-      103,  105,  105,  105,  105,  105,  105,  105,  105,  105,
-      105,  105,  103,  106,  109,  106,  107,  108,  105,  105,
-      105,  105,  105,  105,  105,  105,  105,  103,  105,  105,
-      105,  105,  105,  105,  105,  105,  105,  105,  105,  105,
-      105,  105,  105,  105,  105,  105,  105,  105,  105,  105,
-
-      105,  105,    0,  103,  103,  103,  103,  103,  103
+      126,    1,    1,    3,  126,  126,  126,  126,  126,  126,
+      126,  126,  126,  126,  126,  126,  126,  126,  126,  126,
+      126,   21,  126,  126,  126,  126,  126,  126,  126,   27,
+       27,   27,   27,   27,   27,   27,   27,   27,   27,  126,
+      126,  126,  126,  126,  126,  126,   19,  126,  126,   47,
+       21,   51,  126,  126,   22,  126,  126,  126,   27,   27,
+       27,   27,   27,   27,   27,   27,   27,   27,   27,   27,
+      126,  126,   48,   48,   48,   49,   53,   77,  126,   54,
+       27,   27,   27,   27,   27,   27,   27,   27,   27,   27,
+       72,   91,   48,  126,   79,   95,  126,   27,   27,   27,
+
+       27,   27,   27,   27,   27,   27,   27,   27,   97,  109,
+       27,   27,   27,   27,   27,   27,   27,   27,   27,   27,
+       27,   27,   27,   27,   27,    0
     } ;
 
-static const flex_int16_t yy_nxt[190] =
+static const flex_int16_t yy_nxt[460] =
     {   0,
         6,    7,    8,    9,   10,   11,   12,   13,   14,   15,
-       16,   17,   18,   19,   20,   21,   21,   22,   23,   24,
-       25,   26,   26,   26,   27,   28,   26,   29,   30,   26,
-       31,   26,   32,   26,   33,   26,   26,   26,   26,   34,
-       35,   26,   26,   26,   36,   37,   38,   39,   40,   44,
-       46,   46,   57,   45,   48,   48,   48,   65,   58,   47,
-       68,   66,   46,   46,   48,   48,   48,   65,   65,   65,
-       84,   66,   78,   66,   80,   81,   85,    6,    6,    6,
-        6,   52,   52,   64,   64,   64,   64,   67,  102,   67,
-       67,   66,   66,   66,   66,  101,  100,   99,   98,   97,
-
-       96,   95,   94,   93,   92,   91,   90,   89,   88,   87,
-       86,   83,   82,   79,   77,   76,   75,   74,   73,   72,
-       71,   70,   69,   63,   62,   61,   60,   59,   56,   55,
-       54,   53,   51,   50,   49,   43,   42,   41,  103,    5,
-      103,  103,  103,  103,  103,  103,  103,  103,  103,  103,
-      103,  103,  103,  103,  103,  103,  103,  103,  103,  103,
-      103,  103,  103,  103,  103,  103,  103,  103,  103,  103,
-      103,  103,  103,  103,  103,  103,  103,  103,  103,  103,
-      103,  103,  103,  103,  103,  103,  103,  103,  103
+       16,   17,   18,   19,   20,   21,   22,   22,   23,   24,
+       25,   26,   27,   27,   27,   27,   27,   28,   29,   27,
+       30,   31,   27,   32,   33,   34,   27,   35,   27,   27,
+       27,   27,   36,   37,   27,   27,   27,   38,   39,   40,
+       41,   42,    6,   43,    6,    6,    6,    6,    6,    6,
+        6,    6,    6,    6,    6,    6,    6,    6,    6,    6,
+        6,    6,    6,    6,    6,    6,    6,    6,    6,    6,
+        6,    6,    6,    6,    6,    6,    6,    6,    6,    6,
+        6,    6,    6,    6,    6,    6,    6,    6,    6,    6,
+
+        6,    6,    6,  126,   44,   45,   46,   47,   47,   47,
+       48,   55,   55,   55,   50,   49,   51,   51,   52,   56,
+       57,   58,  126,   60,   53,   61,   62,   54,   59,   59,
+       59,   63,   64,   67,   53,   59,   59,   59,   59,   59,
+       68,   69,   59,   59,   59,   59,   59,   59,   59,   59,
+       59,   59,   59,   59,   59,   59,   59,   59,   59,   59,
+       59,   59,   65,   70,   71,   72,  126,   81,   66,   52,
+       52,   82,   83,   84,   85,   72,   73,   73,   73,   73,
+       73,   73,   73,   73,   73,   74,   73,   73,   73,   73,
+       75,   73,   73,   73,   73,   73,   73,   73,   73,   73,
+
+       73,   73,   73,   73,   73,   73,   73,   73,   73,   73,
+       73,   73,   73,   73,   73,   73,   73,   73,   73,   73,
+       73,   73,   73,   73,   73,   73,   73,   73,   76,   76,
+       86,   87,   76,   76,   76,   88,   89,   76,   76,   76,
+       76,   76,   76,   76,   76,   76,   76,   76,   76,   76,
+       76,   76,   76,   76,   76,   76,   76,   76,   76,   76,
+       76,   76,   76,   76,   76,   76,   76,   76,   76,   76,
+       76,   76,   76,   76,   76,   76,   76,   76,   77,   76,
+       77,   90,   98,   78,   78,   78,   79,  101,   80,   80,
+       80,  126,   91,  126,   91,   80,   80,   92,   92,   92,
+
+       99,  100,   80,   80,   80,   80,   80,   80,   93,   93,
+       93,   93,   93,   93,   93,   93,   93,  102,   93,   93,
+       93,   93,   94,   93,   93,   93,   93,   93,   93,   93,
+       93,   93,   93,   93,   93,   93,   93,   93,   93,   93,
+       93,   93,   93,   93,   93,   93,   93,   93,   93,   93,
+       93,   93,   93,   93,   93,   93,   93,   93,   93,   93,
+       95,   95,   95,  103,  104,  106,  107,   95,   95,   96,
+      105,  108,   97,  111,   95,   95,   95,   95,   95,   95,
+      126,   97,  126,  112,  113,  109,  114,  109,  115,   97,
+      110,  110,  110,  116,  117,  118,  119,  126,   97,  126,
+
+      120,  121,  122,  123,  124,  125,    5,  126,  126,  126,
+      126,  126,  126,  126,  126,  126,  126,  126,  126,  126,
+      126,  126,  126,  126,  126,  126,  126,  126,  126,  126,
+      126,  126,  126,  126,  126,  126,  126,  126,  126,  126,
+      126,  126,  126,  126,  126,  126,  126,  126,  126,  126,
+      126,  126,  126,  126,  126,  126,  126,  126,  126
     } ;
 
-static const flex_int16_t yy_chk[190] =
+static const flex_int16_t yy_chk[460] =
     {   0,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,   19,
-       20,   20,   33,   19,   21,   21,   21,   44,   33,   20,
-      108,   44,   46,   46,   48,   48,   48,   64,   65,   66,
-       74,   64,   65,   66,   70,   70,   74,  104,  104,  104,
-      104,  105,  105,  106,  106,  106,  106,  107,  101,  107,
-      107,  109,  109,  109,  109,   97,   95,   94,   92,   91,
-
-       88,   86,   85,   84,   83,   81,   80,   79,   77,   76,
-       75,   72,   71,   69,   62,   61,   60,   59,   58,   56,
-       55,   54,   53,   39,   37,   36,   35,   34,   32,   31,
-       30,   29,   25,   24,   23,   12,   10,    9,    5,  103,
-      103,  103,  103,  103,  103,  103,  103,  103,  103,  103,
-      103,  103,  103,  103,  103,  103,  103,  103,  103,  103,
-      103,  103,  103,  103,  103,  103,  103,  103,  103,  103,
-      103,  103,  103,  103,  103,  103,  103,  103,  103,  103,
-      103,  103,  103,  103,  103,  103,  103,  103,  103
+        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+        1,    1,    3,    3,    3,    3,    3,    3,    3,    3,
+        3,    3,    3,    3,    3,    3,    3,    3,    3,    3,
+        3,    3,    3,    3,    3,    3,    3,    3,    3,    3,
+        3,    3,    3,    3,    3,    3,    3,    3,    3,    3,
+        3,    3,    3,    3,    3,    3,    3,    3,    3,    3,
+
+        3,    3,    3,    5,    9,   10,   12,   19,   19,   19,
+       20,   22,   22,   22,   21,   20,   21,   21,   21,   24,
+       25,   26,   22,   30,   21,   31,   32,   21,   27,   27,
+       27,   33,   34,   36,   21,   27,   27,   27,   27,   27,
+       37,   38,   27,   27,   27,   27,   27,   27,   27,   27,
+       27,   27,   27,   27,   27,   27,   27,   27,   27,   27,
+       27,   27,   35,   39,   41,   47,   51,   60,   35,   52,
+       52,   61,   62,   63,   64,   47,   48,   48,   48,   48,
+       48,   48,   48,   48,   48,   48,   48,   48,   48,   48,
+       48,   48,   48,   48,   48,   48,   48,   48,   48,   48,
+
+       48,   48,   48,   48,   48,   48,   48,   48,   48,   48,
+       48,   48,   48,   48,   48,   48,   48,   48,   48,   48,
+       48,   48,   48,   48,   48,   48,   48,   48,   49,   49,
+       66,   67,   49,   49,   49,   68,   69,   49,   49,   49,
+       49,   49,   49,   49,   49,   49,   49,   49,   49,   49,
+       49,   49,   49,   49,   49,   49,   49,   49,   49,   49,
+       49,   49,   49,   49,   49,   49,   49,   49,   49,   49,
+       49,   49,   49,   49,   49,   49,   49,   49,   53,   49,
+       53,   70,   81,   53,   53,   53,   54,   83,   54,   54,
+       54,   77,   72,   77,   72,   54,   54,   72,   72,   72,
+
+       82,   82,   54,   54,   54,   54,   54,   54,   74,   74,
+       74,   74,   74,   74,   74,   74,   74,   84,   74,   74,
+       74,   74,   74,   74,   74,   74,   74,   74,   74,   74,
+       74,   74,   74,   74,   74,   74,   74,   74,   74,   74,
+       74,   74,   74,   74,   74,   74,   74,   74,   74,   74,
+       74,   74,   74,   74,   74,   74,   74,   74,   74,   74,
+       79,   79,   79,   85,   87,   88,   89,   79,   79,   80,
+       87,   90,   95,   98,   79,   79,   79,   79,   79,   79,
+       91,   80,   91,   99,  100,   97,  102,   97,  103,   95,
+       97,   97,   97,  104,  105,  106,  108,  109,   80,  109,
+
+      113,  115,  117,  118,  120,  124,  126,  126,  126,  126,
+      126,  126,  126,  126,  126,  126,  126,  126,  126,  126,
+      126,  126,  126,  126,  126,  126,  126,  126,  126,  126,
+      126,  126,  126,  126,  126,  126,  126,  126,  126,  126,
+      126,  126,  126,  126,  126,  126,  126,  126,  126,  126,
+      126,  126,  126,  126,  126,  126,  126,  126,  126
     } ;
 
 static yy_state_type yy_last_accepting_state;
@@ -533,9 +600,11 @@ char *yytext;
         std::string DEBUG_INFO = "[DEBUG LAB4]: \t" + s + "\n";
         fputs(DEBUG_INFO.c_str(), yyout);
     }
-#line 537 "src/lexer.cpp"
 
-#line 539 "src/lexer.cpp"
+    void declareRuntime(const char *name);
+#line 606 "src/lexer.cpp"
+
+#line 608 "src/lexer.cpp"
 
 #define INITIAL 0
 #define BLOCKCOMMENT 1
@@ -753,10 +822,10 @@ YY_DECL
 		}
 
 	{
-#line 32 "src/lexer.l"
+#line 36 "src/lexer.l"
 
 
-#line 760 "src/lexer.cpp"
+#line 829 "src/lexer.cpp"
 
 	while ( /*CONSTCOND*/1 )		/* loops until end-of-file is reached */
 		{
@@ -783,13 +852,13 @@ yy_match:
 			while ( yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state )
 				{
 				yy_current_state = (int) yy_def[yy_current_state];
-				if ( yy_current_state >= 104 )
+				if ( yy_current_state >= 127 )
 					yy_c = yy_meta[yy_c];
 				}
 			yy_current_state = yy_nxt[yy_base[yy_current_state] + yy_c];
 			++yy_cp;
 			}
-		while ( yy_base[yy_current_state] != 140 );
+		while ( yy_base[yy_current_state] != 407 );
 
 yy_find_action:
 		yy_act = yy_accept[yy_current_state];
@@ -815,18 +884,18 @@ do_action:	/* This label is used only to access EOF actions. */
 
 case 1:
 YY_RULE_SETUP
-#line 34 "src/lexer.l"
+#line 38 "src/lexer.l"
 yylineno--;
 	YY_BREAK
 case 2:
 /* rule 2 can match eol */
 YY_RULE_SETUP
-#line 35 "src/lexer.l"
+#line 39 "src/lexer.l"
 yylineno--;
 	YY_BREAK
 case 3:
 YY_RULE_SETUP
-#line 36 "src/lexer.l"
+#line 40 "src/lexer.l"
 {
     if(dump_tokens)
         DEBUG_FOR_LAB4("WHILE\twhile");
@@ -835,7 +904,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 4:
 YY_RULE_SETUP
-#line 41 "src/lexer.l"
+#line 45 "src/lexer.l"
 {
     if(dump_tokens)
         DEBUG_FOR_LAB4("BREAK\tbreak");
@@ -844,7 +913,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 5:
 YY_RULE_SETUP
-#line 46 "src/lexer.l"
+#line 50 "src/lexer.l"
 {
     if(dump_tokens)
         DEBUG_FOR_LAB4("CONTINUE\tcontinue");
@@ -853,7 +922,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 6:
 YY_RULE_SETUP
-#line 51 "src/lexer.l"
+#line 55 "src/lexer.l"
 {
     if(dump_tokens)
         DEBUG_FOR_LAB4("CONST\tconst");
@@ -862,7 +931,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 7:
 YY_RULE_SETUP
-#line 56 "src/lexer.l"
+#line 60 "src/lexer.l"
 {
     /*
     * Questions: 
@@ -876,250 +945,279 @@ YY_RULE_SETUP
 	YY_BREAK
 case 8:
 YY_RULE_SETUP
-#line 66 "src/lexer.l"
+#line 70 "src/lexer.l"
+{
+    if(dump_tokens)
+        DEBUG_FOR_LAB4("FLOAT\tfloat");
+    return FLOAT;
+}
+	YY_BREAK
+case 9:
+YY_RULE_SETUP
+#line 75 "src/lexer.l"
 {
     if(dump_tokens)
         DEBUG_FOR_LAB4("VOID\tvoid");
     return VOID;
 }
 	YY_BREAK
-case 9:
+case 10:
 YY_RULE_SETUP
-#line 71 "src/lexer.l"
+#line 80 "src/lexer.l"
 {
     if(dump_tokens)
         DEBUG_FOR_LAB4("IF\tif");
     return IF;
 };
 	YY_BREAK
-case 10:
+case 11:
 YY_RULE_SETUP
-#line 76 "src/lexer.l"
+#line 85 "src/lexer.l"
 {
     if(dump_tokens)
         DEBUG_FOR_LAB4("ELSE\telse");
     return ELSE;
 };
 	YY_BREAK
-case 11:
+case 12:
 YY_RULE_SETUP
-#line 81 "src/lexer.l"
+#line 90 "src/lexer.l"
 {
     if(dump_tokens)
         DEBUG_FOR_LAB4("RETURN\treturn");
     return RETURN;
 }
 	YY_BREAK
-case 12:
+case 13:
 YY_RULE_SETUP
-#line 87 "src/lexer.l"
+#line 96 "src/lexer.l"
 {
     if(dump_tokens)
         DEBUG_FOR_LAB4("AND\t=");
     return AND;
 }
 	YY_BREAK
-case 13:
+case 14:
 YY_RULE_SETUP
-#line 92 "src/lexer.l"
+#line 101 "src/lexer.l"
 {
     if(dump_tokens)
         DEBUG_FOR_LAB4("OR\t=");
     return OR;
 }
 	YY_BREAK
-case 14:
+case 15:
 YY_RULE_SETUP
-#line 97 "src/lexer.l"
+#line 106 "src/lexer.l"
 {
     if(dump_tokens)
         DEBUG_FOR_LAB4("ASSIGN\t=");
     return NOTEQUAL;  
 }
 	YY_BREAK
-case 15:
+case 16:
 YY_RULE_SETUP
-#line 102 "src/lexer.l"
+#line 111 "src/lexer.l"
 {
     if(dump_tokens)
         DEBUG_FOR_LAB4("ASSIGN\t=");
     return EQUAL;
 }
 	YY_BREAK
-case 16:
+case 17:
 YY_RULE_SETUP
-#line 107 "src/lexer.l"
+#line 116 "src/lexer.l"
 {
     if(dump_tokens)
         DEBUG_FOR_LAB4("LESSEQ\t<");
     return LESSEQ;
 }
 	YY_BREAK
-case 17:
+case 18:
 YY_RULE_SETUP
-#line 112 "src/lexer.l"
+#line 121 "src/lexer.l"
 {
     if(dump_tokens)
         DEBUG_FOR_LAB4("MOREEQ\t<");
     return MOREEQ;
 }
 	YY_BREAK
-case 18:
+case 19:
 YY_RULE_SETUP
-#line 117 "src/lexer.l"
+#line 126 "src/lexer.l"
 {
     if(dump_tokens)
         DEBUG_FOR_LAB4("ASSIGN\t=");
     return NOT;  
 }
 	YY_BREAK
-case 19:
+case 20:
 YY_RULE_SETUP
-#line 123 "src/lexer.l"
+#line 132 "src/lexer.l"
 {
     if(dump_tokens)
         DEBUG_FOR_LAB4("ASSIGN\t=");
     return ASSIGN;
 }
 	YY_BREAK
-case 20:
+case 21:
 YY_RULE_SETUP
-#line 128 "src/lexer.l"
+#line 137 "src/lexer.l"
 {
     if(dump_tokens)
         DEBUG_FOR_LAB4("MOD\t=");
     return MOD;
 }
 	YY_BREAK
-case 21:
+case 22:
 YY_RULE_SETUP
-#line 133 "src/lexer.l"
+#line 142 "src/lexer.l"
 {
     if(dump_tokens)
         DEBUG_FOR_LAB4("LESS\t<");
     return LESS;
 }
 	YY_BREAK
-case 22:
+case 23:
 YY_RULE_SETUP
-#line 138 "src/lexer.l"
+#line 147 "src/lexer.l"
 {
     if(dump_tokens)
         DEBUG_FOR_LAB4("MORE\t<");
     return MORE;
 }
 	YY_BREAK
-case 23:
+case 24:
 YY_RULE_SETUP
-#line 143 "src/lexer.l"
+#line 152 "src/lexer.l"
 {
     if(dump_tokens)
         DEBUG_FOR_LAB4("ADD\t+");
     return ADD;
 }
 	YY_BREAK
-case 24:
+case 25:
 YY_RULE_SETUP
-#line 148 "src/lexer.l"
+#line 157 "src/lexer.l"
 {
     if(dump_tokens)
         DEBUG_FOR_LAB4("SUB\t+");
     return SUB;
 }
 	YY_BREAK
-case 25:
+case 26:
 YY_RULE_SETUP
-#line 153 "src/lexer.l"
+#line 162 "src/lexer.l"
 {
     if(dump_tokens)
         DEBUG_FOR_LAB4("MUL\t+");
     return MUL;
 }
 	YY_BREAK
-case 26:
+case 27:
 YY_RULE_SETUP
-#line 158 "src/lexer.l"
+#line 167 "src/lexer.l"
 {
     if(dump_tokens)
         DEBUG_FOR_LAB4("DIV\t+");
     return DIV;
 }
 	YY_BREAK
-case 27:
+case 28:
 YY_RULE_SETUP
-#line 163 "src/lexer.l"
+#line 172 "src/lexer.l"
 {
      if(dump_tokens)
         DEBUG_FOR_LAB4("COMMA\t;");
     return COMMA;   
 }
 	YY_BREAK
-case 28:
+case 29:
 YY_RULE_SETUP
-#line 168 "src/lexer.l"
+#line 177 "src/lexer.l"
 {
     if(dump_tokens)
         DEBUG_FOR_LAB4("SEMICOLON\t;");
     return SEMICOLON;
 }
 	YY_BREAK
-case 29:
+case 30:
 YY_RULE_SETUP
-#line 173 "src/lexer.l"
+#line 182 "src/lexer.l"
 {
     if(dump_tokens)
         DEBUG_FOR_LAB4("LPAREN\t(");
     return LPAREN;
 }
 	YY_BREAK
-case 30:
+case 31:
 YY_RULE_SETUP
-#line 178 "src/lexer.l"
+#line 187 "src/lexer.l"
 {
     if(dump_tokens)
         DEBUG_FOR_LAB4("RPAREN\t)");
     return RPAREN;
 }
 	YY_BREAK
-case 31:
+case 32:
 YY_RULE_SETUP
-#line 183 "src/lexer.l"
+#line 192 "src/lexer.l"
 {
     if(dump_tokens)
         DEBUG_FOR_LAB4("LBRACE\t{");
     return LBRACE;
 }
 	YY_BREAK
-case 32:
+case 33:
 YY_RULE_SETUP
-#line 188 "src/lexer.l"
+#line 197 "src/lexer.l"
 {
     if(dump_tokens)
         DEBUG_FOR_LAB4("RBRACE\t}");
     return RBRACE;
 }
 	YY_BREAK
-case 33:
+case 34:
 YY_RULE_SETUP
-#line 193 "src/lexer.l"
+#line 202 "src/lexer.l"
 {
     if(dump_tokens)
         DEBUG_FOR_LAB4("LBRACKET\t[");
     return LBRACKET;
 }
 	YY_BREAK
-case 34:
+case 35:
 YY_RULE_SETUP
-#line 198 "src/lexer.l"
+#line 207 "src/lexer.l"
 {
     if(dump_tokens)
         DEBUG_FOR_LAB4("RBRACKET\t]");
     return RBRACKET;
 }
 	YY_BREAK
-case 35:
+case 36:
+YY_RULE_SETUP
+#line 212 "src/lexer.l"
+{
+    if(dump_tokens)
+        DEBUG_FOR_LAB4(string("FLOATING\t") + yytext);
+    yylval.ftype = strtof(yytext, nullptr);
+    return FLOATING;
+}
+	YY_BREAK
+case 37:
+YY_RULE_SETUP
+#line 218 "src/lexer.l"
+{
+    if(dump_tokens)
+        DEBUG_FOR_LAB4(string("FLOATING\t") + yytext);
+    yylval.ftype = strtof(yytext, nullptr);
+    return FLOATING;
+}
+	YY_BREAK
+case 38:
 YY_RULE_SETUP
-#line 203 "src/lexer.l"
+#line 224 "src/lexer.l"
 {
      int temp;
     sscanf(yytext, "%x", &temp);
@@ -1129,9 +1227,9 @@ YY_RULE_SETUP
     return INTEGER;
 }
 	YY_BREAK
-case 36:
+case 39:
 YY_RULE_SETUP
-#line 211 "src/lexer.l"
+#line 232 "src/lexer.l"
 {
     int temp;
     sscanf(yytext, "%o", &temp);
@@ -1141,9 +1239,9 @@ YY_RULE_SETUP
     return INTEGER;
 }
 	YY_BREAK
-case 37:
+case 40:
 YY_RULE_SETUP
-#line 219 "src/lexer.l"
+#line 240 "src/lexer.l"
 {
     if(dump_tokens)
         DEBUG_FOR_LAB4(yytext);
@@ -1151,9 +1249,9 @@ YY_RULE_SETUP
     return INTEGER;
 }
 	YY_BREAK
-case 38:
+case 41:
 YY_RULE_SETUP
-#line 225 "src/lexer.l"
+#line 246 "src/lexer.l"
 {
     if(dump_tokens)
         DEBUG_FOR_LAB4(yytext);
@@ -1172,9 +1270,9 @@ YY_RULE_SETUP
     return ID;
 }
 	YY_BREAK
-case 39:
+case 42:
 YY_RULE_SETUP
-#line 242 "src/lexer.l"
+#line 263 "src/lexer.l"
 {
     if(dump_tokens)
         DEBUG_FOR_LAB4(yytext);
@@ -1192,9 +1290,9 @@ YY_RULE_SETUP
     return ID;
 }
 	YY_BREAK
-case 40:
+case 43:
 YY_RULE_SETUP
-#line 258 "src/lexer.l"
+#line 279 "src/lexer.l"
 {
     if(dump_tokens)
         DEBUG_FOR_LAB4(yytext);
@@ -1213,9 +1311,9 @@ YY_RULE_SETUP
     return ID;
 }
 	YY_BREAK
-case 41:
+case 44:
 YY_RULE_SETUP
-#line 275 "src/lexer.l"
+#line 296 "src/lexer.l"
 {
     if(dump_tokens)
         DEBUG_FOR_LAB4(yytext);
@@ -1223,26 +1321,27 @@ YY_RULE_SETUP
     lexeme = new char[strlen(yytext) + 1];
     strcpy(lexeme, yytext);
     yylval.strtype = lexeme;
+    declareRuntime(yytext);
     return ID;
 }
 	YY_BREAK
-case 42:
-/* rule 42 can match eol */
+case 45:
+/* rule 45 can match eol */
 YY_RULE_SETUP
-#line 284 "src/lexer.l"
+#line 306 "src/lexer.l"
 yylineno++;
 	YY_BREAK
-case 43:
+case 46:
 YY_RULE_SETUP
-#line 285 "src/lexer.l"
+#line 307 "src/lexer.l"
 
 	YY_BREAK
-case 44:
+case 47:
 YY_RULE_SETUP
-#line 286 "src/lexer.l"
+#line 308 "src/lexer.l"
 ECHO;
 	YY_BREAK
-#line 1246 "src/lexer.cpp"
+#line 1345 "src/lexer.cpp"
 case YY_STATE_EOF(INITIAL):
 case YY_STATE_EOF(BLOCKCOMMENT):
 	yyterminate();
@@ -1540,7 +1639,7 @@ static int yy_get_next_buffer (void)
 		while ( yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state )
 			{
 			yy_current_state = (int) yy_def[yy_current_state];
-			if ( yy_current_state >= 104 )
+			if ( yy_current_state >= 127 )
 				yy_c = yy_meta[yy_c];
 			}
 		yy_current_state = yy_nxt[yy_base[yy_current_state] + yy_c];
@@ -1568,11 +1667,11 @@ static int yy_get_next_buffer (void)
 	while ( yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state )
 		{
 		yy_current_state = (int) yy_def[yy_current_state];
-		if ( yy_current_state >= 104 )
+		if ( yy_current_state >= 127 )
 			yy_c = yy_meta[yy_c];
 		}
 	yy_current_state = yy_nxt[yy_base[yy_current_state] + yy_c];
-	yy_is_jam = (yy_current_state == 103);
+	yy_is_jam = (yy_current_state == 126);
 
 		return yy_is_jam ? 0 : yy_current_state;
 }
@@ -2248,6 +2347,33 @@ void yyfree (void * ptr )
 
 #define YYTABLES_NAME "yytables"
 
-#line 286 "src/lexer.l"
-
-
+#line 308 "src/lexer.l"
+// The float functions of the runtime library are declared when first named,
+// as the rules above do for putint, getint and putch.
+void declareRuntime(const char *name)
+{
+    std::vector<Type*> t;
+    Type *retType;
+    if(strcmp(name, "getfloat") == 0)
+        retType = TypeSystem::floatType;
+    else if(strcmp(name, "putfloat") == 0){
+        retType = TypeSystem::voidType;
+        t.emplace_back(TypeSystem::floatType);
+    }
+    else if(strcmp(name, "getfarray") == 0){
+        retType = TypeSystem::intType;
+        t.emplace_back(new PointerType(TypeSystem::floatType));
+    }
+    else if(strcmp(name, "putfarray") == 0){
+        retType = TypeSystem::voidType;
+        t.emplace_back(TypeSystem::intType);
+        t.emplace_back(new PointerType(TypeSystem::floatType));
+    }
+    else
+        return;
+    SymbolTable* st = identifiers;
+    while(st->getPrev())
+        st = st->getPrev();
+    if(st->lookup(name) == nullptr)
+        st->install(name, new IdentifierSymbolEntry(new FunctionType(retType, t), name, st->getLevel()));
+}
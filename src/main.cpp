@@ -5,6 +5,18 @@
 #include "Unit.h"
 #include "MachineCode.h"
 #include "LinearScan.h"
+#include "StackColoring.h"
+#include "MulAddFusion.h"
+#include "IfConversion.h"
+#include "BlockLayout.h"
+#include "Peephole.h"
+#include "InstructionScheduler.h"
+#include "LoopInvariantCodeMotion.h"
+#include "LoopVectorizer.h"
+#include "LoopUnroll.h"
+#include "DeadCodeElimination.h"
+#include "Inliner.h"
+#include "TailCallElimination.h"
 using namespace std;
 
 Ast ast;
@@ -20,11 +32,14 @@ bool dump_tokens;
 bool dump_ast;
 bool dump_ir;
 bool dump_asm;
+bool dump_stats;
+int unroll_factor = 4;
+int schedule;
 
 int main(int argc, char *argv[])
 {
     int opt;
-    while ((opt = getopt(argc, argv, "Siato:")) != -1)
+    while ((opt = getopt(argc, argv, "Siastu:l:o:")) != -1)
     {
         switch (opt)
         {
@@ -43,8 +58,17 @@ int main(int argc, char *argv[])
         case 'S':
             dump_asm = true;
             break;
+        case 's':
+            dump_stats = true;
+            break;
+        case 'u':
+            unroll_factor = atoi(optarg);
+            break;
+        case 'l':
+            schedule = atoi(optarg);
+            break;
         default:
-            fprintf(stderr, "Usage: %s [-o outfile] infile\n", argv[0]);
+            fprintf(stderr, "Usage: %s [-o outfile] [-s] [-u factor] [-l 1|2|3] infile\n", argv[0]);
             exit(EXIT_FAILURE);
             break;
         }
@@ -69,11 +93,43 @@ int main(int argc, char *argv[])
         ast.output();   
     ast.typeCheck();
     ast.genCode(&unit);
+    Inliner inliner(&unit);
+    inliner.pass();
+    DeadCodeElimination dce(&unit);
+    dce.pass();
+    TailCallElimination tce(&unit);
+    tce.pass();
+    LoopInvariantCodeMotion licm(&unit);
+    licm.pass();
+    LoopVectorizer vectorizer(&unit);
+    vectorizer.pass();
+    LoopUnroll unroller(&unit, unroll_factor);
+    unroller.pass();
     if(dump_ir)
         unit.output();
     unit.genMachineCode(&mUnit);
+    MulAddFusion maf(&mUnit);
+    maf.pass();
+    IfConversion ifc(&mUnit);
+    ifc.pass();
+    InstructionScheduler scheduler(&mUnit);
+    if (schedule & InstructionScheduler::BEFORE_RA)
+        scheduler.pass();
     LinearScan linearScan(&mUnit);
     linearScan.allocateRegisters();
+    StackColoring coloring(&mUnit);
+    coloring.pass();
+    BlockLayout layout(&mUnit);
+    layout.pass();
+    Peephole peephole(&mUnit);
+    peephole.pass();
+    if (schedule & InstructionScheduler::AFTER_RA)
+        scheduler.pass();
+    if(dump_stats)
+    {
+        linearScan.report();
+        peephole.report();
+    }
     if(dump_asm)
         mUnit.output();
     return 0;
@@ -81,8 +81,56 @@
     int ifReturn=1;
     std::stack<StmtNode*> whileS;
     ArrayType* arrayType;
+    Type *declType;     // the type of the declaration being parsed
+    bool declConst;     // whether it is declared const
+
+    // array of int or float, as declared, with the constant dimensions listed
+    // in dims, innermost last
+    Type *arrayOf(ExprNode *dims)
+    {
+        std::vector<int> vec;
+        for (ExprNode *temp = dims; temp; temp = (ExprNode*)(temp->getNext()))
+        {
+            ConstantSymbolEntry *dim = temp->fold();
+            if(dim == nullptr)
+            {
+                fprintf(stderr, "array dimension is not a constant expression\n");
+                assert(dim != nullptr);
+            }
+            vec.push_back(dim->getType()->isFloat() ? (int)dim->getFloatValue() : dim->getValue());
+        }
+        Type *type = declType->isFloat() ? TypeSystem::floatType : TypeSystem::intType;
+        Type* temp1;
+        while(!vec.empty()){
+            temp1 = new ArrayType(type, vec.back());
+            if(type->isArray())
+                ((ArrayType*)type)->setArrayType(temp1);
+            type = temp1;
+            vec.pop_back();
+        }
+        return type;
+    }
+
+    // The initializer of a constant is folded and kept with it, for the
+    // constant expressions that name it later. A global's is emitted as data,
+    // so it is replaced with its value.
+    ExprNode *initOf(IdentifierSymbolEntry *se, ExprNode *init)
+    {
+        if(!declConst && !se->isGlobal())
+            return init;
+        ConstantSymbolEntry *value = init->fold();
+        if(value == nullptr)
+            return init;
+        if(declType->isFloat() && !value->getType()->isFloat())
+            value = new ConstantSymbolEntry(TypeSystem::floatType, (float)value->getValue());
+        else if(!declType->isFloat() && value->getType()->isFloat())
+            value = new ConstantSymbolEntry(TypeSystem::intType, (int)value->getFloatValue());
+        if(declConst)
+            se->setValue(value);
+        return se->isGlobal() ? new Constant(value) : init;
+    }
 
-#line 86 "src/parser.cpp"
+#line 134 "src/parser.cpp"
 
 
 
@@ -120,76 +168,80 @@ enum yysymbol_kind_t
   YYSYMBOL_INTEGER = 4,                    /* INTEGER  */
   YYSYMBOL_HEXADECIMAL = 5,                /* HEXADECIMAL  */
   YYSYMBOL_OCTAL = 6,                      /* OCTAL  */
-  YYSYMBOL_IF = 7,                         /* IF  */
-  YYSYMBOL_ELSE = 8,                       /* ELSE  */
-  YYSYMBOL_WHILE = 9,                      /* WHILE  */
-  YYSYMBOL_INT = 10,                       /* INT  */
-  YYSYMBOL_VOID = 11,                      /* VOID  */
-  YYSYMBOL_CONST = 12,                     /* CONST  */
-  YYSYMBOL_LPAREN = 13,                    /* LPAREN  */
-  YYSYMBOL_RPAREN = 14,                    /* RPAREN  */
-  YYSYMBOL_LBRACE = 15,                    /* LBRACE  */
-  YYSYMBOL_RBRACE = 16,                    /* RBRACE  */
-  YYSYMBOL_SEMICOLON = 17,                 /* SEMICOLON  */
-  YYSYMBOL_COMMA = 18,                     /* COMMA  */
-  YYSYMBOL_LBRACKET = 19,                  /* LBRACKET  */
-  YYSYMBOL_RBRACKET = 20,                  /* RBRACKET  */
-  YYSYMBOL_ADD = 21,                       /* ADD  */
-  YYSYMBOL_SUB = 22,                       /* SUB  */
-  YYSYMBOL_OR = 23,                        /* OR  */
-  YYSYMBOL_AND = 24,                       /* AND  */
-  YYSYMBOL_LESS = 25,                      /* LESS  */
-  YYSYMBOL_ASSIGN = 26,                    /* ASSIGN  */
-  YYSYMBOL_LESSEQ = 27,                    /* LESSEQ  */
-  YYSYMBOL_MOREEQ = 28,                    /* MOREEQ  */
-  YYSYMBOL_NOTEQUAL = 29,                  /* NOTEQUAL  */
-  YYSYMBOL_EQUAL = 30,                     /* EQUAL  */
-  YYSYMBOL_MORE = 31,                      /* MORE  */
-  YYSYMBOL_NOT = 32,                       /* NOT  */
-  YYSYMBOL_DIV = 33,                       /* DIV  */
-  YYSYMBOL_MUL = 34,                       /* MUL  */
-  YYSYMBOL_MOD = 35,                       /* MOD  */
-  YYSYMBOL_RETURN = 36,                    /* RETURN  */
-  YYSYMBOL_BREAK = 37,                     /* BREAK  */
-  YYSYMBOL_CONTINUE = 38,                  /* CONTINUE  */
-  YYSYMBOL_THEN = 39,                      /* THEN  */
-  YYSYMBOL_YYACCEPT = 40,                  /* $accept  */
-  YYSYMBOL_Program = 41,                   /* Program  */
-  YYSYMBOL_Stmts = 42,                     /* Stmts  */
-  YYSYMBOL_Stmt = 43,                      /* Stmt  */
-  YYSYMBOL_IDList = 44,                    /* IDList  */
-  YYSYMBOL_ParaList = 45,                  /* ParaList  */
-  YYSYMBOL_ParaIDList = 46,                /* ParaIDList  */
-  YYSYMBOL_InitIDList = 47,                /* InitIDList  */
-  YYSYMBOL_InitStmt = 48,                  /* InitStmt  */
-  YYSYMBOL_LVal = 49,                      /* LVal  */
-  YYSYMBOL_Array = 50,                     /* Array  */
-  YYSYMBOL_AssignStmt = 51,                /* AssignStmt  */
-  YYSYMBOL_BlockStmt = 52,                 /* BlockStmt  */
-  YYSYMBOL_53_1 = 53,                      /* $@1  */
-  YYSYMBOL_IfStmt = 54,                    /* IfStmt  */
-  YYSYMBOL_WhileStmt = 55,                 /* WhileStmt  */
-  YYSYMBOL_56_2 = 56,                      /* @2  */
-  YYSYMBOL_BreakStmt = 57,                 /* BreakStmt  */
-  YYSYMBOL_ContinueStmt = 58,              /* ContinueStmt  */
-  YYSYMBOL_ReturnStmt = 59,                /* ReturnStmt  */
-  YYSYMBOL_Exp = 60,                       /* Exp  */
-  YYSYMBOL_Cond = 61,                      /* Cond  */
-  YYSYMBOL_Intint = 62,                    /* Intint  */
-  YYSYMBOL_PrimaryExp = 63,                /* PrimaryExp  */
-  YYSYMBOL_NotExp = 64,                    /* NotExp  */
-  YYSYMBOL_MulExp = 65,                    /* MulExp  */
-  YYSYMBOL_AddExp = 66,                    /* AddExp  */
-  YYSYMBOL_RelExp = 67,                    /* RelExp  */
-  YYSYMBOL_LAndExp = 68,                   /* LAndExp  */
-  YYSYMBOL_LOrExp = 69,                    /* LOrExp  */
-  YYSYMBOL_Type = 70,                      /* Type  */
-  YYSYMBOL_ExprStmt = 71,                  /* ExprStmt  */
-  YYSYMBOL_BlankStmt = 72,                 /* BlankStmt  */
-  YYSYMBOL_FuncExpr = 73,                  /* FuncExpr  */
-  YYSYMBOL_FuncDef = 74,                   /* FuncDef  */
-  YYSYMBOL_75_3 = 75,                      /* $@3  */
-  YYSYMBOL_DeclStmt = 76                   /* DeclStmt  */
+  YYSYMBOL_FLOATING = 7,                   /* FLOATING  */
+  YYSYMBOL_IF = 8,                         /* IF  */
+  YYSYMBOL_ELSE = 9,                       /* ELSE  */
+  YYSYMBOL_WHILE = 10,                     /* WHILE  */
+  YYSYMBOL_INT = 11,                       /* INT  */
+  YYSYMBOL_FLOAT = 12,                     /* FLOAT  */
+  YYSYMBOL_VOID = 13,                      /* VOID  */
+  YYSYMBOL_CONST = 14,                     /* CONST  */
+  YYSYMBOL_LPAREN = 15,                    /* LPAREN  */
+  YYSYMBOL_RPAREN = 16,                    /* RPAREN  */
+  YYSYMBOL_LBRACE = 17,                    /* LBRACE  */
+  YYSYMBOL_RBRACE = 18,                    /* RBRACE  */
+  YYSYMBOL_SEMICOLON = 19,                 /* SEMICOLON  */
+  YYSYMBOL_COMMA = 20,                     /* COMMA  */
+  YYSYMBOL_LBRACKET = 21,                  /* LBRACKET  */
+  YYSYMBOL_RBRACKET = 22,                  /* RBRACKET  */
+  YYSYMBOL_ADD = 23,                       /* ADD  */
+  YYSYMBOL_SUB = 24,                       /* SUB  */
+  YYSYMBOL_OR = 25,                        /* OR  */
+  YYSYMBOL_AND = 26,                       /* AND  */
+  YYSYMBOL_LESS = 27,                      /* LESS  */
+  YYSYMBOL_ASSIGN = 28,                    /* ASSIGN  */
+  YYSYMBOL_LESSEQ = 29,                    /* LESSEQ  */
+  YYSYMBOL_MOREEQ = 30,                    /* MOREEQ  */
+  YYSYMBOL_NOTEQUAL = 31,                  /* NOTEQUAL  */
+  YYSYMBOL_EQUAL = 32,                     /* EQUAL  */
+  YYSYMBOL_MORE = 33,                      /* MORE  */
+  YYSYMBOL_NOT = 34,                       /* NOT  */
+  YYSYMBOL_DIV = 35,                       /* DIV  */
+  YYSYMBOL_MUL = 36,                       /* MUL  */
+  YYSYMBOL_MOD = 37,                       /* MOD  */
+  YYSYMBOL_RETURN = 38,                    /* RETURN  */
+  YYSYMBOL_BREAK = 39,                     /* BREAK  */
+  YYSYMBOL_CONTINUE = 40,                  /* CONTINUE  */
+  YYSYMBOL_THEN = 41,                      /* THEN  */
+  YYSYMBOL_YYACCEPT = 42,                  /* $accept  */
+  YYSYMBOL_Program = 43,                   /* Program  */
+  YYSYMBOL_Stmts = 44,                     /* Stmts  */
+  YYSYMBOL_Stmt = 45,                      /* Stmt  */
+  YYSYMBOL_IDList = 46,                    /* IDList  */
+  YYSYMBOL_ParaList = 47,                  /* ParaList  */
+  YYSYMBOL_FuncParam = 48,                 /* FuncParam  */
+  YYSYMBOL_ParaIDList = 49,                /* ParaIDList  */
+  YYSYMBOL_InitIDList = 50,                /* InitIDList  */
+  YYSYMBOL_InitStmt = 51,                  /* InitStmt  */
+  YYSYMBOL_LVal = 52,                      /* LVal  */
+  YYSYMBOL_Array = 53,                     /* Array  */
+  YYSYMBOL_AssignStmt = 54,                /* AssignStmt  */
+  YYSYMBOL_BlockStmt = 55,                 /* BlockStmt  */
+  YYSYMBOL_56_1 = 56,                      /* $@1  */
+  YYSYMBOL_IfStmt = 57,                    /* IfStmt  */
+  YYSYMBOL_WhileStmt = 58,                 /* WhileStmt  */
+  YYSYMBOL_59_2 = 59,                      /* @2  */
+  YYSYMBOL_BreakStmt = 60,                 /* BreakStmt  */
+  YYSYMBOL_ContinueStmt = 61,              /* ContinueStmt  */
+  YYSYMBOL_ReturnStmt = 62,                /* ReturnStmt  */
+  YYSYMBOL_Exp = 63,                       /* Exp  */
+  YYSYMBOL_Cond = 64,                      /* Cond  */
+  YYSYMBOL_Intint = 65,                    /* Intint  */
+  YYSYMBOL_PrimaryExp = 66,                /* PrimaryExp  */
+  YYSYMBOL_NotExp = 67,                    /* NotExp  */
+  YYSYMBOL_MulExp = 68,                    /* MulExp  */
+  YYSYMBOL_AddExp = 69,                    /* AddExp  */
+  YYSYMBOL_RelExp = 70,                    /* RelExp  */
+  YYSYMBOL_LAndExp = 71,                   /* LAndExp  */
+  YYSYMBOL_LOrExp = 72,                    /* LOrExp  */
+  YYSYMBOL_Type = 73,                      /* Type  */
+  YYSYMBOL_ExprStmt = 74,                  /* ExprStmt  */
+  YYSYMBOL_BlankStmt = 75,                 /* BlankStmt  */
+  YYSYMBOL_FuncExpr = 76,                  /* FuncExpr  */
+  YYSYMBOL_FuncDef = 77,                   /* FuncDef  */
+  YYSYMBOL_78_3 = 78,                      /* $@3  */
+  YYSYMBOL_79_4 = 79,                      /* $@4  */
+  YYSYMBOL_DeclStmt = 80                   /* DeclStmt  */
 };
 typedef enum yysymbol_kind_t yysymbol_kind_t;
 
@@ -515,21 +567,21 @@ union yyalloc
 #endif /* !YYCOPY_NEEDED */
 
 /* YYFINAL -- State number of the termination state.  */
-#define YYFINAL  60
+#define YYFINAL  63
 /* YYLAST -- Last index in YYTABLE.  */
-#define YYLAST   202
+#define YYLAST   192
 
 /* YYNTOKENS -- Number of terminals.  */
-#define YYNTOKENS  40
+#define YYNTOKENS  42
 /* YYNNTS -- Number of nonterminals.  */
-#define YYNNTS  37
+#define YYNNTS  39
 /* YYNRULES -- Number of rules.  */
-#define YYNRULES  85
+#define YYNRULES  92
 /* YYNSTATES -- Number of states.  */
-#define YYNSTATES  144
+#define YYNSTATES  151
 
 /* YYMAXUTOK -- Last valid token kind.  */
-#define YYMAXUTOK   294
+#define YYMAXUTOK   296
 
 
 /* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
@@ -572,22 +624,23 @@ static const yytype_int8 yytranslate[] =
        5,     6,     7,     8,     9,    10,    11,    12,    13,    14,
       15,    16,    17,    18,    19,    20,    21,    22,    23,    24,
       25,    26,    27,    28,    29,    30,    31,    32,    33,    34,
-      35,    36,    37,    38,    39
+      35,    36,    37,    38,    39,    40,    41
 };
 
 #if YYDEBUG
 /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
 static const yytype_int16 yyrline[] =
 {
-       0,    60,    60,    65,    66,    71,    72,    73,    74,    75,
-      76,    77,    78,    79,    80,    81,    82,    87,   100,   139,
-     152,   184,   194,   202,   208,   215,   221,   226,   243,   262,
-     270,   282,   298,   302,   311,   318,   317,   327,   332,   335,
-     340,   340,   352,   357,   363,   380,   390,   394,   398,   400,
-     402,   406,   408,   411,   415,   421,   423,   428,   434,   441,
-     443,   449,   455,   463,   465,   471,   479,   481,   487,   493,
-     499,   505,   511,   519,   521,   529,   531,   539,   542,   545,
-     552,   557,   563,   596,   596,   631
+       0,   112,   112,   117,   118,   123,   124,   125,   126,   127,
+     128,   129,   130,   131,   132,   133,   134,   139,   152,   174,
+     187,   207,   213,   218,   223,   229,   235,   243,   250,   256,
+     261,   278,   297,   305,   317,   333,   337,   346,   353,   352,
+     362,   367,   370,   375,   375,   387,   392,   398,   416,   426,
+     430,   434,   436,   438,   442,   444,   447,   451,   455,   461,
+     463,   468,   474,   481,   483,   489,   495,   503,   505,   511,
+     519,   521,   527,   533,   539,   545,   551,   559,   561,   569,
+     571,   579,   584,   589,   594,   599,   608,   613,   619,   659,
+     663,   659,   697
 };
 #endif
 
@@ -604,17 +657,17 @@ static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
 static const char *const yytname[] =
 {
   "\"end of file\"", "error", "\"invalid token\"", "ID", "INTEGER",
-  "HEXADECIMAL", "OCTAL", "IF", "ELSE", "WHILE", "INT", "VOID", "CONST",
-  "LPAREN", "RPAREN", "LBRACE", "RBRACE", "SEMICOLON", "COMMA", "LBRACKET",
-  "RBRACKET", "ADD", "SUB", "OR", "AND", "LESS", "ASSIGN", "LESSEQ",
-  "MOREEQ", "NOTEQUAL", "EQUAL", "MORE", "NOT", "DIV", "MUL", "MOD",
-  "RETURN", "BREAK", "CONTINUE", "THEN", "$accept", "Program", "Stmts",
-  "Stmt", "IDList", "ParaList", "ParaIDList", "InitIDList", "InitStmt",
-  "LVal", "Array", "AssignStmt", "BlockStmt", "$@1", "IfStmt", "WhileStmt",
-  "@2", "BreakStmt", "ContinueStmt", "ReturnStmt", "Exp", "Cond", "Intint",
-  "PrimaryExp", "NotExp", "MulExp", "AddExp", "RelExp", "LAndExp",
-  "LOrExp", "Type", "ExprStmt", "BlankStmt", "FuncExpr", "FuncDef", "$@3",
-  "DeclStmt", YY_NULLPTR
+  "HEXADECIMAL", "OCTAL", "FLOATING", "IF", "ELSE", "WHILE", "INT",
+  "FLOAT", "VOID", "CONST", "LPAREN", "RPAREN", "LBRACE", "RBRACE",
+  "SEMICOLON", "COMMA", "LBRACKET", "RBRACKET", "ADD", "SUB", "OR", "AND",
+  "LESS", "ASSIGN", "LESSEQ", "MOREEQ", "NOTEQUAL", "EQUAL", "MORE", "NOT",
+  "DIV", "MUL", "MOD", "RETURN", "BREAK", "CONTINUE", "THEN", "$accept",
+  "Program", "Stmts", "Stmt", "IDList", "ParaList", "FuncParam",
+  "ParaIDList", "InitIDList", "InitStmt", "LVal", "Array", "AssignStmt",
+  "BlockStmt", "$@1", "IfStmt", "WhileStmt", "@2", "BreakStmt",
+  "ContinueStmt", "ReturnStmt", "Exp", "Cond", "Intint", "PrimaryExp",
+  "NotExp", "MulExp", "AddExp", "RelExp", "LAndExp", "LOrExp", "Type",
+  "ExprStmt", "BlankStmt", "FuncExpr", "FuncDef", "$@3", "$@4", "DeclStmt", YY_NULLPTR
 };
 
 static const char *
@@ -624,7 +677,7 @@ yysymbol_name (yysymbol_kind_t yysymbol)
 }
 #endif
 
-#define YYPACT_NINF (-85)
+#define YYPACT_NINF (-113)
 
 #define yypact_value_is_default(Yyn) \
   ((Yyn) == YYPACT_NINF)
@@ -638,21 +691,22 @@ yysymbol_name (yysymbol_kind_t yysymbol)
    STATE-NUM.  */
 static const yytype_int16 yypact[] =
 {
-     164,     6,   -85,   -85,   -85,    13,    28,   -85,   -85,    40,
-      73,    35,   -85,    73,    73,    73,    10,    36,    48,    80,
-     164,   -85,   -85,    55,   -85,   -85,   -85,   -85,   -85,   -85,
-     -85,    65,   -85,   -85,   -85,     5,   -12,    84,   -85,   -85,
-     -85,   -85,   -85,    73,    73,    69,    73,    73,   -85,   -85,
-      75,   -85,   164,   -85,   -85,   -85,   -85,    76,   -85,   -85,
-     -85,   -85,    73,   -85,    73,    73,    73,    73,    73,    11,
-      16,    29,     3,   -85,    70,    73,    78,    79,   -85,    72,
-      74,    85,   -85,   128,   -85,    81,   -85,   -85,   -85,     5,
-       5,    33,    73,    69,   -85,   100,   -85,   108,   -85,    73,
-     -85,    92,   164,    73,    73,    73,    73,    73,    73,    73,
-      73,   -85,   -85,   -85,     4,   111,   -85,    96,    90,   -85,
-     -85,   109,   -85,   -85,   -85,   -85,   -85,   -85,   -85,    72,
-     164,   -85,    33,   -85,    69,    73,   164,   -85,   103,   117,
-     -85,   -85,   -85,   -85
+     136,    -9,  -113,  -113,  -113,  -113,    -6,    -2,  -113,  -113,
+    -113,    19,   158,   -14,  -113,   158,   158,   158,    13,    -4,
+      14,    51,   136,  -113,  -113,    66,  -113,  -113,  -113,  -113,
+    -113,  -113,  -113,    38,  -113,  -113,  -113,    28,    22,    92,
+    -113,  -113,  -113,  -113,  -113,   158,   158,    75,   158,   158,
+    -113,  -113,  -113,    81,  -113,   136,  -113,  -113,  -113,  -113,
+      79,  -113,  -113,  -113,  -113,   158,  -113,   158,   158,   158,
+     158,   158,    -7,    62,    73,     7,  -113,    94,   158,   101,
+      29,  -113,    95,    97,   107,  -113,    96,  -113,   105,  -113,
+    -113,  -113,    28,    28,  -113,   158,    75,  -113,   122,  -113,
+     124,  -113,   158,  -113,   106,   136,   158,   158,   158,   158,
+     158,   158,   158,   158,  -113,  -113,  -113,    76,  -113,   108,
+     103,  -113,  -113,   128,  -113,  -113,  -113,  -113,  -113,  -113,
+    -113,    95,   136,    63,  -113,   130,    75,   158,   136,  -113,
+    -113,    76,   131,  -113,  -113,   137,  -113,   123,  -113,   108,
+      75
 };
 
 /* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
@@ -660,39 +714,40 @@ static const yytype_int16 yypact[] =
    means the default is an error.  */
 static const yytype_int8 yydefact[] =
 {
-       0,    30,    48,    49,    50,     0,     0,    78,    79,     0,
-       0,    35,    81,     0,     0,     0,     0,     0,     0,     0,
-       2,     3,    13,    52,     5,     6,     7,    15,     8,     9,
-      10,     0,    53,    55,    59,    63,    46,     0,    14,    16,
-      54,    12,    11,    26,     0,    31,     0,     0,    77,    52,
-       0,    37,     0,    57,    58,    56,    45,     0,    42,    43,
-       1,     4,     0,    80,     0,     0,     0,     0,     0,    17,
-       0,     0,     0,    24,     0,     0,     0,    66,    73,    75,
-      47,     0,    51,     0,    44,     0,    61,    60,    62,    64,
-      65,    23,     0,    18,    85,     0,    29,     0,    82,     0,
-      32,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-       0,    40,    36,    34,     0,     0,    27,    19,     0,    25,
-      33,    38,    69,    67,    68,    72,    71,    70,    74,    76,
-       0,    83,     0,    21,    20,     0,     0,    41,     0,     0,
-      28,    39,    84,    22
+       0,    33,    51,    52,    53,    57,     0,     0,    83,    84,
+      85,     0,     0,    38,    87,     0,     0,     0,     0,     0,
+       0,     0,     2,     3,    13,    55,     5,     6,     7,    15,
+       8,     9,    10,     0,    56,    59,    63,    67,    49,     0,
+      14,    16,    58,    12,    11,    29,     0,    34,     0,     0,
+      81,    82,    55,     0,    40,     0,    61,    62,    60,    48,
+       0,    45,    46,     1,     4,     0,    86,     0,     0,     0,
+       0,     0,    17,     0,     0,     0,    27,     0,     0,     0,
+      70,    77,    79,    50,     0,    54,     0,    47,     0,    65,
+      64,    66,    68,    69,    89,     0,    18,    92,     0,    32,
+       0,    88,     0,    35,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,    43,    39,    37,    23,    30,    19,
+       0,    28,    36,    41,    73,    71,    72,    76,    75,    74,
+      78,    80,     0,     0,    21,     0,    20,     0,     0,    44,
+      90,     0,    24,    31,    42,     0,    22,     0,    91,    25,
+      26
 };
 
 /* YYPGOTO[NTERM-NUM].  */
 static const yytype_int8 yypgoto[] =
 {
-     -85,   -85,    71,   -17,   -85,   -85,   -85,   -85,   -85,     0,
-     -68,   -85,   -16,   -85,   -85,   -85,   -85,   -85,   -85,   -85,
-      -8,    77,   -85,   -85,    -9,   -39,   -35,   -45,    15,   -85,
-     -84,   -85,   -85,   -85,   -85,   -85,   -85
+    -113,  -113,   102,   -20,  -113,  -113,    15,  -113,  -113,  -113,
+       0,   -69,  -113,    21,  -113,  -113,  -113,  -113,  -113,  -113,
+    -113,   -11,   109,  -113,  -113,     9,   -22,   -38,   -68,    54,
+    -113,  -112,  -113,  -113,  -113,  -113,  -113,  -113,  -113
 };
 
 /* YYDEFGOTO[NTERM-NUM].  */
 static const yytype_uint8 yydefgoto[] =
 {
-       0,    19,    20,    21,    70,   114,    72,    71,    22,    49,
-      45,    24,    25,    52,    26,    27,   130,    28,    29,    30,
-      31,    76,    32,    33,    34,    35,    36,    78,    79,    80,
-      37,    38,    39,    40,    41,   138,    42
+       0,    21,    22,    23,    73,   133,   134,    75,    74,    24,
+      52,    47,    26,    27,    55,    28,    29,   132,    30,    31,
+      32,    33,    79,    34,    35,    36,    37,    38,    81,    82,
+      83,    39,    40,    41,    42,    43,   117,   145,    44
 };
 
 /* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
@@ -700,87 +755,87 @@ static const yytype_uint8 yydefgoto[] =
    number is the opposite.  If YYTABLE_NINF, syntax error.  */
 static const yytype_uint8 yytable[] =
 {
-      23,    93,    50,    61,    53,    54,    55,   115,    57,    67,
-      68,    77,    77,     1,     2,     3,     4,    98,   131,    43,
-      23,    99,   132,    10,    91,    44,    46,    56,    89,    90,
-      44,    13,    14,    94,    95,    73,    74,    92,    64,    65,
-      66,    47,    15,     7,     8,     9,    96,    97,   139,   134,
-      48,    51,    23,    58,    85,    86,    87,    88,   122,   123,
-     124,   125,   126,   127,   128,    59,    61,   101,    77,    77,
-      77,    77,    77,    77,    77,    77,     1,     2,     3,     4,
-      60,    62,    63,    23,   116,   121,    10,    69,    75,    82,
-     100,   119,   102,    84,    13,    14,   109,   110,   113,   111,
-      67,    68,    23,   117,   103,    15,   104,   105,   106,   107,
-     108,   118,   120,   137,   133,    44,   135,   136,    11,   141,
-     143,     0,   142,    83,    81,   129,     0,   140,     0,     0,
-      23,     1,     2,     3,     4,     5,    23,     6,     7,     8,
-       9,    10,     0,    11,   112,    12,     0,     0,     0,    13,
-      14,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-      15,     0,     0,     0,    16,    17,    18,     1,     2,     3,
-       4,     5,     0,     6,     7,     8,     9,    10,     0,    11,
-       0,    12,     0,     0,     0,    13,    14,     0,     0,     0,
-       0,     0,     0,     0,     0,     0,    15,     0,     0,     0,
-      16,    17,    18
+      25,    53,    64,    96,    54,   135,    45,    60,    94,    48,
+      80,    80,    46,    49,    46,    61,     1,     2,     3,     4,
+       5,    95,    25,   101,    56,    57,    58,   102,    12,   135,
+      50,    51,    59,    62,    76,    77,    15,    16,   124,   125,
+     126,   127,   128,   129,   130,    70,    71,    17,    92,    93,
+     136,    63,    70,    71,    88,    25,   106,    66,   107,   108,
+     109,   110,   111,    67,    68,    69,    64,   104,    80,    80,
+      80,    80,    80,    80,    80,    80,    89,    90,    91,   140,
+     150,    97,    98,   141,   118,   123,    25,     8,     9,    10,
+      11,   121,    99,   100,    65,    72,    78,    85,    87,     1,
+       2,     3,     4,     5,     6,    25,     7,     8,     9,    10,
+      11,    12,   139,    13,   115,    14,   103,   105,   144,    15,
+      16,   112,   113,   114,   116,   119,   143,   120,   122,    46,
+      17,   137,    25,   142,    18,    19,    20,   138,    25,     1,
+       2,     3,     4,     5,     6,   149,     7,     8,     9,    10,
+      11,    12,   147,    13,    13,    14,   146,    86,    84,    15,
+      16,     1,     2,     3,     4,     5,   148,   131,     0,     0,
+      17,     0,     0,    12,    18,    19,    20,     0,     0,     0,
+       0,    15,    16,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,    17
 };
 
 static const yytype_int16 yycheck[] =
 {
-       0,    69,    10,    20,    13,    14,    15,    91,    16,    21,
-      22,    46,    47,     3,     4,     5,     6,    14,    14,    13,
-      20,    18,    18,    13,    13,    19,    13,    17,    67,    68,
-      19,    21,    22,    17,    18,    43,    44,    26,    33,    34,
-      35,    13,    32,    10,    11,    12,    17,    18,   132,   117,
-      10,    16,    52,    17,    62,    64,    65,    66,   103,   104,
-     105,   106,   107,   108,   109,    17,    83,    75,   103,   104,
-     105,   106,   107,   108,   109,   110,     3,     4,     5,     6,
-       0,    26,    17,    83,    92,   102,    13,     3,    19,    14,
-      20,    99,    14,    17,    21,    22,    24,    23,    17,    14,
-      21,    22,   102,     3,    25,    32,    27,    28,    29,    30,
-      31,     3,    20,   130,     3,    19,    26,     8,    15,   136,
-       3,    -1,   138,    52,    47,   110,    -1,   135,    -1,    -1,
-     130,     3,     4,     5,     6,     7,   136,     9,    10,    11,
-      12,    13,    -1,    15,    16,    17,    -1,    -1,    -1,    21,
-      22,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
-      32,    -1,    -1,    -1,    36,    37,    38,     3,     4,     5,
-       6,     7,    -1,     9,    10,    11,    12,    13,    -1,    15,
-      -1,    17,    -1,    -1,    -1,    21,    22,    -1,    -1,    -1,
-      -1,    -1,    -1,    -1,    -1,    -1,    32,    -1,    -1,    -1,
-      36,    37,    38
+       0,    12,    22,    72,    18,   117,    15,    18,    15,    15,
+      48,    49,    21,    15,    21,    19,     3,     4,     5,     6,
+       7,    28,    22,    16,    15,    16,    17,    20,    15,   141,
+      11,    12,    19,    19,    45,    46,    23,    24,   106,   107,
+     108,   109,   110,   111,   112,    23,    24,    34,    70,    71,
+     119,     0,    23,    24,    65,    55,    27,    19,    29,    30,
+      31,    32,    33,    35,    36,    37,    86,    78,   106,   107,
+     108,   109,   110,   111,   112,   113,    67,    68,    69,    16,
+     149,    19,    20,    20,    95,   105,    86,    11,    12,    13,
+      14,   102,    19,    20,    28,     3,    21,    16,    19,     3,
+       4,     5,     6,     7,     8,   105,    10,    11,    12,    13,
+      14,    15,   132,    17,    18,    19,    22,    16,   138,    23,
+      24,    26,    25,    16,    19,     3,   137,     3,    22,    21,
+      34,    28,   132,     3,    38,    39,    40,     9,   138,     3,
+       4,     5,     6,     7,     8,    22,    10,    11,    12,    13,
+      14,    15,    21,    17,    17,    19,   141,    55,    49,    23,
+      24,     3,     4,     5,     6,     7,   145,   113,    -1,    -1,
+      34,    -1,    -1,    15,    38,    39,    40,    -1,    -1,    -1,
+      -1,    23,    24,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    -1,    34
 };
 
 /* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
    state STATE-NUM.  */
 static const yytype_int8 yystos[] =
 {
-       0,     3,     4,     5,     6,     7,     9,    10,    11,    12,
-      13,    15,    17,    21,    22,    32,    36,    37,    38,    41,
-      42,    43,    48,    49,    51,    52,    54,    55,    57,    58,
-      59,    60,    62,    63,    64,    65,    66,    70,    71,    72,
-      73,    74,    76,    13,    19,    50,    13,    13,    10,    49,
-      60,    16,    53,    64,    64,    64,    17,    60,    17,    17,
-       0,    43,    26,    17,    33,    34,    35,    21,    22,     3,
-      44,    47,    46,    60,    60,    19,    61,    66,    67,    68,
-      69,    61,    14,    42,    17,    60,    64,    64,    64,    65,
-      65,    13,    26,    50,    17,    18,    17,    18,    14,    18,
-      20,    60,    14,    25,    27,    28,    29,    30,    31,    24,
-      23,    14,    16,    17,    45,    70,    60,     3,     3,    60,
-      20,    43,    67,    67,    67,    67,    67,    67,    67,    68,
-      56,    14,    18,     3,    50,    26,     8,    43,    75,    70,
-      60,    43,    52,     3
+       0,     3,     4,     5,     6,     7,     8,    10,    11,    12,
+      13,    14,    15,    17,    19,    23,    24,    34,    38,    39,
+      40,    43,    44,    45,    51,    52,    54,    55,    57,    58,
+      60,    61,    62,    63,    65,    66,    67,    68,    69,    73,
+      74,    75,    76,    77,    80,    15,    21,    53,    15,    15,
+      11,    12,    52,    63,    18,    56,    67,    67,    67,    19,
+      63,    19,    19,     0,    45,    28,    19,    35,    36,    37,
+      23,    24,     3,    46,    50,    49,    63,    63,    21,    64,
+      69,    70,    71,    72,    64,    16,    44,    19,    63,    67,
+      67,    67,    68,    68,    15,    28,    53,    19,    20,    19,
+      20,    16,    20,    22,    63,    16,    27,    29,    30,    31,
+      32,    33,    26,    25,    16,    18,    19,    78,    63,     3,
+       3,    63,    22,    45,    70,    70,    70,    70,    70,    70,
+      70,    71,    59,    47,    48,    73,    53,    28,     9,    45,
+      16,    20,     3,    63,    45,    79,    48,    21,    55,    22,
+      53
 };
 
 /* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
 static const yytype_int8 yyr1[] =
 {
-       0,    40,    41,    42,    42,    43,    43,    43,    43,    43,
-      43,    43,    43,    43,    43,    43,    43,    44,    44,    44,
-      44,    45,    45,    45,    46,    46,    46,    47,    47,    48,
-      49,    49,    50,    50,    51,    53,    52,    52,    54,    54,
-      56,    55,    57,    58,    59,    59,    60,    61,    62,    62,
-      62,    63,    63,    63,    63,    64,    64,    64,    64,    65,
-      65,    65,    65,    66,    66,    66,    67,    67,    67,    67,
-      67,    67,    67,    68,    68,    69,    69,    70,    70,    70,
-      71,    72,    73,    75,    74,    76
+       0,    42,    43,    44,    44,    45,    45,    45,    45,    45,
+      45,    45,    45,    45,    45,    45,    45,    46,    46,    46,
+      46,    47,    47,    47,    48,    48,    48,    49,    49,    49,
+      50,    50,    51,    52,    52,    53,    53,    54,    56,    55,
+      55,    57,    57,    59,    58,    60,    61,    62,    62,    63,
+      64,    65,    65,    65,    66,    66,    66,    66,    66,    67,
+      67,    67,    67,    68,    68,    68,    68,    69,    69,    69,
+      70,    70,    70,    70,    70,    70,    70,    71,    71,    72,
+      72,    73,    73,    73,    73,    73,    74,    75,    76,    78,
+      79,    77,    80
 };
 
 /* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
@@ -788,13 +843,14 @@ static const yytype_int8 yyr2[] =
 {
        0,     2,     1,     1,     2,     1,     1,     1,     1,     1,
        1,     1,     1,     1,     1,     1,     1,     1,     2,     3,
-       4,     2,     4,     0,     1,     3,     0,     3,     5,     3,
-       1,     2,     3,     4,     4,     0,     4,     2,     5,     7,
-       0,     6,     2,     2,     3,     2,     1,     1,     1,     1,
-       1,     3,     1,     1,     1,     1,     2,     2,     2,     1,
-       3,     3,     3,     1,     3,     3,     1,     3,     3,     3,
-       3,     3,     3,     1,     3,     1,     3,     2,     1,     1,
-       2,     1,     4,     0,     7,     3
+       4,     1,     3,     0,     2,     4,     5,     1,     3,     0,
+       3,     5,     3,     1,     2,     3,     4,     4,     0,     4,
+       2,     5,     7,     0,     6,     2,     2,     3,     2,     1,
+       1,     1,     1,     1,     3,     1,     1,     1,     1,     1,
+       2,     2,     2,     1,     3,     3,     3,     1,     3,     3,
+       1,     3,     3,     3,     3,     3,     3,     1,     3,     1,
+       3,     2,     2,     1,     1,     1,     2,     1,     4,     0,
+       0,     8,     3
 };
 
 
@@ -1528,101 +1584,101 @@ yyreduce:
   switch (yyn)
     {
   case 2: /* Program: Stmts  */
-#line 60 "src/parser.y"
+#line 112 "src/parser.y"
             {
         ast.setRoot((yyvsp[0].stmttype));
     }
-#line 1536 "src/parser.cpp"
+#line 1592 "src/parser.cpp"
     break;
 
   case 3: /* Stmts: Stmt  */
-#line 65 "src/parser.y"
+#line 117 "src/parser.y"
            {(yyval.stmttype)=(yyvsp[0].stmttype);}
-#line 1542 "src/parser.cpp"
+#line 1598 "src/parser.cpp"
     break;
 
   case 4: /* Stmts: Stmts Stmt  */
-#line 66 "src/parser.y"
+#line 118 "src/parser.y"
                 {
         (yyval.stmttype) = new SeqNode((yyvsp[-1].stmttype), (yyvsp[0].stmttype));
     }
-#line 1550 "src/parser.cpp"
+#line 1606 "src/parser.cpp"
     break;
 
   case 5: /* Stmt: AssignStmt  */
-#line 71 "src/parser.y"
+#line 123 "src/parser.y"
                  {(yyval.stmttype)=(yyvsp[0].stmttype);}
-#line 1556 "src/parser.cpp"
+#line 1612 "src/parser.cpp"
     break;
 
   case 6: /* Stmt: BlockStmt  */
-#line 72 "src/parser.y"
+#line 124 "src/parser.y"
                 {(yyval.stmttype)=(yyvsp[0].stmttype);}
-#line 1562 "src/parser.cpp"
+#line 1618 "src/parser.cpp"
     break;
 
   case 7: /* Stmt: IfStmt  */
-#line 73 "src/parser.y"
+#line 125 "src/parser.y"
              {(yyval.stmttype)=(yyvsp[0].stmttype);}
-#line 1568 "src/parser.cpp"
+#line 1624 "src/parser.cpp"
     break;
 
   case 8: /* Stmt: BreakStmt  */
-#line 74 "src/parser.y"
+#line 126 "src/parser.y"
                 {(yyval.stmttype)=(yyvsp[0].stmttype);}
-#line 1574 "src/parser.cpp"
+#line 1630 "src/parser.cpp"
     break;
 
   case 9: /* Stmt: ContinueStmt  */
-#line 75 "src/parser.y"
+#line 127 "src/parser.y"
                    {(yyval.stmttype)=(yyvsp[0].stmttype);}
-#line 1580 "src/parser.cpp"
+#line 1636 "src/parser.cpp"
     break;
 
   case 10: /* Stmt: ReturnStmt  */
-#line 76 "src/parser.y"
+#line 128 "src/parser.y"
                  {(yyval.stmttype)=(yyvsp[0].stmttype);}
-#line 1586 "src/parser.cpp"
+#line 1642 "src/parser.cpp"
     break;
 
   case 11: /* Stmt: DeclStmt  */
-#line 77 "src/parser.y"
+#line 129 "src/parser.y"
                {(yyval.stmttype)=(yyvsp[0].stmttype);}
-#line 1592 "src/parser.cpp"
+#line 1648 "src/parser.cpp"
     break;
 
   case 12: /* Stmt: FuncDef  */
-#line 78 "src/parser.y"
+#line 130 "src/parser.y"
               {(yyval.stmttype)=(yyvsp[0].stmttype);}
-#line 1598 "src/parser.cpp"
+#line 1654 "src/parser.cpp"
     break;
 
   case 13: /* Stmt: InitStmt  */
-#line 79 "src/parser.y"
+#line 131 "src/parser.y"
                {(yyval.stmttype)=(yyvsp[0].stmttype);}
-#line 1604 "src/parser.cpp"
+#line 1660 "src/parser.cpp"
     break;
 
   case 14: /* Stmt: ExprStmt  */
-#line 80 "src/parser.y"
+#line 132 "src/parser.y"
                {(yyval.stmttype)=(yyvsp[0].stmttype);}
-#line 1610 "src/parser.cpp"
+#line 1666 "src/parser.cpp"
     break;
 
   case 15: /* Stmt: WhileStmt  */
-#line 81 "src/parser.y"
+#line 133 "src/parser.y"
                 {(yyval.stmttype)=(yyvsp[0].stmttype);}
-#line 1616 "src/parser.cpp"
+#line 1672 "src/parser.cpp"
     break;
 
   case 16: /* Stmt: BlankStmt  */
-#line 82 "src/parser.y"
+#line 134 "src/parser.y"
                 {(yyval.stmttype)=(yyvsp[0].stmttype);}
-#line 1622 "src/parser.cpp"
+#line 1678 "src/parser.cpp"
     break;
 
   case 17: /* IDList: ID  */
-#line 87 "src/parser.y"
+#line 139 "src/parser.y"
          {
     	SymbolEntry *se;
         se=identifiers->lookup((yyvsp[0].strtype));
@@ -1636,11 +1692,11 @@ yyreduce:
         idlist.push(se);
         (yyval.idlist) = new IDList(idlist);
     }
-#line 1640 "src/parser.cpp"
+#line 1696 "src/parser.cpp"
     break;
 
   case 18: /* IDList: ID Array  */
-#line 100 "src/parser.y"
+#line 152 "src/parser.y"
                {
         
         SymbolEntry *se;
@@ -1649,24 +1705,7 @@ yyreduce:
         {
             fprintf(stderr, "identifier \"%s\" has already been defined\n", (char*)(yyvsp[-1].strtype));
         }
-        std::vector<int> vec;
-        ExprNode* temp = (yyvsp[0].exprtype);
-        while(temp){
-            ConstantSymbolEntry* len=(ConstantSymbolEntry*)temp->getSymPtr();
-            //std::cout<<len->getValue()<<std::endl;
-            vec.push_back(len->getValue());
-            temp = (ExprNode*)(temp->getNext());
-        }
-        Type *type = TypeSystem::intType;
-        Type* temp1;
-        while(!vec.empty()){
-            //std::cout<<vec.back()<<std::endl;
-            temp1 = new ArrayType(type, vec.back());
-            if(type->isArray())
-                ((ArrayType*)type)->setArrayType(temp1);
-            type = temp1;
-            vec.pop_back();
-        }
+        Type *type = arrayOf((yyvsp[0].exprtype));
         arrayType = (ArrayType*)type;
         se = new IdentifierSymbolEntry(type, (yyvsp[-1].strtype), identifiers->getLevel());
         ((IdentifierSymbolEntry*)se)->setArr();
@@ -1680,11 +1719,11 @@ yyreduce:
         (yyval.idlist) = new IDList(idlist);
         
     }
-#line 1684 "src/parser.cpp"
+#line 1723 "src/parser.cpp"
     break;
 
   case 19: /* IDList: IDList COMMA ID  */
-#line 139 "src/parser.y"
+#line 174 "src/parser.y"
                       {
     	SymbolEntry *se;
         se=identifiers->lookup((yyvsp[0].strtype));
@@ -1698,11 +1737,11 @@ yyreduce:
         idl.push(se);
         (yyval.idlist)=new IDList(idl);
     }
-#line 1702 "src/parser.cpp"
+#line 1741 "src/parser.cpp"
     break;
 
   case 20: /* IDList: IDList COMMA ID Array  */
-#line 152 "src/parser.y"
+#line 187 "src/parser.y"
                             {
         SymbolEntry *se;
         se=identifiers->lookup((yyvsp[-1].strtype));
@@ -1710,94 +1749,104 @@ yyreduce:
         {
             fprintf(stderr, "identifier \"%s\" has already been defined\n", (char*)(yyvsp[-3].idlist));
         }
-        std::vector<int> vec;
-        ExprNode* temp = (yyvsp[0].exprtype);
-        while(temp){
-            vec.push_back(((ConstantSymbolEntry*)temp->getSymPtr())->getValue());
-            temp = (ExprNode*)(temp->getNext());
-        }
-        Type *type = TypeSystem::intType;
-        Type* temp1;
-        while(!vec.empty()){
-            temp1 = new ArrayType(type, vec.back());
-            if(type->isArray())
-                ((ArrayType*)type)->setArrayType(temp1);
-            type = temp1;
-            vec.pop_back();
-        }
+        Type *type = arrayOf((yyvsp[0].exprtype));
         arrayType = (ArrayType*)type;
         se = new IdentifierSymbolEntry(type, (yyvsp[-1].strtype), identifiers->getLevel());
+        ((IdentifierSymbolEntry*)se)->setArr();
+        ((IdentifierSymbolEntry*)se)->setArrLen(((ArrayType*)type)->getSize());
         identifiers->install((yyvsp[-1].strtype), se);
         std::queue<SymbolEntry*> idl = (yyvsp[-3].idlist)->getList();
         idl.push(se);
         (yyval.idlist)=new IDList(idl);
     }
-#line 1736 "src/parser.cpp"
+#line 1763 "src/parser.cpp"
     break;
 
-  case 21: /* ParaList: Type ID  */
-#line 184 "src/parser.y"
-            {
-        SymbolEntry *se = new IdentifierSymbolEntry((yyvsp[-1].type), (yyvsp[0].strtype), identifiers->getLevel());
-        
-        identifiers->install((yyvsp[0].strtype), se);
+  case 21: /* ParaList: FuncParam  */
+#line 207 "src/parser.y"
+              {
         std::queue<SymbolEntry*> idList;
-        idList.push(se);
+        idList.push((yyvsp[0].setype));
         (yyval.paraList) = new ParaList(idList);
-        // delete []$2;
     }
-#line 1750 "src/parser.cpp"
+#line 1773 "src/parser.cpp"
     break;
 
-  case 22: /* ParaList: ParaList COMMA Type ID  */
-#line 194 "src/parser.y"
-                          {
-        SymbolEntry *se = new IdentifierSymbolEntry((yyvsp[-1].type), (yyvsp[0].strtype), identifiers->getLevel());
-        identifiers->install((yyvsp[0].strtype), se);
-        std::queue<SymbolEntry*> idList = (yyvsp[-3].paraList)->getList();
-        idList.push(se);
+  case 22: /* ParaList: ParaList COMMA FuncParam  */
+#line 213 "src/parser.y"
+                             {
+        std::queue<SymbolEntry*> idList = (yyvsp[-2].paraList)->getList();
+        idList.push((yyvsp[0].setype));
         (yyval.paraList) = new ParaList(idList);
-        // delete []$2;
     }
-#line 1763 "src/parser.cpp"
+#line 1783 "src/parser.cpp"
     break;
 
   case 23: /* ParaList: %empty  */
-#line 202 "src/parser.y"
+#line 218 "src/parser.y"
              {(yyval.paraList) = new ParaList();}
-#line 1769 "src/parser.cpp"
+#line 1789 "src/parser.cpp"
     break;
 
-  case 24: /* ParaIDList: Exp  */
-#line 208 "src/parser.y"
+  case 24: /* FuncParam: Type ID  */
+#line 223 "src/parser.y"
+            {
+        (yyval.setype) = new IdentifierSymbolEntry((yyvsp[-1].type), (yyvsp[0].strtype), identifiers->getLevel());
+        identifiers->install((yyvsp[0].strtype), (yyval.setype));
+        // delete []$2;
+    }
+#line 1799 "src/parser.cpp"
+    break;
+
+  case 25: /* FuncParam: Type ID LBRACKET RBRACKET  */
+#line 229 "src/parser.y"
+                              {
+        // int a[] is passed as a pointer to its first element
+        (yyval.setype) = new IdentifierSymbolEntry(new PointerType(arrayOf(nullptr)), (yyvsp[-2].strtype), identifiers->getLevel());
+        identifiers->install((yyvsp[-2].strtype), (yyval.setype));
+    }
+#line 1809 "src/parser.cpp"
+    break;
+
+  case 26: /* FuncParam: Type ID LBRACKET RBRACKET Array  */
+#line 235 "src/parser.y"
+                                    {
+        (yyval.setype) = new IdentifierSymbolEntry(new PointerType(arrayOf((yyvsp[0].exprtype))), (yyvsp[-3].strtype), identifiers->getLevel());
+        identifiers->install((yyvsp[-3].strtype), (yyval.setype));
+    }
+#line 1818 "src/parser.cpp"
+    break;
+
+  case 27: /* ParaIDList: Exp  */
+#line 243 "src/parser.y"
         {
         std::queue<ExprNode*> exprlist;
         exprlist.push((yyvsp[0].exprtype));
         (yyval.paraIdList) = new ParaIDList(exprlist);
         // delete []$2;
     }
-#line 1780 "src/parser.cpp"
+#line 1829 "src/parser.cpp"
     break;
 
-  case 25: /* ParaIDList: ParaIDList COMMA Exp  */
-#line 215 "src/parser.y"
+  case 28: /* ParaIDList: ParaIDList COMMA Exp  */
+#line 250 "src/parser.y"
                          {
         std::queue<ExprNode*> exprlist=(yyvsp[-2].paraIdList)->getList();
         exprlist.push((yyvsp[0].exprtype));
         (yyval.paraIdList) = new ParaIDList(exprlist);
         // delete []$2;
     }
-#line 1791 "src/parser.cpp"
+#line 1840 "src/parser.cpp"
     break;
 
-  case 26: /* ParaIDList: %empty  */
-#line 221 "src/parser.y"
+  case 29: /* ParaIDList: %empty  */
+#line 256 "src/parser.y"
              {(yyval.paraIdList) = new ParaIDList();}
-#line 1797 "src/parser.cpp"
+#line 1846 "src/parser.cpp"
     break;
 
-  case 27: /* InitIDList: ID ASSIGN Exp  */
-#line 226 "src/parser.y"
+  case 30: /* InitIDList: ID ASSIGN Exp  */
+#line 261 "src/parser.y"
                   {
         SymbolEntry *se;
         se=identifiers->lookup((yyvsp[-2].strtype));
@@ -1810,15 +1859,15 @@ yyreduce:
         std::queue<SymbolEntry*> idList;
         std::queue<ExprNode*> nums;
         idList.push(se);
-        nums.push((yyvsp[0].exprtype));
+        nums.push(initOf((IdentifierSymbolEntry*)se, (yyvsp[0].exprtype)));
         (yyval.initIdList) = new InitIDList(idList, nums);
         delete (yyvsp[-2].strtype);
     }
-#line 1818 "src/parser.cpp"
+#line 1867 "src/parser.cpp"
     break;
 
-  case 28: /* InitIDList: InitIDList COMMA ID ASSIGN Exp  */
-#line 243 "src/parser.y"
+  case 31: /* InitIDList: InitIDList COMMA ID ASSIGN Exp  */
+#line 278 "src/parser.y"
                                    {
         SymbolEntry *se;
         se=identifiers->lookup((yyvsp[-2].strtype));
@@ -1831,25 +1880,25 @@ yyreduce:
         std::queue<SymbolEntry*> *idList = (yyvsp[-4].initIdList)->getList();
         std::queue<ExprNode*> *nums = (yyvsp[-4].initIdList)->getNums();
         idList->push(se);
-        nums->push((yyvsp[0].exprtype));
+        nums->push(initOf((IdentifierSymbolEntry*)se, (yyvsp[0].exprtype)));
         (yyval.initIdList) = new InitIDList(*idList, *nums);
         delete (yyvsp[-2].strtype);
     }
-#line 1839 "src/parser.cpp"
+#line 1888 "src/parser.cpp"
     break;
 
-  case 29: /* InitStmt: Type InitIDList SEMICOLON  */
-#line 262 "src/parser.y"
+  case 32: /* InitStmt: Type InitIDList SEMICOLON  */
+#line 297 "src/parser.y"
                               {
         (yyvsp[-1].initIdList)->setType((yyvsp[-2].type));
         (yyval.stmttype) = new InitStmt((yyvsp[-1].initIdList));
         // delete []$2;
     }
-#line 1849 "src/parser.cpp"
+#line 1898 "src/parser.cpp"
     break;
 
-  case 30: /* LVal: ID  */
-#line 270 "src/parser.y"
+  case 33: /* LVal: ID  */
+#line 305 "src/parser.y"
          {
         SymbolEntry *se;
         se = identifiers->lookup((yyvsp[0].strtype));
@@ -1862,11 +1911,11 @@ yyreduce:
         (yyval.exprtype) = new Id(se);
         delete [](yyvsp[0].strtype);
     }
-#line 1866 "src/parser.cpp"
+#line 1915 "src/parser.cpp"
     break;
 
-  case 31: /* LVal: ID Array  */
-#line 283 "src/parser.y"
+  case 34: /* LVal: ID Array  */
+#line 318 "src/parser.y"
     {
         SymbolEntry* se;
         se = identifiers->lookup((yyvsp[-1].strtype));
@@ -1879,119 +1928,120 @@ yyreduce:
         (yyval.exprtype) = new Id(se, (yyvsp[0].exprtype));
         //delete []$1;
     }
-#line 1883 "src/parser.cpp"
+#line 1932 "src/parser.cpp"
     break;
 
-  case 32: /* Array: LBRACKET Exp RBRACKET  */
-#line 299 "src/parser.y"
+  case 35: /* Array: LBRACKET Exp RBRACKET  */
+#line 334 "src/parser.y"
     {
         (yyval.exprtype) = (yyvsp[-1].exprtype);
     }
-#line 1891 "src/parser.cpp"
+#line 1940 "src/parser.cpp"
     break;
 
-  case 33: /* Array: Array LBRACKET Exp RBRACKET  */
-#line 303 "src/parser.y"
+  case 36: /* Array: Array LBRACKET Exp RBRACKET  */
+#line 338 "src/parser.y"
     {
         (yyval.exprtype) = (yyvsp[-3].exprtype);
         (yyvsp[-3].exprtype)->setNext((yyvsp[-1].exprtype));
     }
-#line 1900 "src/parser.cpp"
+#line 1949 "src/parser.cpp"
     break;
 
-  case 34: /* AssignStmt: LVal ASSIGN Exp SEMICOLON  */
-#line 311 "src/parser.y"
+  case 37: /* AssignStmt: LVal ASSIGN Exp SEMICOLON  */
+#line 346 "src/parser.y"
                               {
         (yyval.stmttype) = new AssignStmt((yyvsp[-3].exprtype), (yyvsp[-1].exprtype));
     }
-#line 1908 "src/parser.cpp"
+#line 1957 "src/parser.cpp"
     break;
 
-  case 35: /* $@1: %empty  */
-#line 318 "src/parser.y"
+  case 38: /* $@1: %empty  */
+#line 353 "src/parser.y"
         {identifiers = new SymbolTable(identifiers);}
-#line 1914 "src/parser.cpp"
+#line 1963 "src/parser.cpp"
     break;
 
-  case 36: /* BlockStmt: LBRACE $@1 Stmts RBRACE  */
-#line 320 "src/parser.y"
+  case 39: /* BlockStmt: LBRACE $@1 Stmts RBRACE  */
+#line 355 "src/parser.y"
         {
             (yyval.stmttype) = new CompoundStmt((yyvsp[-1].stmttype));
             SymbolTable *top = identifiers;
             identifiers = identifiers->getPrev();
             delete top;
         }
-#line 1925 "src/parser.cpp"
+#line 1974 "src/parser.cpp"
     break;
 
-  case 37: /* BlockStmt: LBRACE RBRACE  */
-#line 327 "src/parser.y"
+  case 40: /* BlockStmt: LBRACE RBRACE  */
+#line 362 "src/parser.y"
                   {
         (yyval.stmttype) = new CompoundStmt();
     }
-#line 1933 "src/parser.cpp"
+#line 1982 "src/parser.cpp"
     break;
 
-  case 38: /* IfStmt: IF LPAREN Cond RPAREN Stmt  */
-#line 332 "src/parser.y"
+  case 41: /* IfStmt: IF LPAREN Cond RPAREN Stmt  */
+#line 367 "src/parser.y"
                                             {
         (yyval.stmttype) = new IfStmt((yyvsp[-2].exprtype), (yyvsp[0].stmttype));
     }
-#line 1941 "src/parser.cpp"
+#line 1990 "src/parser.cpp"
     break;
 
-  case 39: /* IfStmt: IF LPAREN Cond RPAREN Stmt ELSE Stmt  */
-#line 335 "src/parser.y"
+  case 42: /* IfStmt: IF LPAREN Cond RPAREN Stmt ELSE Stmt  */
+#line 370 "src/parser.y"
                                            {
         (yyval.stmttype) = new IfElseStmt((yyvsp[-4].exprtype), (yyvsp[-2].stmttype), (yyvsp[0].stmttype));
     }
-#line 1949 "src/parser.cpp"
+#line 1998 "src/parser.cpp"
     break;
 
-  case 40: /* @2: %empty  */
-#line 340 "src/parser.y"
+  case 43: /* @2: %empty  */
+#line 375 "src/parser.y"
                                {
         WhileStmt *whileNode = new WhileStmt((yyvsp[-1].exprtype));
         (yyval.stmttype) = whileNode;
         whileS.push(whileNode);
     }
-#line 1959 "src/parser.cpp"
+#line 2008 "src/parser.cpp"
     break;
 
-  case 41: /* WhileStmt: WHILE LPAREN Cond RPAREN @2 Stmt  */
-#line 344 "src/parser.y"
+  case 44: /* WhileStmt: WHILE LPAREN Cond RPAREN @2 Stmt  */
+#line 379 "src/parser.y"
           {
     	StmtNode *whileNode = (yyvsp[-1].stmttype); 
         ((WhileStmt*)whileNode)->setStmt((yyvsp[0].stmttype));
         (yyval.stmttype)=whileNode;
         whileS.pop();
     }
-#line 1970 "src/parser.cpp"
+#line 2019 "src/parser.cpp"
     break;
 
-  case 42: /* BreakStmt: BREAK SEMICOLON  */
-#line 352 "src/parser.y"
+  case 45: /* BreakStmt: BREAK SEMICOLON  */
+#line 387 "src/parser.y"
                       {
         (yyval.stmttype) = new BreakStmt(whileS.top());
     }
-#line 1978 "src/parser.cpp"
+#line 2027 "src/parser.cpp"
     break;
 
-  case 43: /* ContinueStmt: CONTINUE SEMICOLON  */
-#line 357 "src/parser.y"
+  case 46: /* ContinueStmt: CONTINUE SEMICOLON  */
+#line 392 "src/parser.y"
                          {
         (yyval.stmttype) = new ContinueStmt(whileS.top());
     }
-#line 1986 "src/parser.cpp"
+#line 2035 "src/parser.cpp"
     break;
 
-  case 44: /* ReturnStmt: RETURN Exp SEMICOLON  */
-#line 363 "src/parser.y"
+  case 47: /* ReturnStmt: RETURN Exp SEMICOLON  */
+#line 398 "src/parser.y"
                          {
         ifReturn=1;
-        Type *retType=(yyvsp[-1].exprtype)->getSymPtr()->getType();
+        Type *retType=(yyvsp[-1].exprtype)->getOperand()->getType();
         if(retType->isFunc()){
-            if(((FunctionType*)retType)->getRetType()!=funcionRetType)
+            Type *callType=((FunctionType*)retType)->getRetType();
+            if(callType!=funcionRetType && !(callType->isNumber() && funcionRetType->isNumber()))
                 fprintf(stderr, "the return_type of \"%s\" is wrong\n", funcName.c_str());
         }
         else if(retType==TypeSystem::constintType){
@@ -1999,16 +2049,16 @@ yyreduce:
                 fprintf(stderr, "the return_type of \"%s\" is wrong\n", funcName.c_str());
             }
         }
-        else if(retType!=funcionRetType){
+        else if(retType!=funcionRetType && !(retType->isNumber() && funcionRetType->isNumber())){
             fprintf(stderr, "the return_type of \"%s\" is wrong\n", funcName.c_str());
         }
         (yyval.stmttype) = new ReturnStmt((yyvsp[-1].exprtype));
     }
-#line 2008 "src/parser.cpp"
+#line 2058 "src/parser.cpp"
     break;
 
-  case 45: /* ReturnStmt: RETURN SEMICOLON  */
-#line 380 "src/parser.y"
+  case 48: /* ReturnStmt: RETURN SEMICOLON  */
+#line 416 "src/parser.y"
                        {
         ifReturn=1;
         if(funcionRetType!=TypeSystem::voidType){
@@ -2016,293 +2066,328 @@ yyreduce:
         }
         (yyval.stmttype) = new ReturnStmt();
     }
-#line 2020 "src/parser.cpp"
+#line 2070 "src/parser.cpp"
     break;
 
-  case 46: /* Exp: AddExp  */
-#line 390 "src/parser.y"
+  case 49: /* Exp: AddExp  */
+#line 426 "src/parser.y"
            {(yyval.exprtype) = (yyvsp[0].exprtype);}
-#line 2026 "src/parser.cpp"
+#line 2076 "src/parser.cpp"
     break;
 
-  case 47: /* Cond: LOrExp  */
-#line 394 "src/parser.y"
+  case 50: /* Cond: LOrExp  */
+#line 430 "src/parser.y"
           {(yyval.exprtype)=(yyvsp[0].exprtype);}
-#line 2032 "src/parser.cpp"
+#line 2082 "src/parser.cpp"
     break;
 
-  case 48: /* Intint: INTEGER  */
-#line 398 "src/parser.y"
+  case 51: /* Intint: INTEGER  */
+#line 434 "src/parser.y"
             {(yyval.itype)=(yyvsp[0].itype);}
-#line 2038 "src/parser.cpp"
+#line 2088 "src/parser.cpp"
     break;
 
-  case 49: /* Intint: HEXADECIMAL  */
-#line 400 "src/parser.y"
+  case 52: /* Intint: HEXADECIMAL  */
+#line 436 "src/parser.y"
                 {(yyval.itype)=(yyvsp[0].itype);}
-#line 2044 "src/parser.cpp"
+#line 2094 "src/parser.cpp"
     break;
 
-  case 50: /* Intint: OCTAL  */
-#line 402 "src/parser.y"
+  case 53: /* Intint: OCTAL  */
+#line 438 "src/parser.y"
           {(yyval.itype)=(yyvsp[0].itype);}
-#line 2050 "src/parser.cpp"
+#line 2100 "src/parser.cpp"
     break;
 
-  case 51: /* PrimaryExp: LPAREN Exp RPAREN  */
-#line 406 "src/parser.y"
+  case 54: /* PrimaryExp: LPAREN Exp RPAREN  */
+#line 442 "src/parser.y"
                       {(yyval.exprtype)=(yyvsp[-1].exprtype);}
-#line 2056 "src/parser.cpp"
+#line 2106 "src/parser.cpp"
     break;
 
-  case 52: /* PrimaryExp: LVal  */
-#line 408 "src/parser.y"
+  case 55: /* PrimaryExp: LVal  */
+#line 444 "src/parser.y"
          {
         (yyval.exprtype) = (yyvsp[0].exprtype);
     }
-#line 2064 "src/parser.cpp"
+#line 2114 "src/parser.cpp"
     break;
 
-  case 53: /* PrimaryExp: Intint  */
-#line 411 "src/parser.y"
+  case 56: /* PrimaryExp: Intint  */
+#line 447 "src/parser.y"
              {
         SymbolEntry *se = new ConstantSymbolEntry(TypeSystem::intType, (yyvsp[0].itype));
         (yyval.exprtype) = new Constant(se);
     }
-#line 2073 "src/parser.cpp"
+#line 2123 "src/parser.cpp"
     break;
 
-  case 54: /* PrimaryExp: FuncExpr  */
-#line 415 "src/parser.y"
+  case 57: /* PrimaryExp: FLOATING  */
+#line 451 "src/parser.y"
+               {
+        SymbolEntry *se = new ConstantSymbolEntry(TypeSystem::floatType, (yyvsp[0].ftype));
+        (yyval.exprtype) = new Constant(se);
+    }
+#line 2132 "src/parser.cpp"
+    break;
+
+  case 58: /* PrimaryExp: FuncExpr  */
+#line 455 "src/parser.y"
                {
     	(yyval.exprtype)=(yyvsp[0].exprtype);
     }
-#line 2081 "src/parser.cpp"
+#line 2140 "src/parser.cpp"
     break;
 
-  case 55: /* NotExp: PrimaryExp  */
-#line 421 "src/parser.y"
+  case 59: /* NotExp: PrimaryExp  */
+#line 461 "src/parser.y"
                {(yyval.exprtype) = (yyvsp[0].exprtype);}
-#line 2087 "src/parser.cpp"
+#line 2146 "src/parser.cpp"
     break;
 
-  case 56: /* NotExp: NOT NotExp  */
-#line 423 "src/parser.y"
+  case 60: /* NotExp: NOT NotExp  */
+#line 463 "src/parser.y"
                {
         SymbolEntry *se = new TemporarySymbolEntry(TypeSystem::boolType, SymbolTable::getLabel());
         (yyval.exprtype) = new SingelExpr(se, SingelExpr::NOT, (yyvsp[0].exprtype));        
     }
-#line 2096 "src/parser.cpp"
+#line 2155 "src/parser.cpp"
     break;
 
-  case 57: /* NotExp: ADD NotExp  */
-#line 428 "src/parser.y"
+  case 61: /* NotExp: ADD NotExp  */
+#line 468 "src/parser.y"
                {
 
         SymbolEntry *se = new TemporarySymbolEntry(TypeSystem::intType, SymbolTable::getLabel());
         (yyval.exprtype) = new SingelExpr(se, SingelExpr::POS, (yyvsp[0].exprtype));  
     }
-#line 2106 "src/parser.cpp"
+#line 2165 "src/parser.cpp"
     break;
 
-  case 58: /* NotExp: SUB NotExp  */
-#line 434 "src/parser.y"
+  case 62: /* NotExp: SUB NotExp  */
+#line 474 "src/parser.y"
                {
         SymbolEntry *se = new TemporarySymbolEntry(TypeSystem::intType, SymbolTable::getLabel());
         (yyval.exprtype) = new SingelExpr(se, SingelExpr::MIN, (yyvsp[0].exprtype));  
     }
-#line 2115 "src/parser.cpp"
+#line 2174 "src/parser.cpp"
     break;
 
-  case 59: /* MulExp: NotExp  */
-#line 441 "src/parser.y"
+  case 63: /* MulExp: NotExp  */
+#line 481 "src/parser.y"
            {(yyval.exprtype)=(yyvsp[0].exprtype);}
-#line 2121 "src/parser.cpp"
+#line 2180 "src/parser.cpp"
     break;
 
-  case 60: /* MulExp: MulExp MUL NotExp  */
-#line 444 "src/parser.y"
+  case 64: /* MulExp: MulExp MUL NotExp  */
+#line 484 "src/parser.y"
     {
         SymbolEntry *se = new TemporarySymbolEntry(TypeSystem::intType, SymbolTable::getLabel());
         (yyval.exprtype) = new BinaryExpr(se, BinaryExpr::MUL, (yyvsp[-2].exprtype), (yyvsp[0].exprtype));
     }
-#line 2130 "src/parser.cpp"
+#line 2189 "src/parser.cpp"
     break;
 
-  case 61: /* MulExp: MulExp DIV NotExp  */
-#line 450 "src/parser.y"
+  case 65: /* MulExp: MulExp DIV NotExp  */
+#line 490 "src/parser.y"
     {
         SymbolEntry *se = new TemporarySymbolEntry(TypeSystem::intType, SymbolTable::getLabel());
         (yyval.exprtype) = new BinaryExpr(se, BinaryExpr::DIV, (yyvsp[-2].exprtype), (yyvsp[0].exprtype));
     }
-#line 2139 "src/parser.cpp"
+#line 2198 "src/parser.cpp"
     break;
 
-  case 62: /* MulExp: MulExp MOD NotExp  */
-#line 456 "src/parser.y"
+  case 66: /* MulExp: MulExp MOD NotExp  */
+#line 496 "src/parser.y"
     {
         SymbolEntry *se = new TemporarySymbolEntry(TypeSystem::intType, SymbolTable::getLabel());
         (yyval.exprtype) = new BinaryExpr(se, BinaryExpr::MOD, (yyvsp[-2].exprtype), (yyvsp[0].exprtype));
     }
-#line 2148 "src/parser.cpp"
+#line 2207 "src/parser.cpp"
     break;
 
-  case 63: /* AddExp: MulExp  */
-#line 463 "src/parser.y"
+  case 67: /* AddExp: MulExp  */
+#line 503 "src/parser.y"
           {(yyval.exprtype)=(yyvsp[0].exprtype);}
-#line 2154 "src/parser.cpp"
+#line 2213 "src/parser.cpp"
     break;
 
-  case 64: /* AddExp: AddExp ADD MulExp  */
-#line 466 "src/parser.y"
+  case 68: /* AddExp: AddExp ADD MulExp  */
+#line 506 "src/parser.y"
     {
         SymbolEntry *se = new TemporarySymbolEntry(TypeSystem::intType, SymbolTable::getLabel());
         (yyval.exprtype) = new BinaryExpr(se, BinaryExpr::ADD, (yyvsp[-2].exprtype), (yyvsp[0].exprtype));
     }
-#line 2163 "src/parser.cpp"
+#line 2222 "src/parser.cpp"
     break;
 
-  case 65: /* AddExp: AddExp SUB MulExp  */
-#line 472 "src/parser.y"
+  case 69: /* AddExp: AddExp SUB MulExp  */
+#line 512 "src/parser.y"
     {
         SymbolEntry *se = new TemporarySymbolEntry(TypeSystem::intType, SymbolTable::getLabel());
         (yyval.exprtype) = new BinaryExpr(se, BinaryExpr::SUB, (yyvsp[-2].exprtype), (yyvsp[0].exprtype));
     }
-#line 2172 "src/parser.cpp"
+#line 2231 "src/parser.cpp"
     break;
 
-  case 66: /* RelExp: AddExp  */
-#line 479 "src/parser.y"
+  case 70: /* RelExp: AddExp  */
+#line 519 "src/parser.y"
            {(yyval.exprtype) = (yyvsp[0].exprtype);}
-#line 2178 "src/parser.cpp"
+#line 2237 "src/parser.cpp"
     break;
 
-  case 67: /* RelExp: AddExp LESSEQ RelExp  */
-#line 482 "src/parser.y"
+  case 71: /* RelExp: AddExp LESSEQ RelExp  */
+#line 522 "src/parser.y"
     {
         SymbolEntry *se = new TemporarySymbolEntry(TypeSystem::intType, SymbolTable::getLabel());
         (yyval.exprtype) = new BinaryExpr(se, BinaryExpr::LESSEQ, (yyvsp[-2].exprtype), (yyvsp[0].exprtype));
     }
-#line 2187 "src/parser.cpp"
+#line 2246 "src/parser.cpp"
     break;
 
-  case 68: /* RelExp: AddExp MOREEQ RelExp  */
-#line 488 "src/parser.y"
+  case 72: /* RelExp: AddExp MOREEQ RelExp  */
+#line 528 "src/parser.y"
     {
         SymbolEntry *se = new TemporarySymbolEntry(TypeSystem::intType, SymbolTable::getLabel());
         (yyval.exprtype) = new BinaryExpr(se, BinaryExpr::MOREEQ, (yyvsp[-2].exprtype), (yyvsp[0].exprtype));
     }
-#line 2196 "src/parser.cpp"
+#line 2255 "src/parser.cpp"
     break;
 
-  case 69: /* RelExp: AddExp LESS RelExp  */
-#line 494 "src/parser.y"
+  case 73: /* RelExp: AddExp LESS RelExp  */
+#line 534 "src/parser.y"
     {
         SymbolEntry *se = new TemporarySymbolEntry(TypeSystem::intType, SymbolTable::getLabel());
         (yyval.exprtype) = new BinaryExpr(se, BinaryExpr::LESS, (yyvsp[-2].exprtype), (yyvsp[0].exprtype));
     }
-#line 2205 "src/parser.cpp"
+#line 2264 "src/parser.cpp"
     break;
 
-  case 70: /* RelExp: AddExp MORE RelExp  */
-#line 500 "src/parser.y"
+  case 74: /* RelExp: AddExp MORE RelExp  */
+#line 540 "src/parser.y"
     {
         SymbolEntry *se = new TemporarySymbolEntry(TypeSystem::intType, SymbolTable::getLabel());
         (yyval.exprtype) = new BinaryExpr(se, BinaryExpr::MORE, (yyvsp[-2].exprtype), (yyvsp[0].exprtype));
     }
-#line 2214 "src/parser.cpp"
+#line 2273 "src/parser.cpp"
     break;
 
-  case 71: /* RelExp: AddExp EQUAL RelExp  */
-#line 506 "src/parser.y"
+  case 75: /* RelExp: AddExp EQUAL RelExp  */
+#line 546 "src/parser.y"
     {
         SymbolEntry *se = new TemporarySymbolEntry(TypeSystem::intType, SymbolTable::getLabel());
         (yyval.exprtype) = new BinaryExpr(se, BinaryExpr::EQUAL, (yyvsp[-2].exprtype), (yyvsp[0].exprtype));
     }
-#line 2223 "src/parser.cpp"
+#line 2282 "src/parser.cpp"
     break;
 
-  case 72: /* RelExp: AddExp NOTEQUAL RelExp  */
-#line 512 "src/parser.y"
+  case 76: /* RelExp: AddExp NOTEQUAL RelExp  */
+#line 552 "src/parser.y"
     {
         SymbolEntry *se = new TemporarySymbolEntry(TypeSystem::intType, SymbolTable::getLabel());
         (yyval.exprtype) = new BinaryExpr(se, BinaryExpr::NOTEQUAL, (yyvsp[-2].exprtype), (yyvsp[0].exprtype));
     }
-#line 2232 "src/parser.cpp"
+#line 2291 "src/parser.cpp"
     break;
 
-  case 73: /* LAndExp: RelExp  */
-#line 519 "src/parser.y"
+  case 77: /* LAndExp: RelExp  */
+#line 559 "src/parser.y"
            {(yyval.exprtype) = (yyvsp[0].exprtype);}
-#line 2238 "src/parser.cpp"
+#line 2297 "src/parser.cpp"
     break;
 
-  case 74: /* LAndExp: LAndExp AND RelExp  */
-#line 522 "src/parser.y"
+  case 78: /* LAndExp: LAndExp AND RelExp  */
+#line 562 "src/parser.y"
     {
         SymbolEntry *se = new TemporarySymbolEntry(TypeSystem::intType, SymbolTable::getLabel());
         (yyval.exprtype) = new BinaryExpr(se, BinaryExpr::AND, (yyvsp[-2].exprtype), (yyvsp[0].exprtype));
     }
-#line 2247 "src/parser.cpp"
+#line 2306 "src/parser.cpp"
     break;
 
-  case 75: /* LOrExp: LAndExp  */
-#line 529 "src/parser.y"
+  case 79: /* LOrExp: LAndExp  */
+#line 569 "src/parser.y"
             {(yyval.exprtype) = (yyvsp[0].exprtype);}
-#line 2253 "src/parser.cpp"
+#line 2312 "src/parser.cpp"
     break;
 
-  case 76: /* LOrExp: LOrExp OR LAndExp  */
-#line 532 "src/parser.y"
+  case 80: /* LOrExp: LOrExp OR LAndExp  */
+#line 572 "src/parser.y"
     {
         SymbolEntry *se = new TemporarySymbolEntry(TypeSystem::intType, SymbolTable::getLabel());
         (yyval.exprtype) = new BinaryExpr(se, BinaryExpr::OR, (yyvsp[-2].exprtype), (yyvsp[0].exprtype));
     }
-#line 2262 "src/parser.cpp"
+#line 2321 "src/parser.cpp"
     break;
 
-  case 77: /* Type: CONST INT  */
-#line 539 "src/parser.y"
+  case 81: /* Type: CONST INT  */
+#line 579 "src/parser.y"
               {
         (yyval.type)=TypeSystem::constintType;
+        declType = (yyval.type);
+        declConst = true;
+    }
+#line 2331 "src/parser.cpp"
+    break;
+
+  case 82: /* Type: CONST FLOAT  */
+#line 584 "src/parser.y"
+                  {
+        (yyval.type) = TypeSystem::floatType;
+        declType = (yyval.type);
+        declConst = true;
     }
-#line 2270 "src/parser.cpp"
+#line 2341 "src/parser.cpp"
     break;
 
-  case 78: /* Type: INT  */
-#line 542 "src/parser.y"
+  case 83: /* Type: INT  */
+#line 589 "src/parser.y"
           {
         (yyval.type) = TypeSystem::intType;
+        declType = (yyval.type);
+        declConst = false;
+    }
+#line 2351 "src/parser.cpp"
+    break;
+
+  case 84: /* Type: FLOAT  */
+#line 594 "src/parser.y"
+            {
+        (yyval.type) = TypeSystem::floatType;
+        declType = (yyval.type);
+        declConst = false;
     }
-#line 2278 "src/parser.cpp"
+#line 2361 "src/parser.cpp"
     break;
 
-  case 79: /* Type: VOID  */
-#line 545 "src/parser.y"
+  case 85: /* Type: VOID  */
+#line 599 "src/parser.y"
            {
         (yyval.type) = TypeSystem::voidType;
+        declType = (yyval.type);
+        declConst = false;
     }
-#line 2286 "src/parser.cpp"
+#line 2371 "src/parser.cpp"
     break;
 
-  case 80: /* ExprStmt: Exp SEMICOLON  */
-#line 552 "src/parser.y"
+  case 86: /* ExprStmt: Exp SEMICOLON  */
+#line 608 "src/parser.y"
                   {
     	(yyval.stmttype) = new ExprStmt((yyvsp[-1].exprtype));  
     }
-#line 2294 "src/parser.cpp"
+#line 2379 "src/parser.cpp"
     break;
 
-  case 81: /* BlankStmt: SEMICOLON  */
-#line 557 "src/parser.y"
+  case 87: /* BlankStmt: SEMICOLON  */
+#line 613 "src/parser.y"
               {
         (yyval.stmttype) = new BlankStmt();
     }
-#line 2302 "src/parser.cpp"
+#line 2387 "src/parser.cpp"
     break;
 
-  case 82: /* FuncExpr: ID LPAREN ParaIDList RPAREN  */
-#line 563 "src/parser.y"
+  case 88: /* FuncExpr: ID LPAREN ParaIDList RPAREN  */
+#line 619 "src/parser.y"
                                 {
         SymbolEntry *se;
         se = identifiers->lookup((yyvsp[-3].strtype));
@@ -2318,13 +2403,20 @@ yyreduce:
         std::queue<ExprNode*> idList = (yyvsp[-1].paraIdList)->getList();
         while(!idList.empty()){
             ExprNode *se0=idList.front();
-            Type *t=se0->getSymPtr()->getType();
+            Type *t=se0->getOperand()->getType();
+            if(t->isFunc())
+                t=((FunctionType*)t)->getRetType();
             newParamsType.emplace_back(t);
             idList.pop();
         }
-        int i=0;
-        while(i < paramsType.size()){
-            if(!((paramsType[i]==TypeSystem::constintType&&newParamsType[i]==TypeSystem::intType)||(paramsType[i]==TypeSystem::intType&&newParamsType[i]==TypeSystem::constintType)||paramsType[i]==newParamsType[i]))
+        if(paramsType.size() != newParamsType.size())
+        {
+            fprintf(stderr, "\"%s\" takes %d params but is called with %d\n", (char*)(yyvsp[-3].strtype), (int)paramsType.size(), (int)newParamsType.size());
+            assert(paramsType.size() == newParamsType.size());
+        }
+        size_t i=0;
+        while(i < paramsType.size() && i < newParamsType.size()){
+            if(!((paramsType[i]==TypeSystem::constintType&&newParamsType[i]==TypeSystem::intType)||(paramsType[i]==TypeSystem::intType&&newParamsType[i]==TypeSystem::constintType)||paramsType[i]==newParamsType[i]||(paramsType[i]->isPtr()&&newParamsType[i]->isPtr())||(paramsType[i]->isNumber()&&newParamsType[i]->isNumber())))
                 fprintf(stderr, "the params of \"%s\" is wrong\n", (char*)(yyvsp[-3].strtype));
             i++;
         }
@@ -2332,15 +2424,24 @@ yyreduce:
     	(yyval.exprtype) = new FuncExpr(se, (yyvsp[-1].paraIdList));
         //delete []$1;   
     }
-#line 2336 "src/parser.cpp"
+#line 2428 "src/parser.cpp"
     break;
 
-  case 83: /* $@3: %empty  */
-#line 596 "src/parser.y"
-                                   {
+  case 89: /* $@3: %empty  */
+#line 659 "src/parser.y"
+                   {
+        // parameters live in the function's own scope
+        identifiers = new SymbolTable(identifiers);
+    }
+#line 2437 "src/parser.cpp"
+    break;
+
+  case 90: /* $@4: %empty  */
+#line 663 "src/parser.y"
+                    {
         ifReturn=0;
-        funcionRetType=(yyvsp[-4].type);
-        funcName=(yyvsp[-3].strtype);
+        funcionRetType=(yyvsp[-5].type);
+        funcName=(yyvsp[-4].strtype);
         Type *funcType;
         std::vector<Type*> paramsType;
         std::queue<SymbolEntry*> idList = (yyvsp[-1].paraList)->getList();
@@ -2350,19 +2451,18 @@ yyreduce:
             paramsType.emplace_back(t);
             idList.pop();
         }
-        funcType = new FunctionType((yyvsp[-4].type),paramsType);
-        SymbolEntry *se = new IdentifierSymbolEntry(funcType, (yyvsp[-3].strtype), identifiers->getLevel());
-        identifiers->install((yyvsp[-3].strtype), se);
-        identifiers = new SymbolTable(identifiers);
+        funcType = new FunctionType((yyvsp[-5].type),paramsType);
+        SymbolEntry *se = new IdentifierSymbolEntry(funcType, (yyvsp[-4].strtype), identifiers->getPrev()->getLevel());
+        identifiers->getPrev()->install((yyvsp[-4].strtype), se);
     }
-#line 2359 "src/parser.cpp"
+#line 2459 "src/parser.cpp"
     break;
 
-  case 84: /* FuncDef: Type ID LPAREN ParaList RPAREN $@3 BlockStmt  */
-#line 615 "src/parser.y"
+  case 91: /* FuncDef: Type ID LPAREN $@3 ParaList RPAREN $@4 BlockStmt  */
+#line 681 "src/parser.y"
     {   
         SymbolEntry *se;
-        se = identifiers->lookup((yyvsp[-5].strtype));
+        se = identifiers->lookup((yyvsp[-6].strtype));
         (yyval.stmttype) = new FunctionDef(se, (yyvsp[-3].paraList), (yyvsp[0].stmttype));
         SymbolTable *top = identifiers;
         identifiers = identifiers->getPrev();
@@ -2372,21 +2472,21 @@ yyreduce:
             fprintf(stderr, "the function does not have a return\n");
         }
     }
-#line 2376 "src/parser.cpp"
+#line 2476 "src/parser.cpp"
     break;
 
-  case 85: /* DeclStmt: Type IDList SEMICOLON  */
-#line 631 "src/parser.y"
+  case 92: /* DeclStmt: Type IDList SEMICOLON  */
+#line 697 "src/parser.y"
                           {
         (yyvsp[-1].idlist)->setType((yyvsp[-2].type));
         (yyval.stmttype) = new DeclStmt((yyvsp[-1].idlist));
         //delete []$2;
     }
-#line 2386 "src/parser.cpp"
+#line 2486 "src/parser.cpp"
     break;
 
 
-#line 2390 "src/parser.cpp"
+#line 2490 "src/parser.cpp"
 
       default: break;
     }
@@ -2610,7 +2710,7 @@ yyreturnlab:
   return yyresult;
 }
 
-#line 637 "src/parser.y"
+#line 703 "src/parser.y"
 
 
 int yyerror(char const* message)
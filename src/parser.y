@@ -15,6 +15,54 @@
     int ifReturn=1;
     std::stack<StmtNode*> whileS;
     ArrayType* arrayType;
+    Type *declType;     // the type of the declaration being parsed
+    bool declConst;     // whether it is declared const
+
+    // array of int or float, as declared, with the constant dimensions listed
+    // in dims, innermost last
+    Type *arrayOf(ExprNode *dims)
+    {
+        std::vector<int> vec;
+        for (ExprNode *temp = dims; temp; temp = (ExprNode*)(temp->getNext()))
+        {
+            ConstantSymbolEntry *dim = temp->fold();
+            if(dim == nullptr)
+            {
+                fprintf(stderr, "array dimension is not a constant expression\n");
+                assert(dim != nullptr);
+            }
+            vec.push_back(dim->getType()->isFloat() ? (int)dim->getFloatValue() : dim->getValue());
+        }
+        Type *type = declType->isFloat() ? TypeSystem::floatType : TypeSystem::intType;
+        Type* temp1;
+        while(!vec.empty()){
+            temp1 = new ArrayType(type, vec.back());
+            if(type->isArray())
+                ((ArrayType*)type)->setArrayType(temp1);
+            type = temp1;
+            vec.pop_back();
+        }
+        return type;
+    }
+
+    // The initializer of a constant is folded and kept with it, for the
+    // constant expressions that name it later. A global's is emitted as data,
+    // so it is replaced with its value.
+    ExprNode *initOf(IdentifierSymbolEntry *se, ExprNode *init)
+    {
+        if(!declConst && !se->isGlobal())
+            return init;
+        ConstantSymbolEntry *value = init->fold();
+        if(value == nullptr)
+            return init;
+        if(declType->isFloat() && !value->getType()->isFloat())
+            value = new ConstantSymbolEntry(TypeSystem::floatType, (float)value->getValue());
+        else if(!declType->isFloat() && value->getType()->isFloat())
+            value = new ConstantSymbolEntry(TypeSystem::intType, (int)value->getFloatValue());
+        if(declConst)
+            se->setValue(value);
+        return se->isGlobal() ? new Constant(value) : init;
+    }
 }
 
 %code requires {
@@ -25,6 +73,7 @@
 
 %union {
     int itype;
+    float ftype;
     char* strtype;
     StmtNode* stmttype;
     ExprNode* exprtype;
@@ -33,13 +82,15 @@
     ParaList* paraList;
     InitIDList *initIdList;
     ParaIDList *paraIdList;
+    SymbolEntry *setype;
 }
 
 %start Program
 %token <strtype> ID 
 %token <itype> INTEGER HEXADECIMAL OCTAL
+%token <ftype> FLOATING
 %token IF ELSE WHILE 
-%token INT VOID CONST
+%token INT FLOAT VOID CONST
 %token LPAREN RPAREN LBRACE RBRACE SEMICOLON COMMA LBRACKET RBRACKET
 %token ADD SUB OR AND LESS ASSIGN LESSEQ MOREEQ NOTEQUAL EQUAL MORE NOT DIV MUL MOD
 %token RETURN BREAK CONTINUE
@@ -52,6 +103,7 @@
 %nterm <paraList> ParaList
 %nterm <initIdList> InitIDList
 %nterm <paraIdList> ParaIDList
+%nterm <setype> FuncParam
 
 %precedence THEN
 %precedence ELSE
@@ -105,24 +157,7 @@ IDList
         {
             fprintf(stderr, "identifier \"%s\" has already been defined\n", (char*)$1);
         }
-        std::vector<int> vec;
-        ExprNode* temp = $2;
-        while(temp){
-            ConstantSymbolEntry* len=(ConstantSymbolEntry*)temp->getSymPtr();
-            //std::cout<<len->getValue()<<std::endl;
-            vec.push_back(len->getValue());
-            temp = (ExprNode*)(temp->getNext());
-        }
-        Type *type = TypeSystem::intType;
-        Type* temp1;
-        while(!vec.empty()){
-            //std::cout<<vec.back()<<std::endl;
-            temp1 = new ArrayType(type, vec.back());
-            if(type->isArray())
-                ((ArrayType*)type)->setArrayType(temp1);
-            type = temp1;
-            vec.pop_back();
-        }
+        Type *type = arrayOf($2);
         arrayType = (ArrayType*)type;
         se = new IdentifierSymbolEntry(type, $1, identifiers->getLevel());
         ((IdentifierSymbolEntry*)se)->setArr();
@@ -156,23 +191,11 @@ IDList
         {
             fprintf(stderr, "identifier \"%s\" has already been defined\n", (char*)$1);
         }
-        std::vector<int> vec;
-        ExprNode* temp = $4;
-        while(temp){
-            vec.push_back(((ConstantSymbolEntry*)temp->getSymPtr())->getValue());
-            temp = (ExprNode*)(temp->getNext());
-        }
-        Type *type = TypeSystem::intType;
-        Type* temp1;
-        while(!vec.empty()){
-            temp1 = new ArrayType(type, vec.back());
-            if(type->isArray())
-                ((ArrayType*)type)->setArrayType(temp1);
-            type = temp1;
-            vec.pop_back();
-        }
+        Type *type = arrayOf($4);
         arrayType = (ArrayType*)type;
         se = new IdentifierSymbolEntry(type, $3, identifiers->getLevel());
+        ((IdentifierSymbolEntry*)se)->setArr();
+        ((IdentifierSymbolEntry*)se)->setArrLen(((ArrayType*)type)->getSize());
         identifiers->install($3, se);
         std::queue<SymbolEntry*> idl = $1->getList();
         idl.push(se);
@@ -181,27 +204,39 @@ IDList
     ;
 ParaList
     :
-    Type ID {
-        SymbolEntry *se = new IdentifierSymbolEntry($1, $2, identifiers->getLevel());
-        
-        identifiers->install($2, se);
+    FuncParam {
         std::queue<SymbolEntry*> idList;
-        idList.push(se);
+        idList.push($1);
         $$ = new ParaList(idList);
-        // delete []$2;
     }
     |
-    ParaList COMMA Type ID{
-        SymbolEntry *se = new IdentifierSymbolEntry($3, $4, identifiers->getLevel());
-        identifiers->install($4, se);
+    ParaList COMMA FuncParam {
         std::queue<SymbolEntry*> idList = $1->getList();
-        idList.push(se);
+        idList.push($3);
         $$ = new ParaList(idList);
-        // delete []$2;
     }
     | %empty {$$ = new ParaList();}
     ;
 
+FuncParam
+    :
+    Type ID {
+        $$ = new IdentifierSymbolEntry($1, $2, identifiers->getLevel());
+        identifiers->install($2, $$);
+        // delete []$2;
+    }
+    |
+    Type ID LBRACKET RBRACKET {
+        // int a[] is passed as a pointer to its first element
+        $$ = new IdentifierSymbolEntry(new PointerType(arrayOf(nullptr)), $2, identifiers->getLevel());
+        identifiers->install($2, $$);
+    }
+    |
+    Type ID LBRACKET RBRACKET Array {
+        $$ = new IdentifierSymbolEntry(new PointerType(arrayOf($5)), $2, identifiers->getLevel());
+        identifiers->install($2, $$);
+    }
+    ;
 
 ParaIDList
     :
@@ -235,7 +270,7 @@ InitIDList
         std::queue<SymbolEntry*> idList;
         std::queue<ExprNode*> nums;
         idList.push(se);
-        nums.push($3);
+        nums.push(initOf((IdentifierSymbolEntry*)se, $3));
         $$ = new InitIDList(idList, nums);
         delete $1;
     }
@@ -252,7 +287,7 @@ InitIDList
         std::queue<SymbolEntry*> *idList = $1->getList();
         std::queue<ExprNode*> *nums = $1->getNums();
         idList->push(se);
-        nums->push($5);
+        nums->push(initOf((IdentifierSymbolEntry*)se, $5));
         $$ = new InitIDList(*idList, *nums);
         delete $3;
     }
@@ -362,9 +397,10 @@ ReturnStmt
     :
     RETURN Exp SEMICOLON {
         ifReturn=1;
-        Type *retType=$2->getSymPtr()->getType();
+        Type *retType=$2->getOperand()->getType();
         if(retType->isFunc()){
-            if(((FunctionType*)retType)->getRetType()!=funcionRetType)
+            Type *callType=((FunctionType*)retType)->getRetType();
+            if(callType!=funcionRetType && !(callType->isNumber() && funcionRetType->isNumber()))
                 fprintf(stderr, "the return_type of \"%s\" is wrong\n", funcName.c_str());
         }
         else if(retType==TypeSystem::constintType){
@@ -372,7 +408,7 @@ ReturnStmt
                 fprintf(stderr, "the return_type of \"%s\" is wrong\n", funcName.c_str());
             }
         }
-        else if(retType!=funcionRetType){
+        else if(retType!=funcionRetType && !(retType->isNumber() && funcionRetType->isNumber())){
             fprintf(stderr, "the return_type of \"%s\" is wrong\n", funcName.c_str());
         }
         $$ = new ReturnStmt($2);
@@ -412,6 +448,10 @@ PrimaryExp
         SymbolEntry *se = new ConstantSymbolEntry(TypeSystem::intType, $1);
         $$ = new Constant(se);
     }
+    | FLOATING {
+        SymbolEntry *se = new ConstantSymbolEntry(TypeSystem::floatType, $1);
+        $$ = new Constant(se);
+    }
     | FuncExpr {
     	$$=$1;
     }
@@ -538,12 +578,28 @@ Type
     : 
     CONST INT {
         $$=TypeSystem::constintType;
+        declType = $$;
+        declConst = true;
     } 
+    | CONST FLOAT {
+        $$ = TypeSystem::floatType;
+        declType = $$;
+        declConst = true;
+    }
     | INT {
         $$ = TypeSystem::intType;
+        declType = $$;
+        declConst = false;
+    }
+    | FLOAT {
+        $$ = TypeSystem::floatType;
+        declType = $$;
+        declConst = false;
     }
     | VOID {
         $$ = TypeSystem::voidType;
+        declType = $$;
+        declConst = false;
     }
     ;
 
@@ -575,13 +631,20 @@ FuncExpr
         std::queue<ExprNode*> idList = $3->getList();
         while(!idList.empty()){
             ExprNode *se0=idList.front();
-            Type *t=se0->getSymPtr()->getType();
+            Type *t=se0->getOperand()->getType();
+            if(t->isFunc())
+                t=((FunctionType*)t)->getRetType();
             newParamsType.emplace_back(t);
             idList.pop();
         }
-        int i=0;
-        while(i < paramsType.size()){
-            if(!((paramsType[i]==TypeSystem::constintType&&newParamsType[i]==TypeSystem::intType)||(paramsType[i]==TypeSystem::intType&&newParamsType[i]==TypeSystem::constintType)||paramsType[i]==newParamsType[i]))
+        if(paramsType.size() != newParamsType.size())
+        {
+            fprintf(stderr, "\"%s\" takes %d params but is called with %d\n", (char*)$1, (int)paramsType.size(), (int)newParamsType.size());
+            assert(paramsType.size() == newParamsType.size());
+        }
+        size_t i=0;
+        while(i < paramsType.size() && i < newParamsType.size()){
+            if(!((paramsType[i]==TypeSystem::constintType&&newParamsType[i]==TypeSystem::intType)||(paramsType[i]==TypeSystem::intType&&newParamsType[i]==TypeSystem::constintType)||paramsType[i]==newParamsType[i]||(paramsType[i]->isPtr()&&newParamsType[i]->isPtr())||(paramsType[i]->isNumber()&&newParamsType[i]->isNumber())))
                 fprintf(stderr, "the params of \"%s\" is wrong\n", (char*)$1);
             i++;
         }
@@ -593,13 +656,17 @@ FuncExpr
     
 FuncDef
     :
-    Type ID LPAREN ParaList RPAREN {
+    Type ID LPAREN {
+        // parameters live in the function's own scope
+        identifiers = new SymbolTable(identifiers);
+    }
+    ParaList RPAREN {
         ifReturn=0;
         funcionRetType=$1;
         funcName=$2;
         Type *funcType;
         std::vector<Type*> paramsType;
-        std::queue<SymbolEntry*> idList = $4->getList();
+        std::queue<SymbolEntry*> idList = $5->getList();
         while(!idList.empty()){
             SymbolEntry *se0=idList.front();
             Type *t=se0->getType();
@@ -607,15 +674,14 @@ FuncDef
             idList.pop();
         }
         funcType = new FunctionType($1,paramsType);
-        SymbolEntry *se = new IdentifierSymbolEntry(funcType, $2, identifiers->getLevel());
-        identifiers->install($2, se);
-        identifiers = new SymbolTable(identifiers);
+        SymbolEntry *se = new IdentifierSymbolEntry(funcType, $2, identifiers->getPrev()->getLevel());
+        identifiers->getPrev()->install($2, se);
     }
     BlockStmt
     {   
         SymbolEntry *se;
         se = identifiers->lookup($2);
-        $$ = new FunctionDef(se, $4, $7);
+        $$ = new FunctionDef(se, $5, $8);
         SymbolTable *top = identifiers;
         identifiers = identifiers->getPrev();
         delete top;
@@ -2,66 +2,147 @@
 #include <stdarg.h>
 #include <stdio.h>
 #include <sys/time.h>
+#include <ctype.h>
+#include <stdlib.h>
+#include <unistd.h>
 /* Input & output functions */
+/* Input is read with read(2) into a static buffer and parsed by hand, output
+ * is collected in a static buffer written with write(2) when full, before
+ * stdio is used, and at exit from after_main. */
+#define _SYSY_BUF 65536
+static char _sysy_in[_SYSY_BUF], _sysy_out[_SYSY_BUF];
+static int _sysy_in_pos, _sysy_in_len, _sysy_out_len;
+
+static int _sysy_peek() {
+    if (_sysy_in_pos == _sysy_in_len) {
+        _sysy_in_pos = 0;
+        _sysy_in_len = read(0, _sysy_in, _SYSY_BUF);
+        if (_sysy_in_len <= 0) {
+            _sysy_in_len = 0;
+            return EOF;
+        }
+    }
+    return (unsigned char)_sysy_in[_sysy_in_pos];
+}
+static int _sysy_next() {
+    int c = _sysy_peek();
+    if (c != EOF)
+        _sysy_in_pos++;
+    return c;
+}
+static void _sysy_skip_space() {
+    while (isspace(_sysy_peek()))
+        _sysy_in_pos++;
+}
+static void _sysy_flush() {
+    int done = 0;
+    while (done < _sysy_out_len) {
+        int n = write(1, _sysy_out + done, _sysy_out_len - done);
+        if (n <= 0)
+            break;
+        done += n;
+    }
+    _sysy_out_len = 0;
+}
+static void _sysy_put(char c) {
+    if (_sysy_out_len == _SYSY_BUF)
+        _sysy_flush();
+    _sysy_out[_sysy_out_len++] = c;
+}
+static void _sysy_put_int(int a) {
+    char digits[12];
+    int n = 0;
+    unsigned v = a;
+    if (a < 0) {
+        _sysy_put('-');
+        v = -v;
+    }
+    do {
+        digits[n++] = '0' + v % 10;
+        v /= 10;
+    } while (v);
+    while (n)
+        _sysy_put(digits[--n]);
+}
+
 int getint() {
-    int t;
-    scanf("%d", &t);
-    return t;
+    int c, neg = 0;
+    unsigned v = 0;
+    _sysy_skip_space();
+    c = _sysy_peek();
+    if (c == '-' || c == '+') {
+        neg = c == '-';
+        _sysy_in_pos++;
+    }
+    while (isdigit(c = _sysy_peek())) {
+        v = v * 10 + (c - '0');
+        _sysy_in_pos++;
+    }
+    return neg ? -v : v;
 }
 int getch() {
-    char c;
-    scanf("%c", &c);
-    return (int)c;
+    return _sysy_next();
 }
 float getfloat() {
-    float n;
-    scanf("%a", &n);
-    return n;
+    char token[64];
+    int n = 0;
+    _sysy_skip_space();
+    while (n < 63 && _sysy_peek() != EOF && !isspace(_sysy_peek()))
+        token[n++] = _sysy_next();
+    token[n] = 0;
+    return strtof(token, NULL);
 }
 
 int getarray(int a[]) {
-    int n;
-    scanf("%d", &n);
+    int n = getint();
     for (int i = 0; i < n; i++)
-        scanf("%d", &a[i]);
+        a[i] = getint();
     return n;
 }
 
 int getfarray(float a[]) {
-    int n;
-    scanf("%d", &n);
+    int n = getint();
     for (int i = 0; i < n; i++) {
-        scanf("%a", &a[i]);
+        a[i] = getfloat();
     }
     return n;
 }
 void putint(int a) {
-    printf("%d", a);
+    _sysy_put_int(a);
 }
 void putch(int a) {
-    printf("%c", a);
+    _sysy_put(a);
 }
 void putarray(int n, int a[]) {
-    printf("%d:", n);
-    for (int i = 0; i < n; i++)
-        printf(" %d", a[i]);
-    printf("\n");
+    _sysy_put_int(n);
+    _sysy_put(':');
+    for (int i = 0; i < n; i++) {
+        _sysy_put(' ');
+        _sysy_put_int(a[i]);
+    }
+    _sysy_put('\n');
 }
 void putfloat(float a) {
+    _sysy_flush();
     printf("%a", a);
+    fflush(stdout);
 }
 void putfarray(int n, float a[]) {
+    _sysy_flush();
     printf("%d:", n);
     for (int i = 0; i < n; i++) {
         printf(" %a", a[i]);
     }
     printf("\n");
+    fflush(stdout);
 }
 
 void putf(char a[], ...) {
     va_list args;
     va_start(args, a);
+    _sysy_flush();
     vfprintf(stdout, a, args);
+    fflush(stdout);
     va_end(args);
 }
 
@@ -72,6 +153,7 @@ __attribute((constructor)) void before_main() {
     _sysy_idx = 1;
 }
 __attribute((destructor)) void after_main() {
+    _sysy_flush();
     for (int i = 1; i < _sysy_idx; i++) {
         fprintf(stderr, "Timer@%04d-%04d: %dH-%dM-%dS-%dus\n", _sysy_l1[i],
                 _sysy_l2[i], _sysy_h[i], _sysy_m[i], _sysy_s[i], _sysy_us[i]);